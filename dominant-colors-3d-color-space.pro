@@ -24,6 +24,11 @@ SOURCES +=  main.cpp\
             mainwindow.cpp \
             openglwidget.cpp \
             opengl-draw.cpp \
+            opengl-spheres.cpp \
+            opengl-color-spaces.cpp \
+            opengl-points.cpp \
+            opengl-renderer.cpp \
+            opengl-offscreen.cpp \
             widgets/file-dialog.cpp \
             lib/dominant-colors.cpp \
             lib/color-spaces.cpp \
@@ -31,11 +36,17 @@ SOURCES +=  main.cpp\
             lib/image-transform.cpp \
             lib/image-color.cpp \
             lib/image-lut.cpp \
-            lib/image-utils.cpp
+            lib/image-utils.cpp \
+            lib/color-histogram.cpp
 
 HEADERS  += mainwindow.h \
             openglwidget.h \
             opengl-draw.h \
+            opengl-spheres.h \
+            opengl-color-spaces.h \
+            opengl-points.h \
+            opengl-renderer.h \
+            opengl-offscreen.h \
             palette.h \
             widgets/file-dialog.h \
             lib/dominant-colors.h \
@@ -45,6 +56,7 @@ HEADERS  += mainwindow.h \
             lib/image-color.h \
             lib/image-utils.h \
             lib/image-lut.h \
+            lib/color-histogram.h \
             lib/randomizer.h
 
 FORMS    += mainwindow.ui
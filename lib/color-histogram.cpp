@@ -0,0 +1,101 @@
+/*#-------------------------------------------------
+#
+#        3D color histogram library
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1.0 - 2026/10/18
+#
+#   - Sparse voxel histogram of weighted 3D values
+#       * any color space : values are positions
+#       * count, mean position and mean color
+#         of each non-empty voxel
+#       * built in parallel, per-thread histograms
+#         merged at the end
+#
+#-------------------------------------------------*/
+
+#include <unordered_map>
+#include <algorithm>
+#include <cfloat>
+
+#include "color-histogram.h"
+
+
+///////////////////////////////////////////////////////////
+//// Voxel histogram
+///////////////////////////////////////////////////////////
+
+struct struct_voxel_sum { // weighted sums of one voxel
+    double x = 0, y = 0, z = 0;
+    double R = 0, G = 0, B = 0;
+    long long count = 0;
+};
+
+void VoxelHistogram(const std::vector<float> &positions, const std::vector<float> &colors, const std::vector<int> &weights,
+                    const int &bins, std::vector<struct_voxel> &voxels) // sparse histogram of weighted values in bins^3 voxels over their bounding box
+{
+    voxels.clear();
+    const int nb = weights.size();
+    if ((nb == 0) or (bins < 1))
+        return;
+
+    // bounding box of all values
+    float minimum[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float maximum[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (int n = 0; n < nb; n++)
+        for (int c = 0; c < 3; c++) {
+            minimum[c] = std::min(minimum[c], positions[3 * n + c]);
+            maximum[c] = std::max(maximum[c], positions[3 * n + c]);
+        }
+    float scale[3]; // position to voxel coordinate
+    for (int c = 0; c < 3; c++)
+        scale[c] = (maximum[c] > minimum[c]) ? bins / (maximum[c] - minimum[c]) : 0;
+
+    std::unordered_map<int, struct_voxel_sum> histogram; // non-empty voxels only
+
+    #pragma omp parallel
+    {
+        std::unordered_map<int, struct_voxel_sum> local; // this thread's histogram
+
+        #pragma omp for nowait
+        for (int n = 0; n < nb; n++) {
+            int index = 0; // voxel index = x + y * bins + z * bins^2
+            for (int c = 2; c >= 0; c--)
+                index = index * bins + std::min(int((positions[3 * n + c] - minimum[c]) * scale[c]), bins - 1);
+
+            struct_voxel_sum &voxel = local[index];
+            const double weight = weights[n];
+            voxel.x += positions[3 * n] * weight;
+            voxel.y += positions[3 * n + 1] * weight;
+            voxel.z += positions[3 * n + 2] * weight;
+            voxel.R += colors[3 * n] * weight;
+            voxel.G += colors[3 * n + 1] * weight;
+            voxel.B += colors[3 * n + 2] * weight;
+            voxel.count += weights[n];
+        }
+
+        #pragma omp critical
+        for (const auto &value : local) { // merge this thread's histogram
+            struct_voxel_sum &voxel = histogram[value.first];
+            voxel.x += value.second.x;
+            voxel.y += value.second.y;
+            voxel.z += value.second.z;
+            voxel.R += value.second.R;
+            voxel.G += value.second.G;
+            voxel.B += value.second.B;
+            voxel.count += value.second.count;
+        }
+    }
+
+    voxels.reserve(histogram.size());
+    for (const auto &value : histogram) { // weighted means
+        const struct_voxel_sum &voxel = value.second;
+        if (voxel.count == 0)
+            continue;
+        const double count = voxel.count;
+        voxels.push_back({float(voxel.x / count), float(voxel.y / count), float(voxel.z / count),
+                          float(voxel.R / count), float(voxel.G / count), float(voxel.B / count),
+                          voxel.count});
+    }
+}
@@ -0,0 +1,34 @@
+/*#-------------------------------------------------
+#
+#        3D color histogram library
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1.0 - 2026/10/18
+#
+#   - Sparse voxel histogram of weighted 3D values
+#       * any color space : values are positions
+#       * count, mean position and mean color
+#         of each non-empty voxel
+#       * built in parallel, per-thread histograms
+#         merged at the end
+#
+#-------------------------------------------------*/
+
+#ifndef COLORHISTOGRAM_H
+#define COLORHISTOGRAM_H
+
+#include <vector>
+
+
+struct struct_voxel {
+    float x, y, z; // weighted mean position of values in voxel
+    float R, G, B; // weighted mean color of values in voxel - range [0..1]
+    long long count; // sum of weights in voxel
+};
+
+void VoxelHistogram(const std::vector<float> &positions, const std::vector<float> &colors, const std::vector<int> &weights,
+                    const int &bins, std::vector<struct_voxel> &voxels); // sparse histogram of weighted values in bins^3 voxels over their bounding box - positions and colors are (x,y,z) and (R,G,B) for each value
+
+
+#endif // COLORHISTOGRAM_H
@@ -28,7 +28,8 @@
 
 #include "color-spaces.h"
 
-std::vector<double> RGBlinearLUT = InitRGBLinearLUT(); // initialize the linear RGB LUT at startup
+const std::vector<double> RGBlinearLUT = InitRGBLinearLUT(); // initialize the linear RGB LUT at startup
+const std::vector<std::string> HexaLUT = InitHexaLUT(); // initialize the byte to hexadecimal LUT at startup
 
 
 ///////////////////////////////////////////////////////////
@@ -50,6 +51,16 @@ std::vector<double> InitRGBLinearLUT() // populate RGB linear LUT - it is called
     return array;
 }
 
+std::vector<std::string> InitHexaLUT() // populate byte to hexadecimal LUT - it is called at startup
+{
+    const char digits[] = "0123456789ABCDEF";
+    std::vector<std::string> array;
+    for (int n = 0; n < 256; n++)
+        array.push_back(std::string({digits[n >> 4], digits[n & 0x0f]}));
+
+    return array;
+}
+
 double GetValueRangeZeroOne(const double &val)
 {
     if (val < 0.0)
@@ -566,6 +577,198 @@ double DistanceRGBOKLAB(const int &R1, const int &G1, const int &B1,
     return DistanceCIEDE76(L1, a1, b1, L2, a2, b2); // OKLAB distance
 }
 
+///////////////////////////////////////////////////////////
+//// Batch color distance
+///////////////////////////////////////////////////////////
+// the 2-color functions recompute everything for both colors at each call, here the per-color terms are computed only once
+// rows and matrices are computed in parallel with OpenMP, the inner loops only use plain doubles so the compiler can vectorize them
+
+struct_distance_terms DistanceTerms(const double &L, const double &A, const double &B) // pre-compute terms of one CIELab or OKLAB color
+{
+    struct_distance_terms terms;
+    terms.L = L * 100.0; // L, a and b must be in [0..100]
+    terms.a = A * 100.0;
+    terms.b = B * 100.0;
+    terms.C = sqrt(terms.a * terms.a + terms.b * terms.b); // chroma
+    return terms;
+}
+
+std::vector<struct_distance_terms> DistanceTerms(const std::vector<double> &L, const std::vector<double> &A, const std::vector<double> &B) // pre-compute terms of a whole palette - vectors must have the same size
+{
+    std::vector<struct_distance_terms> terms(L.size());
+    for (size_t n = 0; n < L.size(); n++)
+        terms[n] = DistanceTerms(L[n], A[n], B[n]);
+    return terms;
+}
+
+double DistanceCIEDE2000Terms(const struct_distance_terms &c1, const struct_distance_terms &c2,
+                              const double &k_L, const double &k_C, const double &k_H) // CIEDE2000 between 2 pre-computed colors - same result as DistanceCIEDE2000
+{
+    // same steps as DistanceCIEDE2000, see this function for details - only the pair-dependent part is computed here
+
+    // equation 3 : chromas mean - pow(x, 7) replaced by multiplications
+    double barC = (c1.C + c2.C) / 2.0;
+    double barC_2 = barC * barC;
+    double pow_barC_7 = barC_2 * barC_2 * barC_2 * barC;
+    // equation 4 : G
+    double G = 0.5 * (1.0 - sqrt(pow_barC_7 / (pow_barC_7 + pow_25_7)));
+    // equation 5 : a
+    double a1Prime = (1.0 + G) * c1.a;
+    double a2Prime = (1.0 + G) * c2.a;
+    // equation 6 : C' from LCH
+    double CPrime1 = sqrt((a1Prime * a1Prime) + (c1.b * c1.b));
+    double CPrime2 = sqrt((a2Prime * a2Prime) + (c2.b * c2.b));
+    // equation 7 : H' from LCH
+    double hPrime1 = 0.0;
+    if ((c1.b != 0.0) or (a1Prime != 0.0)) {
+        hPrime1 = atan2(c1.b, a1Prime);
+        if (hPrime1 < 0.0)
+            hPrime1 += pi_rad; // add 2 * Pi radians
+        hPrime1 *= pi_deg; // convert to degrees
+    }
+    double hPrime2 = 0.0;
+    if ((c2.b != 0.0) or (a2Prime != 0.0)) {
+        hPrime2 = atan2(c2.b, a2Prime);
+        if (hPrime2 < 0.0)
+            hPrime2 += pi_rad; // add 2 * Pi radians
+        hPrime2 *= pi_deg; // convert to degrees
+    }
+
+    // equations 8 to 11 : deltas
+    double deltaLPrime = c2.L - c1.L;
+    double deltaCPrime = CPrime2 - CPrime1;
+    double CPrimeProduct = CPrime1 * CPrime2;
+    double deltahPrime = 0.0;
+    if (CPrimeProduct != 0.0) {
+        deltahPrime = hPrime2 - hPrime1;
+        if (deltahPrime < -180.0)
+            deltahPrime += 360.0;
+        else if (deltahPrime > 180.0)
+            deltahPrime -= 360.0;
+    }
+    double deltaHPrime = 2.0 * sqrt(CPrimeProduct) * sin(DegToRad(deltahPrime) / 2.0);
+
+    // equations 12 to 14 : means
+    double barLPrime = (c1.L + c2.L) / 2.0;
+    double barCPrime = (CPrime1 + CPrime2) / 2.0;
+    double barhPrime, hPrimeSum = hPrime1 + hPrime2;
+    if (CPrimeProduct == 0.0)
+        barhPrime = hPrimeSum;
+    else if (abs(hPrime1 - hPrime2) <= 180.0)
+        barhPrime = hPrimeSum / 2.0;
+    else if (hPrimeSum < 360.0)
+        barhPrime = (hPrimeSum + 360.0) / 2.0;
+    else
+        barhPrime = (hPrimeSum - 360.0) / 2.0;
+
+    // equations 15 to 21 : weights
+    double barhPrimeRad = DegToRad(barhPrime);
+    double T = 1.0 - (0.17 * cos(barhPrimeRad - deg2rad_30))
+                       + (0.24 * cos(2.0 * barhPrimeRad))
+                       + (0.32 * cos((3.0 * barhPrimeRad) + deg2rad_6))
+                       - (0.20 * cos((4.0 * barhPrimeRad) - deg2rad_63));
+    double deltaThetaRatio = (barhPrimeRad - deg2rad_275) / deg2rad_25;
+    double deltaTheta = deg2rad_30 * exp(-deltaThetaRatio * deltaThetaRatio);
+    double barCPrime_2 = barCPrime * barCPrime;
+    double pow_barCPrime_7 = barCPrime_2 * barCPrime_2 * barCPrime_2 * barCPrime;
+    double R_C = 2.0 * sqrt(pow_barCPrime_7 / (pow_barCPrime_7 + pow_25_7));
+    double S_L = 1.0 + 0.015 * (barLPrime - 50.0) * (barLPrime - 50.0) / sqrt(20.0 + (barLPrime - 50.0) * (barLPrime - 50.0));
+    double S_C = 1.0 + 0.045 * barCPrime;
+    double S_H = 1.0 + 0.015 * barCPrime * T;
+    double R_T = -sin(2.0 * deltaTheta) * R_C;
+
+    // equation 22 : delta E (distance)
+    double dL = deltaLPrime / (k_L * S_L);
+    double dC = deltaCPrime / (k_C * S_C);
+    double dH = deltaHPrime / (k_H * S_H);
+    return sqrt(dL * dL + dC * dC + dH * dH + R_T * dC * dH);
+}
+
+double DistanceCIEDE94Terms(const struct_distance_terms &c1, const struct_distance_terms &c2,
+                            const double &kL, const double &kC, const double &kH) // CIEDE94 between 2 pre-computed colors - same result as DistanceCIEDE94 (not symmetric : c1 is the reference)
+{
+    double da = c1.a - c2.a;
+    double db = c1.b - c2.b;
+    double dL = (c1.L - c2.L) / kL; // SL = 1
+    double dC = c1.C - c2.C;
+    double dH = sqrt(std::max(0.0, da * da + db * db - dC * dC)); // rounding errors can make this slightly negative
+    dC /= kC * (1.0 + 0.045 * c1.C); // SC with k1 = 0.045 (graphic arts)
+    dH /= kH * (1.0 + 0.015 * c1.C); // SH with k2 = 0.015
+    return sqrt(dL * dL + dC * dC + dH * dH);
+}
+
+double DistanceCIEDE76Terms(const struct_distance_terms &c1, const struct_distance_terms &c2) // CIEDE76 between 2 pre-computed colors - also the OKLAB distance when terms come from OKLAB values
+{
+    return EuclideanDistanceSpace(c1.L, c1.a, c1.b, c2.L, c2.a, c2.b);
+}
+
+void DistanceCIEDE2000Row(const struct_distance_terms &reference, const std::vector<struct_distance_terms> &palette, std::vector<double> &row,
+                          const double &k_L, const double &k_C, const double &k_H) // CIEDE2000 distances from one color to all palette colors
+{
+    const int nb = palette.size();
+    row.resize(nb);
+    #pragma omp parallel for
+    for (int n = 0; n < nb; n++)
+        row[n] = DistanceCIEDE2000Terms(reference, palette[n], k_L, k_C, k_H);
+}
+
+void DistanceCIEDE94Row(const struct_distance_terms &reference, const std::vector<struct_distance_terms> &palette, std::vector<double> &row,
+                        const double &kL, const double &kC, const double &kH) // CIEDE94 distances from one color to all palette colors
+{
+    const int nb = palette.size();
+    row.resize(nb);
+    #pragma omp parallel for
+    for (int n = 0; n < nb; n++)
+        row[n] = DistanceCIEDE94Terms(reference, palette[n], kL, kC, kH);
+}
+
+void DistanceOKLABRow(const struct_distance_terms &reference, const std::vector<struct_distance_terms> &palette, std::vector<double> &row) // OKLAB (euclidean) distances from one color to all palette colors
+{
+    const int nb = palette.size();
+    row.resize(nb);
+    #pragma omp parallel for
+    for (int n = 0; n < nb; n++)
+        row[n] = DistanceCIEDE76Terms(reference, palette[n]);
+}
+
+void DistanceCIEDE2000Matrix(const std::vector<struct_distance_terms> &palette, std::vector<double> &matrix,
+                             const double &k_L, const double &k_C, const double &k_H) // N x N CIEDE2000 distances, row-major - symmetric so only half is computed
+{
+    const int nb = palette.size();
+    matrix.assign(nb * nb, 0.0); // diagonal stays at 0
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < nb; i++)
+        for (int j = i + 1; j < nb; j++) {
+            double d = DistanceCIEDE2000Terms(palette[i], palette[j], k_L, k_C, k_H);
+            matrix[i * nb + j] = d;
+            matrix[j * nb + i] = d;
+        }
+}
+
+void DistanceCIEDE94Matrix(const std::vector<struct_distance_terms> &palette, std::vector<double> &matrix,
+                           const double &kL, const double &kC, const double &kH) // N x N CIEDE94 distances, row-major - row is the reference color
+{
+    const int nb = palette.size();
+    matrix.resize(nb * nb);
+    #pragma omp parallel for
+    for (int i = 0; i < nb; i++)
+        for (int j = 0; j < nb; j++)
+            matrix[i * nb + j] = DistanceCIEDE94Terms(palette[i], palette[j], kL, kC, kH);
+}
+
+void DistanceOKLABMatrix(const std::vector<struct_distance_terms> &palette, std::vector<double> &matrix) // N x N OKLAB (euclidean) distances, row-major - symmetric so only half is computed
+{
+    const int nb = palette.size();
+    matrix.assign(nb * nb, 0.0); // diagonal stays at 0
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < nb; i++)
+        for (int j = i + 1; j < nb; j++) {
+            double d = DistanceCIEDE76Terms(palette[i], palette[j]);
+            matrix[i * nb + j] = d;
+            matrix[j * nb + i] = d;
+        }
+}
+
 ///////////////////////////////////////////////////////////
 //// Color utils
 ///////////////////////////////////////////////////////////
@@ -578,6 +781,16 @@ void RGBtoStandard(const double &r, const double &g, const double &b, int &R, in
     B = round(b * 255.0);
 }
 
+std::string RGBtoHexa(const int &R, const int &G, const int &B) // convert RGB [0..255] to "#RRGGBB" string using the hexadecimal LUT
+{
+    std::string hexa = "#";
+    hexa.reserve(7);
+    hexa += HexaLUT[R & 0xff];
+    hexa += HexaLUT[G & 0xff];
+    hexa += HexaLUT[B & 0xff];
+    return hexa;
+}
+
 void RGBMean(const double &R1, const double &G1, const double &B1, const double W1,
              const double &R2, const double &G2, const double &B2, const double W2,
              double &R, double &G, double &B) // mean RGB value of 2 RGB values with transition to linear RGB
@@ -1381,11 +1594,7 @@ void RGBtoXYZ(const double &R, const double &G, const double &B, double &X, doub
     double r, g, b;
 
     RGBtoLinear(R, G, B, r, g, b); // gamma correction to linear sRGB
-
-    // Gammut conversion to sRGB - source http://www.brucelindbloom.com/index.html?Eqn_RGB_XYZ_Matrix.html
-    X = r * 0.4124564 + g * 0.3575761 + b * 0.1804375;
-    Y = r * 0.2126729 + g * 0.7151522 + b * 0.0721750;
-    Z = r * 0.0193339 + g * 0.1191920 + b * 0.9503041;
+    LinearRGBtoXYZ(r, g, b, X, Y, Z); // then to XYZ
 }
 
 void RGBtoXYZ(const int &R, const int &G, const int &B, double &X, double &Y, double &Z) // convert RGB (in fact sRGB) value to CIE XYZ - RGB is 8-bit !
@@ -1400,6 +1609,14 @@ void RGBtoXYZ(const int &R, const int &G, const int &B, double &X, double &Y, do
     Z = r * 0.0193339 + g * 0.1191920 + b * 0.9503041;
 }
 
+void LinearRGBtoXYZ(const double &r, const double &g, const double &b, double &X, double &Y, double &Z) // convert linear RGB value to CIE XYZ - use it when linear RGB is already known
+{
+    // Gammut conversion to sRGB - source http://www.brucelindbloom.com/index.html?Eqn_RGB_XYZ_Matrix.html
+    X = r * 0.4124564 + g * 0.3575761 + b * 0.1804375;
+    Y = r * 0.2126729 + g * 0.7151522 + b * 0.0721750;
+    Z = r * 0.0193339 + g * 0.1191920 + b * 0.9503041;
+}
+
 void XYZtoRGB(const double &X, const double &Y, const double &Z, double &R, double &G, double &B) // convert from XYZ to RGB (in fact sRGB)
 { // function checked OK with other calculators
     // Gammut conversion - source http://www.brucelindbloom.com/index.html?Eqn_RGB_XYZ_Matrix.html
@@ -2014,7 +2231,11 @@ void RGBtoOKLAB(const double &R, const double &G, const double &B, double &L, do
     double Rl, Gl, Bl; // for linear values of RGB
 
     RGBtoLinear(R, G, B, Rl, Gl, Bl); // gamma correction to linear sRGB
+    LinearRGBtoOKLAB(Rl, Gl, Bl, L, a, b); // then to OKLAB
+}
 
+void LinearRGBtoOKLAB(const double &Rl, const double &Gl, const double &Bl, double &L, double &a, double &b) // convert linear RGB to OKLAB - use it when linear RGB is already known
+{
     // convert RGB to linear LMS - this matrix comes from : XYZ = M0 x RGB and LMS = M1 * XYZ, so M = M1 x M0
     double l = 0.4122214708 * Rl + 0.5363325363 * Gl + 0.0514459929 * Bl;
     double m = 0.2119034982 * Rl + 0.6806995451 * Gl + 0.1073969566 * Bl;
@@ -30,15 +30,18 @@
 #define COLORSPACES_H
 
 #include <vector>
+#include <string>
 #include <float.h>
 #include <math.h>
 
 #include "angles.h"
 
 //// General
-extern std::vector<double> RGBlinearLUT; // this external variable is initialized by InitRGBLinearLUT() in color-spaces.cpp - it is used by any color space conversion or function using linear RGB (CIELab, OKLab, etc)
+extern const std::vector<double> RGBlinearLUT; // this external variable is initialized by InitRGBLinearLUT() in color-spaces.cpp - it is used by any color space conversion or function using linear RGB (CIELab, OKLab, etc)
 
 std::vector<double> InitRGBLinearLUT(); // populate RGB linear LUT - it is called at startup to populate the linear RGB LUT used by any conversion function using RGB to linear RGB (CIELab, OKLab, etc)
+extern const std::vector<std::string> HexaLUT; // this external variable is initialized by InitHexaLUT() in color-spaces.cpp - byte to 2-digit uppercase hexadecimal string
+std::vector<std::string> InitHexaLUT(); // populate byte to hexadecimal LUT - it is called at startup
 double GetValueRangeZeroOne(const double &val);
 
 //// Color distance
@@ -93,9 +96,37 @@ double DistanceRGBOKLAB(const double &R1, const double &G1, const double &B1,
 double DistanceRGBOKLAB(const int &R1, const int &G1, const int &B1,
                         const int &R2, const int &G2, const int &B2); // OKLAB distance between 2 RGB values - RGB is 8-bit !
 
+//// Batch color distance
+// per-color terms are computed once per palette, then one-to-many (row) or many-to-many (matrix) distances are computed in parallel
+// works for CIELab and OKLAB values in [0..1] (same ranges as the 2-color functions)
+
+struct struct_distance_terms { // pre-computed terms of one color for batch distances
+    double L, a, b; // L, a and b in [0..100]
+    double C; // chroma = distance from gray axis
+};
+
+struct_distance_terms DistanceTerms(const double &L, const double &A, const double &B); // pre-compute terms of one CIELab or OKLAB color
+std::vector<struct_distance_terms> DistanceTerms(const std::vector<double> &L, const std::vector<double> &A, const std::vector<double> &B); // pre-compute terms of a whole palette - vectors must have the same size
+double DistanceCIEDE2000Terms(const struct_distance_terms &c1, const struct_distance_terms &c2,
+                              const double &k_L, const double &k_C, const double &k_H); // CIEDE2000 between 2 pre-computed colors - same result as DistanceCIEDE2000
+double DistanceCIEDE94Terms(const struct_distance_terms &c1, const struct_distance_terms &c2,
+                            const double &kL, const double &kC, const double &kH); // CIEDE94 between 2 pre-computed colors - same result as DistanceCIEDE94 (not symmetric : c1 is the reference)
+double DistanceCIEDE76Terms(const struct_distance_terms &c1, const struct_distance_terms &c2); // CIEDE76 between 2 pre-computed colors - also the OKLAB distance when terms come from OKLAB values
+void DistanceCIEDE2000Row(const struct_distance_terms &reference, const std::vector<struct_distance_terms> &palette, std::vector<double> &row,
+                          const double &k_L=1.0, const double &k_C=1.0, const double &k_H=1.0); // CIEDE2000 distances from one color to all palette colors
+void DistanceCIEDE94Row(const struct_distance_terms &reference, const std::vector<struct_distance_terms> &palette, std::vector<double> &row,
+                        const double &kL=1.0, const double &kC=1.0, const double &kH=1.0); // CIEDE94 distances from one color to all palette colors
+void DistanceOKLABRow(const struct_distance_terms &reference, const std::vector<struct_distance_terms> &palette, std::vector<double> &row); // OKLAB (euclidean) distances from one color to all palette colors
+void DistanceCIEDE2000Matrix(const std::vector<struct_distance_terms> &palette, std::vector<double> &matrix,
+                             const double &k_L=1.0, const double &k_C=1.0, const double &k_H=1.0); // N x N CIEDE2000 distances, row-major - symmetric so only half is computed
+void DistanceCIEDE94Matrix(const std::vector<struct_distance_terms> &palette, std::vector<double> &matrix,
+                           const double &kL=1.0, const double &kC=1.0, const double &kH=1.0); // N x N CIEDE94 distances, row-major - row is the reference color
+void DistanceOKLABMatrix(const std::vector<struct_distance_terms> &palette, std::vector<double> &matrix); // N x N OKLAB (euclidean) distances, row-major - symmetric so only half is computed
+
 //// RGB utils
 
 void RGBtoStandard(const double &r, const double &g, const double &b, int &R, int &G, int &B); // convert RGB [0..1] to RGB [0..255])
+std::string RGBtoHexa(const int &R, const int &G, const int &B); // convert RGB [0..255] to "#RRGGBB" string using the hexadecimal LUT
 void RGBMean(const double &R1, const double &G1, const double &B1, const double W1,
              const double &R2, const double &G2, const double &B2, const double W2,
              double &R, double &G, double &B); // mean RGB value of 2 RGB values with transition to linear RGB
@@ -173,6 +204,7 @@ void HWBtoStandard(const double &h, const double &w, const double &b, int &H, in
 
 void RGBtoXYZ(const double &R, const double &G, const double &B, double &X, double &Y, double &Z); // convert RGB value to CIE XYZ
 void RGBtoXYZ(const int &R, const int &G, const int &B, double &X, double &Y, double &Z); // convert RGB value to CIE XYZ - RGB is 8-bit !
+void LinearRGBtoXYZ(const double &r, const double &g, const double &b, double &X, double &Y, double &Z); // convert linear RGB value to CIE XYZ - use it when linear RGB is already known
 void XYZtoRGB(const double &X, const double &Y, const double &Z, double &R, double &G, double &B); // convert from XYZ to RGB
 void XYZtoRGBNoClipping(const double &X, const double &Y, const double &Z, double &R, double &G, double &B); // convert from XYZ to RGB (in fact sRGB) without clipping to [0..1]
 void XYZtoxyY(const double &X, const double &Y, const double &Z, double &x, double &y); // convert CIE XYZ value to CIE xyY
@@ -215,6 +247,7 @@ void RYBtoRGB(const double &Rryb, const double &Yryb, const double &Bryb, double
 void RGBtoOKLAB(const double &R, const double &G, const double &B, double &L, double &a, double &b); // convert RGB to OKLAB
 void OKLABtoRGB(const double &L, const double &a, const double &b, double &R, double &G, double &B, const bool &clip=true, const float &alpha=0.05); // convert OKLAB to RGB
 void RGBtoOKLAB(const int &R, const int &G, const int &B, double &L, double &a, double &b); // convert RGB to OKLAB - RGB is 8-bit !
+void LinearRGBtoOKLAB(const double &Rl, const double &Gl, const double &Bl, double &L, double &a, double &b); // convert linear RGB to OKLAB - use it when linear RGB is already known
 void OKLABtoStandard(const double &l, const double &a, const double &b, int &L, int &A, int &B); // convert OKLAB [0..1] to OKLAB L [0..100] A and B [-128..127]
 void XYZtoOKLAB(const double &X, const double &Y, const double &Z, double &L, double &a, double &b); // convert from XYZ to OKLAB
 void OKLABtoXYZ(const double &L, const double &a, const double &b, double &X, double &Y, double &Z); // convert OKLAB to XYZ
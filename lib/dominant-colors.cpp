@@ -4,17 +4,34 @@
 #
 #    by AbsurdePhoton - www.absurdephoton.fr
 #
-#                v1.4 - 2022/12/12
+#                v1.7 - 2026/10/18
 #
 #   - all in OKLAB color space
 #   - sectored means (my own) algorithm
 #   - eigen vectors algorithm
 #   - K-means algorithm
+#   - weighted color samples : eigen and K-means
+#     without an image (LUT analysis)
+#   - optional pixel mask for all algorithms :
+#     excluded pixels are skipped, not recolored
+#   - coarse to fine : colors found on a small proxy
+#     are assigned to all pixels of the full image
 #
 #-------------------------------------------------*/
 
 
 #include "dominant-colors.h"
+#include "image-utils.h"
+
+#include <limits>
+
+static cv::Mat IncludedPixels(const cv::Mat &image, const cv::Mat &mask) // 8-bit mask of pixels to analyze from an 8-bit mask or float weights - empty mask = all pixels
+{
+    if (mask.empty())
+        return cv::Mat(image.rows, image.cols, CV_8UC1, cv::Scalar(255));
+
+    return mask > 0; // new continuous 8-bit mask
+}
 
 
 ///////////////////////////////////////////////
@@ -118,9 +135,12 @@ void DeHash3Bytes(const int &hash, uchar &B1, uchar &B2, uchar &B3) // de-concat
     B3 = hash & 255;
 }
 
-std::vector<std::vector<int>> SectoredMeansSegmentation(const cv::Mat &image, cv::Mat &quantized) // BGR image segmentation by color sector mean (H from HSL)
+std::vector<std::vector<int>> SectoredMeansSegmentation(const cv::Mat &image, cv::Mat &quantized, const cv::Mat &mask) // BGR image segmentation by color sector mean (H from HSL)
     // returns a palette that contains 7 values : R/G/B + pixels count + S/L/C
+    // pixels excluded by mask stay black in quantized image and are not counted
 {
+    const cv::Mat included = IncludedPixels(image, mask);
+
     cv::Mat sectors = cv::Mat::zeros(image.rows, image.cols, CV_32SC1); // used to store a hash of s/l/c values (i.e. Hue, Lightness and Chroma)
     cv::Mat imageLAB = cv::Mat::zeros(image.rows, image.cols, CV_64FC3); // to store converted image to OKLAB
 
@@ -130,7 +150,13 @@ std::vector<std::vector<int>> SectoredMeansSegmentation(const cv::Mat &image, cv
         const cv::Vec3b* imageP = image.ptr<cv::Vec3b>(y); // pointers to images
         cv::Vec3d* imageLABp = imageLAB.ptr<cv::Vec3d>(y);
         int* sectorsP = sectors.ptr<int>(y);
+        const uchar* includedP = included.ptr<uchar>(y);
         for (int x = 0; x < image.cols; x++) { // parse image columns
+            if (includedP[x] == 0) { // excluded pixel : no sector
+                sectorsP[x] = -1;
+                continue;
+            }
+
             //RGBtoHSL(imageP[x][2] / 255.0, imageP[x][1] / 255.0, imageP[x][0] / 255.0, Hhsl, S, L, C);
             //RGBtoOKLCH(imageP[x][2], imageP[x][1], imageP[x][0], L, C, Hlab);
             //OKLABtoOKLCH(a, b, C, Hlab);
@@ -156,11 +182,11 @@ std::vector<std::vector<int>> SectoredMeansSegmentation(const cv::Mat &image, cv
         for (int l = 0; l < nb_lightness_categories; l++) {
             for (int c = 0; c < nb_chroma_categories; c++) {
                 int hash = Hash3Bytes(s, l, c); // hash for this sector
-                cv::Mat mask = (sectors == hash); // get mask from sector using the hash value -> we get all pixels for this sector
+                cv::Mat sectorMask = (sectors == hash); // get mask from sector using the hash value -> we get all pixels for this sector
 
-                int count = cv::countNonZero(mask); // count sector's pixels
+                int count = cv::countNonZero(sectorMask); // count sector's pixels
                 if (count > 0) { // does sector mask contain values ?
-                    cv::Scalar mean = cv::mean(imageLAB, mask); // compute mean color of entire sector from OKLAB image using sector mask
+                    cv::Scalar mean = cv::mean(imageLAB, sectorMask); // compute mean color of entire sector from OKLAB image using sector mask
                     OKLABtoRGB(mean[0], mean[1], mean[2], R, G, B); // convert mean OKLAB color to RGB
 
                     std::vector<int> paletteTemp; // "palette" for this sector
@@ -173,7 +199,7 @@ std::vector<std::vector<int>> SectoredMeansSegmentation(const cv::Mat &image, cv
                     paletteTemp.push_back(c);
                     palette.push_back(paletteTemp); // store this sector info in global palette
 
-                    quantized.setTo(cv::Vec3b(paletteTemp[2], paletteTemp[1], paletteTemp[0]), mask); // plot RGB mean color to quantized image
+                    quantized.setTo(cv::Vec3b(paletteTemp[2], paletteTemp[1], paletteTemp[0]), sectorMask); // plot RGB mean color to quantized image
                 }
             }
         }
@@ -380,8 +406,8 @@ std::vector<color_node*> GetLeaves(color_node *root)
         queue.pop();
 
         if (current->left && current->right) {
-            queue.push(current->left);
-            queue.push(current->right);
+            queue.push(current->left.get());
+            queue.push(current->right.get());
             continue;
         }
 
@@ -418,17 +444,18 @@ int GetNextClassId(color_node *root) {
         if (current->class_id > maxid)
             maxid = current->class_id;
 
-        if (current->left != NULL)
-            queue.push(current->left);
+        if (current->left)
+            queue.push(current->left.get());
 
         if (current->right)
-            queue.push(current->right);
+            queue.push(current->right.get());
     }
 
     return maxid + 1;
 }
 
-void GetClassMeanCov(cv::Mat img, cv::Mat classes, color_node *node)
+void GetClassMeanCov(cv::Mat img, cv::Mat classes, color_node *node, const cv::Mat &weights)
+    // weights : CV_32FC1 weight of each pixel - empty = same weight
 {
     const int width = img.cols;
     const int height = img.rows;
@@ -442,20 +469,22 @@ void GetClassMeanCov(cv::Mat img, cv::Mat classes, color_node *node)
     for (int y = 0; y < height; y++) {
         cv::Vec3d* ptr = img.ptr<cv::Vec3d>(y);
         char16_t* ptrClass = classes.ptr<char16_t>(y);
+        const float* ptrWeight = weights.empty() ? nullptr : weights.ptr<float>(y);
         for (int x=0; x < width; x++) {
             if (ptrClass[x] != class_id)
                 continue;
 
+            const double weight = ptrWeight ? ptrWeight[x] : 1.0;
             cv::Vec3d color = ptr[x];
             cv::Mat scaled = cv::Mat::zeros(3, 1, CV_64FC1);
             scaled.at<double>(0) = color[0];
             scaled.at<double>(1) = color[1];
             scaled.at<double>(2) = color[2];
 
-            mean += scaled;
-            cov = cov + (scaled * scaled.t());
+            mean += weight * scaled;
+            cov = cov + weight * (scaled * scaled.t());
 
-            pix_count++;
+            pix_count += weight;
         }
     }
 
@@ -485,8 +514,8 @@ void PartitionClass(cv::Mat img, cv::Mat classes, char16_t nextid, color_node *n
     cv::Mat eig = eigen_vectors.row(0);
     cv::Mat comparison_value = eig * mean;
 
-    node->left = new color_node();
-    node->right = new color_node();
+    node->left.reset(new color_node());
+    node->right.reset(new color_node());
 
     node->left->class_id = new_id_left;
     node->right->class_id = new_id_right;
@@ -562,8 +591,8 @@ color_node* GetMaxEigenValueNode(color_node *current) {
         queue.pop();
 
         if (node->left && node->right) {
-            queue.push(node->left);
-            queue.push(node->right);
+            queue.push(node->left.get());
+            queue.push(node->right.get());
             continue;
         }
 
@@ -578,12 +607,18 @@ color_node* GetMaxEigenValueNode(color_node *current) {
     return ret;
 }
 
-std::vector<cv::Vec3d> DominantColorsEigen(const cv::Mat &img, const int &nb_colors, cv::Mat &quantized) // Eigen algorithm with CIELab or OKLAB values in range [0..1]
+std::vector<cv::Vec3d> DominantColorsEigen(const cv::Mat &img, const int &nb_colors, cv::Mat &quantized, const cv::Mat &mask) // Eigen algorithm with CIELab or OKLAB values in range [0..1]
     // input and ouput images in CIELab or OKLAB values of range [0..1]
     // returns a list of dominant colors in values of range [0..1]
+    // mask : CV_8UC1 (0 = excluded) or CV_32FC1 weights (0 = excluded) - excluded pixels are 0 in quantized image
 {
-    // particular cases are all white or all black image
-    cv::Scalar mean = cv::mean(img);
+    const cv::Mat included = IncludedPixels(img, mask);
+    cv::Mat weights; // float weights only if given
+    if (mask.type() == CV_32FC1)
+        weights = mask;
+
+    // particular cases are all white or all black image, or no pixel at all
+    cv::Scalar mean = cv::mean(img, included);
     if (mean[0] > 0.99999999)
         mean[0] = 1.0;
     if (mean[1] < 0.000001)
@@ -591,12 +626,12 @@ std::vector<cv::Vec3d> DominantColorsEigen(const cv::Mat &img, const int &nb_col
     if (mean[2] < 0.000001)
         mean[2] = 0;
 
-    if ((mean == cv::Scalar(1.0, 0, 0)) or (mean == cv::Scalar(0.0, 0.0, 0.0))) {
+    if ((mean == cv::Scalar(1.0, 0, 0)) or (mean == cv::Scalar(0.0, 0.0, 0.0)) or (cv::countNonZero(included) == 0)) {
         cv::Vec3d result;
         quantized = cv::Mat::zeros(img.rows, img.cols, CV_64FC3);
         if (mean == cv::Scalar(1.0, 0, 0)) {
             result = cv::Vec3d(1.0, 0, 0);
-            quantized.setTo(result);
+            quantized.setTo(result, included);
         }
         else {
             result = cv::Vec3d(0, 0, 0);
@@ -612,27 +647,24 @@ std::vector<cv::Vec3d> DominantColorsEigen(const cv::Mat &img, const int &nb_col
     const int width = img.cols;
     const int height = img.rows;
 
-    cv::Mat classes = cv::Mat(height, width, CV_16UC1, cv::Scalar(1));
-    color_node *root = new color_node();
+    cv::Mat classes = cv::Mat::zeros(height, width, CV_16UC1); // class 0 is never split : excluded pixels are never visited again
+    classes.setTo(1, included);
+    std::unique_ptr<color_node> root(new color_node()); // whole tree is freed when root goes out of scope
 
     root->class_id = 1;
-    root->left = NULL;
-    root->right = NULL;
 
-    color_node *next = root;
-    GetClassMeanCov(img, classes, root);
+    color_node *next = root.get();
+    GetClassMeanCov(img, classes, root.get(), weights);
 
     for (int i = 0; i < nb_colors - 1; i++) {
-        next = GetMaxEigenValueNode(root);
-        PartitionClass(img, classes, GetNextClassId(root), next);
-        GetClassMeanCov(img, classes, next->left);
-        GetClassMeanCov(img, classes, next->right);
+        next = GetMaxEigenValueNode(root.get());
+        PartitionClass(img, classes, GetNextClassId(root.get()), next);
+        GetClassMeanCov(img, classes, next->left.get(), weights);
+        GetClassMeanCov(img, classes, next->right.get(), weights);
     }
 
-    std::vector<cv::Vec3d> colors = GetDominantColors(root);
-    quantized = GetQuantizedImage(classes, root); // the quantized image has values in range [0..1]
-
-    delete(root);
+    std::vector<cv::Vec3d> colors = GetDominantColors(root.get());
+    quantized = GetQuantizedImage(classes, root.get()); // the quantized image has values in range [0..1]
 
     return colors;
 }
@@ -641,25 +673,57 @@ std::vector<cv::Vec3d> DominantColorsEigen(const cv::Mat &img, const int &nb_col
 ////                K_means algorithm
 ////////////////////////////////////////////////////////////
 
-cv::Mat DominantColorsKMeansRGB_U(const cv::Mat &source, const int &nb_clusters, cv::Mat1f &dominant_colors) // Dominant colors with K-means from RGB image using UMat
+// cv::kmeans has no sample weights : with a mask only included pixels are clustered, float weights only tell which pixels are included
+
+static cv::Mat IncludedRows(const cv::Mat &data, const cv::Mat &included) // rows of data (one per pixel) for included pixels
+{
+    cv::Mat rows(cv::countNonZero(included), data.cols, data.type());
+    const uchar* includedP = included.ptr<uchar>(0);
+    int row = 0;
+    for (int i = 0; i < data.rows; i++)
+        if (includedP[i] != 0)
+            data.row(i).copyTo(rows.row(row++));
+
+    return rows;
+}
+
+static void ReplaceIncludedRows(cv::Mat &data, const cv::Mat &included, const std::vector<int> &indices, const cv::Mat1f &colors) // replace colors in data with their cluster center - excluded pixels = 0
+{
+    const uchar* includedP = included.ptr<uchar>(0);
+    int row = 0;
+    for (int i = 0 ; i < data.rows ; i++ ) {
+        float* dataP = data.ptr<float>(i);
+        if (includedP[i] == 0) {
+            dataP[0] = 0; dataP[1] = 0; dataP[2] = 0;
+            continue;
+        }
+        const int index = indices[row++];
+        dataP[0] = colors(index, 0);
+        dataP[1] = colors(index, 1);
+        dataP[2] = colors(index, 2);
+    }
+}
+
+cv::Mat DominantColorsKMeansRGB_U(const cv::Mat &source, const int &nb_clusters, cv::Mat1f &dominant_colors, const cv::Mat &mask) // Dominant colors with K-means from RGB image using UMat
 {
     const unsigned int data_size = source.rows * source.cols; // size of source
+    const cv::Mat included = IncludedPixels(source, mask);
     cv:: UMat sourceU = source.getUMat(cv::ACCESS_READ);
     cv::UMat data = sourceU.reshape(1, data_size); // reshape the source to a single line
     data.convertTo(data, CV_32F); // floats needed by K-means
 
+    cv::UMat samples = data; // only included pixels are clustered
+    if (!mask.empty()) {
+        cv::Mat data_read = data.getMat(cv::ACCESS_READ);
+        IncludedRows(data_read, included).copyTo(samples);
+    }
     std::vector<int> indices; // color clusters
     cv::Mat1f colors; // colors output
-    cv::kmeans(data, nb_clusters, indices, cv::TermCriteria(cv::TermCriteria::EPS+cv::TermCriteria::COUNT, 100, 1.0),
+    cv::kmeans(samples, std::min(nb_clusters, samples.rows), indices, cv::TermCriteria(cv::TermCriteria::EPS+cv::TermCriteria::COUNT, 100, 1.0),
                100, cv::KMEANS_PP_CENTERS, colors); // ending criterias : 100 iterations and epsilon=1.0
 
     cv::Mat data_res = data.getMat(cv::ACCESS_RW);
-    for (unsigned int i = 0 ; i < data_size ; i++ ) { // replace colors in image data
-        float* dataP = data_res.ptr<float>(i);
-        dataP[0] = colors(indices[i], 0);
-        dataP[1] = colors(indices[i], 1);
-        dataP[2] = colors(indices[i], 2);
-    }
+    ReplaceIncludedRows(data_res, included, indices, colors); // replace colors in image data
 
     cv::Mat output_image = data_res.reshape(3, source.rows); // RGB channels needed for output
     output_image.convertTo(output_image, CV_8UC3); // BGR image
@@ -669,23 +733,20 @@ cv::Mat DominantColorsKMeansRGB_U(const cv::Mat &source, const int &nb_clusters,
     return output_image; // return quantized image
 }
 
-cv::Mat DominantColorsKMeansRGB(const cv::Mat &source, const int &nb_clusters, cv::Mat1f &dominant_colors) // Dominant colors with K-means from RGB image
+cv::Mat DominantColorsKMeansRGB(const cv::Mat &source, const int &nb_clusters, cv::Mat1f &dominant_colors, const cv::Mat &mask) // Dominant colors with K-means from RGB image
 {
     const unsigned int data_size = source.rows * source.cols; // size of source
+    const cv::Mat included = IncludedPixels(source, mask);
     cv::Mat data = source.reshape(1, data_size); // reshape the source to a single line
     data.convertTo(data, CV_32F); // floats needed by K-means
 
+    cv::Mat samples = mask.empty() ? data : IncludedRows(data, included); // only included pixels are clustered
     std::vector<int> indices; // color clusters
     cv::Mat1f colors; // colors output
-    cv::kmeans(data, nb_clusters, indices, cv::TermCriteria(cv::TermCriteria::EPS+cv::TermCriteria::COUNT, 100, 1.0),
+    cv::kmeans(samples, std::min(nb_clusters, samples.rows), indices, cv::TermCriteria(cv::TermCriteria::EPS+cv::TermCriteria::COUNT, 100, 1.0),
                100, cv::KMEANS_PP_CENTERS, colors); // ending criterias : 100 iterations and epsilon=1.0
 
-    for (unsigned int i = 0 ; i < data_size ; i++ ) { // replace colors in image data
-        float* dataP = data.ptr<float>(i);
-        dataP[0] = colors(indices[i], 0);
-        dataP[1] = colors(indices[i], 1);
-        dataP[2] = colors(indices[i], 2);
-    }
+    ReplaceIncludedRows(data, included, indices, colors); // replace colors in image data
 
     cv::Mat output_image = data.reshape(3, source.rows); // RGB channels needed for output
     output_image.convertTo(output_image, CV_8UC3); // BGR image
@@ -695,7 +756,7 @@ cv::Mat DominantColorsKMeansRGB(const cv::Mat &source, const int &nb_clusters, c
     return output_image; // return quantized image
 }
 
-cv::Mat DominantColorsKMeans(const cv::Mat &source, const int &nb_clusters, cv::Mat1f &dominant_colors) // Dominant colors with K-means in CIELAB or OKLAB space
+cv::Mat DominantColorsKMeans(const cv::Mat &source, const int &nb_clusters, cv::Mat1f &dominant_colors, const cv::Mat &mask) // Dominant colors with K-means in CIELAB or OKLAB space
     // source must be a CIELab or OKLAB image of type CV_64FC3
     // output is of same type : CV_64FC3
 {
@@ -703,19 +764,16 @@ cv::Mat DominantColorsKMeans(const cv::Mat &source, const int &nb_clusters, cv::
     source.convertTo(temp, CV_32FC3); // source type is CV_64FC3 ! k-means function is not optimized anymore
 
     const unsigned int data_size = source.rows * source.cols; // size of source
-    cv::Mat1f data = temp.reshape(1, data_size); // reshape data to a single line
+    const cv::Mat included = IncludedPixels(source, mask);
+    cv::Mat data = temp.reshape(1, data_size); // reshape data to a single line
 
+    cv::Mat samples = mask.empty() ? data : IncludedRows(data, included); // only included pixels are clustered
     std::vector<int> indices; // color clusters
     cv::Mat1f colors; // colors output
-    cv::kmeans(data, nb_clusters, indices, cv::TermCriteria(cv::TermCriteria::EPS+cv::TermCriteria::COUNT, 100, 1.0),
+    cv::kmeans(samples, std::min(nb_clusters, samples.rows), indices, cv::TermCriteria(cv::TermCriteria::EPS+cv::TermCriteria::COUNT, 100, 1.0),
                100, cv::KMEANS_PP_CENTERS, colors); // k-means on data, ending criterias : 100 iterations and epsilon=1.0
 
-    for (unsigned int i = 0 ; i < data_size ; i++ ) { // replace colors in data
-        float* dataP = data.ptr<float>(i);
-        dataP[0] = colors(indices[i], 0);
-        dataP[1] = colors(indices[i], 1);
-        dataP[2] = colors(indices[i], 2);
-    }
+    ReplaceIncludedRows(data, included, indices, colors); // replace colors in data
 
     cv::Mat output_image = data.reshape(3, source.rows); // 3 channels needed for output
     output_image.convertTo(output_image, CV_64FC3); // same type as output
@@ -725,6 +783,206 @@ cv::Mat DominantColorsKMeans(const cv::Mat &source, const int &nb_clusters, cv::
     return output_image; // return quantized image
 }
 
+////////////////////////////////////////////////////////////
+////                   Coarse to fine
+////////////////////////////////////////////////////////////
+
+// clusters are found on a small proxy of the image, then every pixel of the full image gets its nearest center
+// the nearest center is computed once per distinct color, not once per pixel : a 2^24 table gives the label of each pixel
+
+cv::Mat QuantizeToNearestColors(const cv::Mat &image, const std::vector<cv::Vec3d> &centers, const std::vector<cv::Vec3b> &colors,
+                                const CentersSpace &space, const cv::Mat &mask) // BGR image where each pixel gets the BGR color of its nearest center
+{
+    cv::Mat quantized = cv::Mat::zeros(image.rows, image.cols, CV_8UC3); // excluded pixels stay black
+    if (centers.empty())
+        return quantized;
+
+    std::vector<int> unique; // distinct colors of image, 0xRRGGBB
+    UniqueColorsImageRGB24(image, unique, mask);
+
+    std::vector<uint16_t> labels(1 << 24); // nearest center of each distinct color, at index 0xRRGGBB
+    const int nbUnique = unique.size();
+    const int nbCenters = std::min(int(centers.size()), 65536);
+
+    #pragma omp parallel for
+    for (int n = 0; n < nbUnique; n++) {
+        const int R = (unique[n] >> 16) & 0xff;
+        const int G = (unique[n] >> 8) & 0xff;
+        const int B = unique[n] & 0xff;
+
+        cv::Vec3d color; // in the color space of the centers
+        if (space == CentersCIELab)
+            RGBtoCIELab(R, G, B, color[0], color[1], color[2]);
+        else
+            color = cv::Vec3d(B, G, R);
+
+        int nearest = 0;
+        double nearestDistance = std::numeric_limits<double>::max();
+        for (int c = 0; c < nbCenters; c++) {
+            const cv::Vec3d delta = color - centers[c];
+            const double distance = delta.dot(delta); // squared euclidean distance is enough
+            if (distance < nearestDistance) {
+                nearestDistance = distance;
+                nearest = c;
+            }
+        }
+        labels[unique[n]] = nearest;
+    }
+
+    #pragma omp parallel for
+    for (int y = 0; y < image.rows; y++) {
+        const cv::Vec3b* imageP = image.ptr<cv::Vec3b>(y);
+        const uchar* maskP = mask.empty() ? nullptr : mask.ptr<uchar>(y);
+        cv::Vec3b* quantizedP = quantized.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < image.cols; x++)
+            if ((!maskP) or (maskP[x] != 0))
+                quantizedP[x] = colors[labels[(imageP[x][2] << 16) | (imageP[x][1] << 8) | imageP[x][0]]];
+    }
+
+    return quantized;
+}
+
+////////////////////////////////////////////////////////////
+////              Weighted color samples
+////////////////////////////////////////////////////////////
+
+// same algorithms as above, for colors that don't come from an image (LUT entries...) : each sample has a weight,
+// clusters only visit their own samples
+
+struct struct_sample_cluster { // one cluster of samples for the eigen algorithm
+    std::vector<int> members; // indexes of samples
+    cv::Vec3d mean; // weighted mean
+    cv::Matx33d scatter; // weighted scatter matrix = covariance * total weight
+    double weight; // total weight
+    double eigenValue; // biggest eigen value of scatter - -1 = can't be split
+    cv::Vec3d eigenVector; // its eigen vector
+};
+
+static void SampleClusterStats(const std::vector<cv::Vec3d> &samples, const std::vector<double> &weights, struct_sample_cluster &cluster) // weighted mean, scatter and main axis of a cluster
+{
+    cv::Vec3d sum(0, 0, 0);
+    cv::Matx33d sum2 = cv::Matx33d::zeros();
+    double total = 0;
+
+    for (const int &i : cluster.members) {
+        const double w = weights.empty() ? 1.0 : weights[i];
+        const cv::Vec3d &x = samples[i];
+        sum += w * x;
+        for (int r = 0; r < 3; r++)
+            for (int c = 0; c < 3; c++)
+                sum2(r, c) += w * x[r] * x[c];
+        total += w;
+    }
+
+    cluster.weight = total;
+    cluster.mean = (total > 0) ? sum / total : sum;
+    cluster.scatter = sum2;
+    for (int r = 0; r < 3; r++)
+        for (int c = 0; c < 3; c++)
+            cluster.scatter(r, c) -= total * cluster.mean[r] * cluster.mean[c];
+
+    cv::Mat eigen_values, eigen_vectors;
+    cv::eigen(cv::Mat(cluster.scatter), eigen_values, eigen_vectors);
+    cluster.eigenValue = (cluster.members.size() > 1) ? eigen_values.at<double>(0) : -1; // one sample can't be split
+    cluster.eigenVector = cv::Vec3d(eigen_vectors.at<double>(0, 0), eigen_vectors.at<double>(0, 1), eigen_vectors.at<double>(0, 2));
+}
+
+std::vector<cv::Vec3d> DominantColorsEigenSamples(const std::vector<cv::Vec3d> &samples, const std::vector<double> &weights, const int &nb_colors, std::vector<int> &labels) // Eigen algorithm on weighted color samples
+{
+    labels.assign(samples.size(), 0);
+    if (samples.empty() or (nb_colors < 1))
+        return std::vector<cv::Vec3d>();
+
+    std::vector<struct_sample_cluster> clusters(1); // all samples in first cluster
+    clusters[0].members.resize(samples.size());
+    for (int i = 0; i < int(samples.size()); i++)
+        clusters[0].members[i] = i;
+    SampleClusterStats(samples, weights, clusters[0]);
+
+    while (int(clusters.size()) < nb_colors) {
+        int next = 0; // cluster with the biggest spread
+        for (int n = 1; n < int(clusters.size()); n++)
+            if (clusters[n].eigenValue > clusters[next].eigenValue)
+                next = n;
+        if (clusters[next].eigenValue <= 0) // nothing left to split : all clusters are single colors
+            break;
+
+        struct_sample_cluster left, right; // split along main axis, through the mean
+        const double comparison_value = clusters[next].eigenVector.dot(clusters[next].mean);
+        for (const int &i : clusters[next].members) {
+            if (clusters[next].eigenVector.dot(samples[i]) <= comparison_value)
+                left.members.push_back(i);
+            else
+                right.members.push_back(i);
+        }
+        if (left.members.empty() or right.members.empty()) { // same color for all samples
+            clusters[next].eigenValue = -1;
+            continue;
+        }
+
+        SampleClusterStats(samples, weights, left);
+        SampleClusterStats(samples, weights, right);
+        clusters[next] = std::move(left);
+        clusters.push_back(std::move(right));
+    }
+
+    std::vector<cv::Vec3d> colors(clusters.size());
+    for (int n = 0; n < int(clusters.size()); n++) {
+        colors[n] = clusters[n].mean;
+        for (const int &i : clusters[n].members)
+            labels[i] = n;
+    }
+
+    return colors;
+}
+
+std::vector<cv::Vec3d> DominantColorsKMeansSamples(const std::vector<cv::Vec3d> &samples, const std::vector<double> &weights, const int &nb_colors, std::vector<int> &labels) // weighted K-means on color samples
+{
+    std::vector<cv::Vec3d> centers = DominantColorsEigenSamples(samples, weights, nb_colors, labels); // good deterministic start : few iterations needed
+    const int nb_centers = centers.size();
+    const int nb_samples = samples.size();
+    if (nb_centers < 2)
+        return centers;
+
+    const int max_iterations = 20; // ending criterias
+    const double epsilon = 0.001; // biggest move of a center
+
+    for (int iteration = 0; iteration < max_iterations; iteration++) {
+        #pragma omp parallel for
+        for (int i = 0; i < nb_samples; i++) { // nearest center of each sample
+            double best = cv::norm(samples[i] - centers[labels[i]], cv::NORM_L2SQR);
+            for (int n = 0; n < nb_centers; n++) {
+                const double d = cv::norm(samples[i] - centers[n], cv::NORM_L2SQR);
+                if (d < best) {
+                    best = d;
+                    labels[i] = n;
+                }
+            }
+        }
+
+        std::vector<cv::Vec3d> sums(nb_centers, cv::Vec3d(0, 0, 0)); // weighted means of clusters
+        std::vector<double> totals(nb_centers, 0);
+        for (int i = 0; i < nb_samples; i++) {
+            const double w = weights.empty() ? 1.0 : weights[i];
+            sums[labels[i]] += w * samples[i];
+            totals[labels[i]] += w;
+        }
+
+        double shift = 0;
+        for (int n = 0; n < nb_centers; n++) {
+            if (totals[n] <= 0) // empty cluster keeps its center
+                continue;
+            const cv::Vec3d center = sums[n] / totals[n];
+            shift = std::max(shift, cv::norm(center - centers[n]));
+            centers[n] = center;
+        }
+        if (shift < epsilon)
+            break;
+    }
+
+    return centers;
+}
+
 ////////////////////////////////////////////////////////////
 ////                  Mean-Shift algorithm
 ////////////////////////////////////////////////////////////
@@ -802,11 +1060,14 @@ MeanShift::MeanShift(const double &s, const double &r) // Constructor for spatia
     hr = r;
 }
 
-void MeanShift::MeanShiftFiltering(cv::Mat &img) // Mean Shift Filtering
+void MeanShift::MeanShiftFiltering(cv::Mat &img, const cv::Mat &mask) const // Mean Shift Filtering
     // image must be CV_64FC3 (CIELab or OKLab)
+    // pixels excluded by mask are neither filtered nor used as neighbours
 {
     int ROWS = img.rows;			// Get row number
     int COLS = img.cols;			// Get column number
+    const cv::Mat included = IncludedPixels(img, mask);
+    std::vector<cv::Mat> IMGChannels; // local copy of the channels : no state kept in the object
     split(img, IMGChannels);		// Split Lab color
 
     Point5D PtCur;					// Current point
@@ -825,7 +1086,10 @@ void MeanShift::MeanShiftFiltering(cv::Mat &img) // Mean Shift Filtering
         double* IMGChannels1P = IMGChannels[1].ptr<double>(i);
         double* IMGChannels2P = IMGChannels[2].ptr<double>(i);
         cv::Vec3d* imgP = img.ptr<cv::Vec3d>(i);
+        const uchar* includedP = included.ptr<uchar>(i);
         for(int j = 0; j < COLS; j++) {
+            if (includedP[j] == 0)									// Excluded pixel : kept as is
+                continue;
             Left = (j - hs) > 0 ? (j - hs) : 0;						// Get Left boundary of the filter
             Right = (j + hs) < COLS ? (j + hs) : COLS;				// Get Right boundary of the filter
             Top = (i - hs) > 0 ? (i - hs) : 0;						// Get Top boundary of the filter
@@ -840,7 +1104,10 @@ void MeanShift::MeanShiftFiltering(cv::Mat &img) // Mean Shift Filtering
                     double* IMGChannels0P = IMGChannels[0].ptr<double>(hx);
                     double* IMGChannels1P = IMGChannels[1].ptr<double>(hx);
                     double* IMGChannels2P = IMGChannels[2].ptr<double>(hx);
+                    const uchar* includedP = included.ptr<uchar>(hx);
                     for(int hy = Left; hy < Right; hy++) {
+                        if (includedP[hy] == 0)						// Excluded neighbour
+                            continue;
                         Pt.MSPOint5DSet(hx, hy, IMGChannels0P[hy], IMGChannels1P[hy], IMGChannels2P[hy]); // Set point in the spatial bandwidth
                         if (Pt.MSPoint5DColorDistance(PtCur) < hr) { // Check it satisfied color bandwidth or not
                             PtSum.MSPoint5DAccum(Pt);				// Accumulate the point to Sum vector
@@ -859,9 +1126,11 @@ void MeanShift::MeanShiftFiltering(cv::Mat &img) // Mean Shift Filtering
     }
 }
 
-void MeanShift::MeanShiftSegmentation(cv::Mat &img) // Mean Shift Segmentation
+void MeanShift::MeanShiftSegmentation(cv::Mat &img, const cv::Mat &mask) const // Mean Shift Segmentation
     // image must be CV_64FC3 (CIELab or OKLab)
+    // pixels excluded by mask get no region and are kept as is
 {
+    const cv::Mat included = IncludedPixels(img, mask);
     int ROWS = img.rows;			// Get row number
     int COLS = img.cols;			// Get column number
 
@@ -869,21 +1138,18 @@ void MeanShift::MeanShiftSegmentation(cv::Mat &img) // Mean Shift Segmentation
     Point5D Pt;
 
     int label = -1;					// Label number
-    double *Mode = new double [ROWS * COLS * 3];					// Store the Lab color of each region
-    int *MemberModeCount = new int [ROWS * COLS];				// Store the number of each region
-    memset(MemberModeCount, 0, ROWS * COLS * sizeof(int));		// Initialize the MemberModeCount
+    std::vector<double> Mode(ROWS * COLS * 3);					// Store the Lab color of each region
+    std::vector<int> MemberModeCount(ROWS * COLS, 0);			// Store the number of each region
+    std::vector<cv::Mat> IMGChannels; // local copy of the channels : no state kept in the object
     split(img, IMGChannels); // split image
 
-    // Label for each point
-    int **Labels = new int *[ROWS];
-    for(int i = 0; i < ROWS; i++)
-        Labels[i] = new int [COLS];
-
-    // Initialization
+    // Label for each point, initialized to -1 - excluded points are -2
+    std::vector<std::vector<int>> Labels(ROWS, std::vector<int>(COLS, -1));
     for(int i = 0; i < ROWS; i++) {
-        for(int j = 0; j < COLS; j++) {
-            Labels[i][j] = -1;
-        }
+        const uchar* includedP = included.ptr<uchar>(i);
+        for(int j = 0; j < COLS; j++)
+            if (includedP[j] == 0)
+                Labels[i][j] = -2;
     }
 
     for(int i = 0; i < ROWS; i++) {
@@ -891,7 +1157,7 @@ void MeanShift::MeanShiftSegmentation(cv::Mat &img) // Mean Shift Segmentation
         double* IMGChannels1P = IMGChannels[1].ptr<double>(i);
         double* IMGChannels2P = IMGChannels[2].ptr<double>(i);
         for(int j = 0; j < COLS; j ++) {
-            if (Labels[i][j] < 0) { // If the point is not being labeled
+            if (Labels[i][j] == -1) { // If the point is not being labeled
                 Labels[i][j] = ++label;		// Give it a new label number
                 PtCur.MSPOint5DSet(i, j, IMGChannels0P[j], IMGChannels1P[j], IMGChannels2P[j]); // Get the point
 
@@ -911,7 +1177,7 @@ void MeanShift::MeanShiftSegmentation(cv::Mat &img) // Mean Shift Segmentation
                     for(int k = 0; k < 8; k++) {
                         int hx = Pt.x + dxdy[k][0];
                         int hy = Pt.y + dxdy[k][1];
-                        if ((hx >= 0) && (hy >= 0) && (hx < ROWS) && (hy < COLS) && (Labels[hx][hy] < 0)) {
+                        if ((hx >= 0) && (hy >= 0) && (hx < ROWS) && (hy < COLS) && (Labels[hx][hy] == -1)) {
                             Point5D P;
                             P.MSPOint5DSet(hx, hy, IMGChannels[0].at<double>(hx, hy), IMGChannels[1].at<double>(hx, hy), IMGChannels[2].at<double>(hx, hy));
 
@@ -941,6 +1207,8 @@ void MeanShift::MeanShiftSegmentation(cv::Mat &img) // Mean Shift Segmentation
         cv::Vec3d* imgP = img.ptr<cv::Vec3d>(i);
         for(int j = 0; j < COLS; j++) {
             label = Labels[i][j];
+            if (label < 0)											// Excluded point
+                continue;
             double l = Mode[label * 3 + 0];
             double a = Mode[label * 3 + 1];
             double b = Mode[label * 3 + 2];
@@ -949,12 +1217,4 @@ void MeanShift::MeanShiftSegmentation(cv::Mat &img) // Mean Shift Segmentation
             imgP[j] = cv::Vec3d(Pixel.l, Pixel.a, Pixel.b);
         }
     }
-
-// Clean Memory
-    delete[] Mode;
-    delete[] MemberModeCount;
-
-    for(int i = 0; i < ROWS; i++)
-        delete[] Labels[i];
-    delete[] Labels;
 }
@@ -4,12 +4,18 @@
 #
 #    by AbsurdePhoton - www.absurdephoton.fr
 #
-#                v1.4 - 2022/12/12
+#                v1.7 - 2026/10/18
 #
 #   - all in OKLAB color space
 #   - sectored means (my own) algorithm
 #   - eigen vectors algorithm
 #   - K-means algorithm
+#   - weighted color samples : eigen and K-means
+#     without an image (LUT analysis)
+#   - optional pixel mask for all algorithms :
+#     excluded pixels are skipped, not recolored
+#   - coarse to fine : colors found on a small proxy
+#     are assigned to all pixels of the full image
 #
 #-------------------------------------------------*/
 
@@ -19,6 +25,7 @@
 #include "opencv2/opencv.hpp"
 
 #include <fstream>
+#include <memory>
 
 #include "color-spaces.h"
 
@@ -137,7 +144,7 @@ int WhichColorSector(const double &H); // get the color sector of a given Hue in
 int WhichLightnessCategory(const double &L); // get the Lightness category (L from OKLAB)
 int WhichChromaCategory(const double &C, const int &colorSector); // get the Chroma category (C from OKLCH)
 int WhichSaturationCategory(const double &S, const int &colorSector); // get the Saturation category (S from HSL)
-std::vector<std::vector<int>> SectoredMeansSegmentation(const cv::Mat &image, cv::Mat &quantized); // BGR image segmentation by color sector mean (H from HSL)
+std::vector<std::vector<int>> SectoredMeansSegmentation(const cv::Mat &image, cv::Mat &quantized, const cv::Mat &mask = cv::Mat()); // BGR image segmentation by color sector mean (H from HSL) - mask : CV_8UC1 or CV_32FC1, 0 = pixel excluded
 void DrawSectoredMeansPalettesCIELab(); // save Sectored Means palettes to images : scales are computed, values come from pre-defined RGB colors - use as reference
 void FindSectorsMaxValuesCIELab(const int &intervals, const std::string filename); // write max values (C, S, L) for each color sector (CIELab)
 void FindSectorsMaxValuesOKLAB(const int &intervals, const std::string filename); // write max values (C, S, L) for each color sector (OKLAB)
@@ -155,19 +162,36 @@ typedef struct color_node { // for eigen algorithm
     cv::Mat     cov;
     int       class_id;
 
-    color_node *left;
-    color_node *right;
+    std::unique_ptr<color_node> left; // children are owned by their parent : deleting the root deletes the whole tree
+    std::unique_ptr<color_node> right;
 } color_node;
 
-std::vector<cv::Vec3d> DominantColorsEigen(const cv::Mat &img, const int &nb_colors, cv::Mat &quantized); // Eigen algorithm with CIELab or OKLAB values in range [0..1]
+std::vector<cv::Vec3d> DominantColorsEigen(const cv::Mat &img, const int &nb_colors, cv::Mat &quantized, const cv::Mat &mask = cv::Mat()); // Eigen algorithm with CIELab or OKLAB values in range [0..1] - mask : CV_8UC1 or CV_32FC1 pixel weights, 0 = pixel excluded
 
 ///////////////////////////////////////////////
 ////                K-means
 ///////////////////////////////////////////////
 
-cv::Mat DominantColorsKMeansRGB_U(const cv::Mat &source, const int &nb_clusters, cv::Mat1f &dominant_colors); // Dominant colors with K-means from RGB image using UMat
-cv::Mat DominantColorsKMeansRGB(const cv::Mat &image, const int &cluster_number, cv::Mat1f &dominant_colors); // Dominant colors with K-means from RGB image
-cv::Mat DominantColorsKMeans(const cv::Mat &image, const int &cluster_number, cv::Mat1f &dominant_colors); // Dominant colors with K-means in CIELAB or OKLAB space from RGB image
+// mask : CV_8UC1 or CV_32FC1, 0 = pixel excluded - K-means has no sample weights, excluded pixels are 0 in the returned image
+cv::Mat DominantColorsKMeansRGB_U(const cv::Mat &source, const int &nb_clusters, cv::Mat1f &dominant_colors, const cv::Mat &mask = cv::Mat()); // Dominant colors with K-means from RGB image using UMat
+cv::Mat DominantColorsKMeansRGB(const cv::Mat &image, const int &cluster_number, cv::Mat1f &dominant_colors, const cv::Mat &mask = cv::Mat()); // Dominant colors with K-means from RGB image
+cv::Mat DominantColorsKMeans(const cv::Mat &image, const int &cluster_number, cv::Mat1f &dominant_colors, const cv::Mat &mask = cv::Mat()); // Dominant colors with K-means in CIELAB or OKLAB space from RGB image
+
+///////////////////////////////////////////////
+////              Coarse to fine
+///////////////////////////////////////////////
+
+enum CentersSpace {CentersBGR, CentersCIELab}; // color space of cluster centers : BGR in [0..255] (K-means RGB) or CIELab in [0..1] (Eigen)
+
+cv::Mat QuantizeToNearestColors(const cv::Mat &image, const std::vector<cv::Vec3d> &centers, const std::vector<cv::Vec3b> &colors,
+                                const CentersSpace &space, const cv::Mat &mask = cv::Mat()); // BGR image where each pixel of BGR image gets the BGR color of its nearest center - excluded pixels (mask = 0) are black
+
+///////////////////////////////////////////////
+////          Weighted color samples
+///////////////////////////////////////////////
+
+std::vector<cv::Vec3d> DominantColorsEigenSamples(const std::vector<cv::Vec3d> &samples, const std::vector<double> &weights, const int &nb_colors, std::vector<int> &labels); // Eigen algorithm on color samples of any color space - empty weights = same weight - labels = cluster of each sample
+std::vector<cv::Vec3d> DominantColorsKMeansSamples(const std::vector<cv::Vec3d> &samples, const std::vector<double> &weights, const int &nb_colors, std::vector<int> &labels); // weighted K-means on color samples, starting from the Eigen clusters - empty weights = same weight
 
 ///////////////////////////////////////////////
 ////              Mean-Shift
@@ -192,15 +216,14 @@ class Point5D { // 5-Dimensional Point
         //void Print();												// Print 5D point
 };
 
-class MeanShift {
+class MeanShift { // only holds parameters : the same object can be used by several threads at once
     public:
         double hs;				// spatial radius
         double hr;				// color radius
-        std::vector<cv::Mat> IMGChannels;
     public:
         MeanShift(const double &, const double &);									// Constructor for spatial bandwidth and color bandwidth
-        void MeanShiftFiltering(cv::Mat &img);										// Mean Shift Filtering
-        void MeanShiftSegmentation(cv::Mat &img);									// Mean Shift Segmentation
+        void MeanShiftFiltering(cv::Mat &img, const cv::Mat &mask = cv::Mat()) const;		// Mean Shift Filtering - mask : 0 = pixel excluded
+        void MeanShiftSegmentation(cv::Mat &img, const cv::Mat &mask = cv::Mat()) const;	// Mean Shift Segmentation - mask : 0 = pixel excluded
 };
 
 #endif // DOMINANTCOLORS_H
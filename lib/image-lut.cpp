@@ -4,170 +4,217 @@
 #
 #    by AbsurdePhoton - www.absurdephoton.fr
 #
-#                v1.0 - 2022/03/09
+#                v1.1 - 2026/10/18
 #
-#   - Load 3D Cube LUT files
+#   - Load 3D Cube LUT files : whole file read at once,
+#     numbers parsed in place with std::from_chars
+#   - Tables stored as flat float arrays : one block
+#     of N*3 (1D) or N*N*N*3 (3D) values, in file order
 #   - Apply Cube LUT with opacity factor :
 #       * 1D
 #       * Nearest
-#       * Tri-linear (best)
+#       * Tri-linear
+#       * Tetrahedral (best)
+#   - Bake : LUT evaluated once for all 2^24 8-bit
+#     values, then applied with table reads only
+#   - Output colors of all entries with weights, for
+#     gamut analysis
+#   - Binary cache : compiled LUTs keyed by a hash of
+#     the .cube file contents, loaded without parsing
+#   - Apply in place by bands of rows, with an optional
+#     next stage on each band
+#   - Compose : a chain of LUTs in one 3D table
 #
 #-------------------------------------------------*/
 
 
 #include "image-lut.h"
 #include <QDebug>
+#include <charconv>
+#include <cstring>
 
 
 // .cube parser code: Adobe
 // Cube LUT Specification 1.0 https://wwwimages2.adobe.com/content/dam/acom/en/products/speedgrade/cc/pdfs/cube-lut-specification-1.0.pdf
+// The whole file is read in one block, then parsed in place : numbers are converted with std::from_chars directly in the table
 
-std::string CubeLUT::ReadLine(std::ifstream& infile, const char lineSeparator)
+static void SkipBlanks(const char *&cursor, const char *end) // spaces and tabs
+{
+    while ((cursor < end) and ((*cursor == ' ') or (*cursor == '\t')))
+        cursor++;
+}
+
+static bool NextLine(const char *&cursor, const char *end, const char *&lineBegin, const char *&lineEnd) // next line that is not empty or a comment - false at end of text
 {
-    // Skip empty lines and comments
     const char CommentMarker = '#';
-    std::string textLine;
-    while ((textLine.empty()) or (textLine[0] == CommentMarker))
-    {
-        if (infile.eof())
-        {
-            status = PrematureEndOfFile;
-            break;
-        }
-        getline(infile, textLine, lineSeparator);
-        if (infile.fail())
-        {
-            status = ReadError;
-            break;
-        }
+    while (cursor < end) {
+        lineBegin = cursor;
+        while ((cursor < end) and (*cursor != '\n') and (*cursor != '\r')) // \n, \r\n and \r line separators
+            cursor++;
+        lineEnd = cursor;
+        while ((cursor < end) and ((*cursor == '\n') or (*cursor == '\r')))
+            cursor++;
+
+        SkipBlanks(lineBegin, lineEnd);
+        if ((lineBegin < lineEnd) and (*lineBegin != CommentMarker))
+            return true;
     }
-    return textLine;
+    return false;
 }
 
-std::vector<double> CubeLUT::ParseTableRow(const std::string& lineOfText)
+template <typename T>
+static bool ParseNumber(const char *&cursor, const char *end, T &value) // number after optional blanks and sign - cursor moves after it
 {
-    int N = 3;
-    tableRow f(N);
-    std::istringstream line(lineOfText);
-    for (int i{ 0 }; i < N; ++i)
-    {
-        line >> f[i];
-        if (line.fail())
-        {
-            status = CouldNotParseTableData;
-            break;
-        }
-    }
-    return f;
+    SkipBlanks(cursor, end);
+    if ((cursor < end) and (*cursor == '+')) // from_chars doesn't accept '+'
+        cursor++;
+    const std::from_chars_result parsed = std::from_chars(cursor, end, value);
+    if (parsed.ec != std::errc())
+        return false;
+    cursor = parsed.ptr;
+    return true;
 }
 
-CubeLUT::LUTState CubeLUT::LoadCubeFile(std::ifstream& infile)
+static bool ParseTableRow(const char *cursor, const char *end, float *row) // 3 values written directly in the table
+{
+    return ParseNumber(cursor, end, row[0]) and ParseNumber(cursor, end, row[1]) and ParseNumber(cursor, end, row[2]);
+}
+
+static bool ReadWholeFile(std::ifstream& infile, std::string &text) // whole stream in memory
+{
+    infile.seekg(0, std::ios::end);
+    const std::streamoff length = infile.tellg();
+    infile.seekg(0);
+    if (length < 0)
+        return false;
+    text.assign(length, '\0');
+    infile.read(&text[0], length);
+    if (infile.bad())
+        return false;
+    text.resize(infile.gcount()); // text mode can return fewer characters than the file size
+    infile.clear();
+    return true;
+}
+
+void CubeLUT::Reset() // empty LUT with default values
 {
-    // defaults
     status = OK;
     title.clear();
     domainMin = tableRow(3, 0.0);
     domainMax = tableRow(3, 1.0);
 
+    size = 0;
     LUT1D.clear();
     LUT3D.clear();
+    ClearBake();
+}
 
-    const char NewlineCharacter = '\n';
-    char lineSeparator = NewlineCharacter;
+CubeLUT::LUTState CubeLUT::LoadCubeFile(std::ifstream& infile)
+{
+    Reset();
 
-    const char CarriageReturnCharacter = '\r';
-    for (int i{ 0 }; i < 255; ++i)
-    {
-        char inc = infile.get();
-        if (inc == NewlineCharacter)
-            break;
-        if (inc == CarriageReturnCharacter)
-        {
-            if (infile.get() == NewlineCharacter)
-                break;
-            lineSeparator = CarriageReturnCharacter;
-            //clog << "INFO: This file uses non-compliant line separator \\r (0x0D)" << endl;
-        }
-        if (i > 250)
-        {
-            status = LineError;
-            break;
-        }
+    std::string text; // whole file in memory
+    if (!ReadWholeFile(infile, text)) {
+        status = ReadError;
+        return status;
     }
-    infile.seekg(0);
-    infile.clear();
 
+    return ParseCubeText(text);
+}
+
+CubeLUT::LUTState CubeLUT::ParseCubeText(const std::string &text) // parse a whole .cube file
+{
+    Reset();
+
+    const char *cursor = text.data();
+    const char *end = cursor + text.size();
+
+    const int MaxLineLength = 250; // first line must end before this
+    const char *firstLineEnd = cursor;
+    while ((firstLineEnd < end) and (*firstLineEnd != '\n') and (*firstLineEnd != '\r'))
+        firstLineEnd++;
+    if (firstLineEnd - cursor > MaxLineLength) {
+        status = LineError;
+        return status;
+    }
+
+    // keywords
     int N, CntTitle, CntSize, CntMin, CntMax;
     N = CntTitle = CntSize = CntMin = CntMax = 0;
-    long linePos = 0;
+    const char *lineBegin = nullptr;
+    const char *lineEnd = nullptr;
     while (status == OK)
     {
-        linePos = infile.tellg();
-        std::string lineOfText = ReadLine(infile, lineSeparator);
-        if (status != OK)
+        if (!NextLine(cursor, end, lineBegin, lineEnd)) {
+            status = PrematureEndOfFile;
             break;
+        }
 
-        std::istringstream line(lineOfText);
-        std::string keyword;
-        line >> keyword;
-
-        if (("+" < keyword) and (keyword < ":")) //numbers
-        {
-            infile.seekg(linePos);
+        if (('+' < *lineBegin) and (*lineBegin < ':')) //numbers
             break;
-        }
-        else if ((keyword == "TITLE") and (CntTitle++ == 0))
+
+        const char *line = lineBegin; // after keyword
+        while ((line < lineEnd) and (*line != ' ') and (*line != '\t'))
+            line++;
+        const std::string keyword(lineBegin, line);
+        bool ok = true; // values of keyword parsed
+
+        if ((keyword == "TITLE") and (CntTitle++ == 0))
         {
             const char QUOTE = '"';
-            char startOfTitle;
-            line >> startOfTitle;
-            if (startOfTitle != QUOTE)
+            SkipBlanks(line, lineEnd);
+            if ((line >= lineEnd) or (*line != QUOTE))
             {
                 status = TitleMissingQuote;
                 break;
             }
-            getline(line, title, QUOTE);
+            const char *titleEnd = std::find(++line, lineEnd, QUOTE);
+            title.assign(line, titleEnd);
         }
         else if ((keyword == "DOMAIN_MIN") and (CntMin++ == 0))
         {
-            line >> domainMin[0] >> domainMin[1] >> domainMin[2];
+            ok = ParseNumber(line, lineEnd, domainMin[0]) and ParseNumber(line, lineEnd, domainMin[1]) and ParseNumber(line, lineEnd, domainMin[2]);
         }
         else if ((keyword == "DOMAIN_MAX") and (CntMax++ == 0))
         {
-            line >> domainMax[0] >> domainMax[1] >> domainMax[2];
+            ok = ParseNumber(line, lineEnd, domainMax[0]) and ParseNumber(line, lineEnd, domainMax[1]) and ParseNumber(line, lineEnd, domainMax[2]);
         }
         else if ((keyword == "LUT_1D_SIZE") and (CntSize++ == 0))
         {
-            line >> N;
-            if ((N < 2) or (N > 65536))
+            ok = ParseNumber(line, lineEnd, N);
+            if ((ok) and ((N < 2) or (N > 65536)))
             {
                 status = LUTSizeOutOfRange;
                 qDebug() << "LUT size out of range : " << N;
                 break;
             }
-            LUT1D = table1D(N, tableRow(3));
+            if (ok) {
+                size = N;
+                LUT1D = table(3 * size_t(N));
+            }
         }
         else if ((keyword == "LUT_3D_SIZE") and (CntSize++ == 0))
         {
-            line >> N;
-            if ((N < 2) or (N > 256))
+            ok = ParseNumber(line, lineEnd, N);
+            if ((ok) and ((N < 2) or (N > 256)))
             {
                 status = LUTSizeOutOfRange;
                 qDebug() << "LUT size out of range : " << N;
                 break;
             }
-            LUT3D = table3D(N, table2D(N, table1D(N, tableRow(3))));
+            if (ok) {
+                size = N;
+                LUT3D = table(3 * size_t(N) * N * N); // one block for the whole cube
+            }
         }
         else
         {
-            if (keyword != "") {
-                status = UnknownOrRepeatedKeyword;
-                qDebug() << "Unknown keyword : " << QString::fromStdString(keyword);
-                break;
-            }
+            status = UnknownOrRepeatedKeyword;
+            qDebug() << "Unknown keyword : " << QString::fromStdString(keyword);
+            break;
         }
 
-        if ((line.fail()) and (keyword != ""))
+        if (!ok)
         {
             status = ReadError;
             break;
@@ -183,34 +230,22 @@ CubeLUT::LUTState CubeLUT::LoadCubeFile(std::ifstream& infile)
             status = DomainBoundsReversed;
     }
 
-    // parsing loaded data
-    infile.seekg(linePos - 1);
-    while (infile.get() != '\n')
+    // parsing loaded data : lineBegin is the first data line
+    if (status == OK)
     {
-        infile.seekg(--linePos);
-    }
-    // checking if there is a beginning of the line
-
-    if (LUT1D.size() > 0)
-    {
-        N = LUT1D.size();
-        for (int i{ 0 }; (i < N) and (status == OK); ++i)
+        table &values = LUT1D.empty() ? LUT3D : LUT1D; // file order = table order : red varies fastest
+        const size_t total = values.size() / 3;
+        for (size_t i{ 0 }; i < total; ++i)
         {
-            LUT1D[i] = ParseTableRow(ReadLine(infile, lineSeparator));
-        }
-    }
-    else
-    {
-        N = LUT3D.size();
-
-        for (int b{ 0 }; (b < N) and (status == OK); ++b)
-        {
-            for (int g{ 0 }; (g < N) and (status == OK); ++g)
+            if ((i > 0) and (!NextLine(cursor, end, lineBegin, lineEnd)))
             {
-                for (int r{ 0 }; (r < N) and (status == OK); ++r)
-                {
-                    LUT3D[r][g][b] = ParseTableRow(ReadLine(infile, lineSeparator));
-                }
+                status = PrematureEndOfFile;
+                break;
+            }
+            if (!ParseTableRow(lineBegin, lineEnd, &values[3 * i]))
+            {
+                status = CouldNotParseTableData;
+                break;
             }
         }
     }
@@ -218,13 +253,156 @@ CubeLUT::LUTState CubeLUT::LoadCubeFile(std::ifstream& infile)
     return status;
 }
 
+//// binary cache
+
+// File layout, native byte order :
+//      magic "CUBELUT" + version byte
+//      dimensions (1 or 3), size, title length : 3 x int32
+//      domain min, domain max : 6 x double
+//      hash of the source .cube file, hash of the payload : 2 x uint64
+//      title characters
+//      table : size * 3 or size^3 * 3 floats
+// Loading is one read of the header and one read straight into the table : nothing is parsed
+
+static const char cacheMagic[8] = {'C', 'U', 'B', 'E', 'L', 'U', 'T', 1}; // last byte = version
+
+uint64_t CubeLUT::Hash(const void *data, const size_t &length) // FNV-1a 64-bit hash, 8 bytes at a time
+{
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    const uint64_t prime = 1099511628211ULL;
+    uint64_t hash = 14695981039346656037ULL ^ length;
+
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) { // words : hashing must stay much faster than parsing
+        uint64_t word;
+        memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 32; // high bits of the product back to the low ones
+    }
+    for (; i < length; i++) // last bytes
+        hash = (hash ^ bytes[i]) * prime;
+
+    return hash;
+}
+
+CubeLUT::LUTState CubeLUT::SaveCache(const std::string &filename, const uint64_t &sourceHash) const // write LUT in binary format
+{
+    if (status != OK)
+        return NotInitialized;
+
+    const table &values = LUT1D.empty() ? LUT3D : LUT1D;
+    const int32_t header[3] = {LUT1D.empty() ? 3 : 1, size, int32_t(title.size())};
+    const double domain[6] = {domainMin[0], domainMin[1], domainMin[2], domainMax[0], domainMax[1], domainMax[2]};
+    const uint64_t hashes[2] = {sourceHash, Hash(values.data(), values.size() * sizeof(float))};
+
+    std::ofstream outfile(filename, std::ios::binary | std::ios::trunc);
+    if (!outfile.is_open())
+        return WriteError;
+    outfile.write(cacheMagic, sizeof(cacheMagic));
+    outfile.write(reinterpret_cast<const char*>(header), sizeof(header));
+    outfile.write(reinterpret_cast<const char*>(domain), sizeof(domain));
+    outfile.write(reinterpret_cast<const char*>(hashes), sizeof(hashes));
+    outfile.write(title.data(), title.size());
+    outfile.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+    outfile.close();
+
+    return outfile.fail() ? WriteError : OK;
+}
+
+CubeLUT::LUTState CubeLUT::LoadCache(const std::string &filename, const uint64_t &sourceHash) // read LUT in binary format - sourceHash must be the one it was saved with
+{
+    Reset();
+
+    std::ifstream infile(filename, std::ios::binary);
+    if (!infile.is_open()) {
+        status = ReadError;
+        return status;
+    }
+
+    char magic[sizeof(cacheMagic)];
+    int32_t header[3];
+    double domain[6];
+    uint64_t hashes[2];
+    infile.read(magic, sizeof(magic));
+    infile.read(reinterpret_cast<char*>(header), sizeof(header));
+    infile.read(reinterpret_cast<char*>(domain), sizeof(domain));
+    infile.read(reinterpret_cast<char*>(hashes), sizeof(hashes));
+    if (infile.fail() or (memcmp(magic, cacheMagic, sizeof(cacheMagic)) != 0)) { // not a cache file, or another version
+        status = CacheCorrupted;
+        return status;
+    }
+    if (hashes[0] != sourceHash) { // made from another .cube file
+        status = CacheMismatch;
+        return status;
+    }
+
+    const int dimensions = header[0];
+    const int N = header[1];
+    const int titleLength = header[2];
+    if (((dimensions != 1) and (dimensions != 3)) or (N < 2) or (N > ((dimensions == 1) ? 65536 : 256)) or (titleLength < 0) or (titleLength > 65536)) {
+        status = CacheCorrupted;
+        return status;
+    }
+
+    title.resize(titleLength);
+    infile.read(&title[0], titleLength);
+
+    size = N;
+    table &values = (dimensions == 1) ? LUT1D : LUT3D;
+    values.resize((dimensions == 1) ? 3 * size_t(N) : 3 * size_t(N) * N * N);
+    infile.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(float)); // whole table in one read
+    if (infile.fail() or (Hash(values.data(), values.size() * sizeof(float)) != hashes[1])) { // truncated or damaged
+        Reset();
+        status = CacheCorrupted;
+        return status;
+    }
+
+    domainMin = tableRow(domain, domain + 3);
+    domainMax = tableRow(domain + 3, domain + 6);
+
+    return status;
+}
+
+CubeLUT::LUTState CubeLUT::LoadCubeFileCached(const std::string &filename, const std::string &cacheDir) // load .cube file, through a binary cache keyed by the file contents
+{
+    Reset();
+
+    std::ifstream infile(filename, std::ios::binary);
+    if (!infile.is_open()) {
+        status = ReadError;
+        return status;
+    }
+    std::string text; // whole file, needed for the hash anyway
+    if (!ReadWholeFile(infile, text)) {
+        status = ReadError;
+        return status;
+    }
+    infile.close();
+
+    const uint64_t sourceHash = Hash(text.data(), text.size());
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.lutc", (unsigned long long)sourceHash);
+    const std::string cacheFile = cacheDir + "/" + name; // same contents = same cache file, wherever the .cube is
+
+    if (LoadCache(cacheFile, sourceHash) == OK) // already compiled
+        return status;
+
+    if (ParseCubeText(text) != OK) // first time : parse text...
+        return status;
+
+    if (SaveCache(cacheFile, sourceHash) != OK) // ... and compile it for next time - the LUT is loaded anyway
+        qDebug() << "Could not write LUT cache : " << QString::fromStdString(cacheFile);
+
+    return status;
+}
+
 //// apply 1D
 double CubeLUT::getAvgVal(int nValues, const unsigned char value, const unsigned char channel)
 {
     double val = 0;
 
     for (unsigned int i = 0; i < (unsigned int)nValues; ++i) {
-        val += LUT1D[value * nValues + i][channel];
+        val += Entry1D(value * nValues + i)[channel];
     }
 
     return val / nValues;
@@ -239,156 +417,372 @@ unsigned char CubeLUT::getColor(const double value)
     return static_cast<unsigned char>(round(value * 255.0));
 }
 
-cv::Mat_<cv::Vec3b> CubeLUT::applyBasic1D(const cv::Mat& img, const double opacity)
+static inline unsigned char blendToByte(const float &source, const float &lut, const float &opacity) // mix original and LUT value, back to 8 bits
 {
-    int total = img.cols * img.rows;
-    cv::Mat result = img.clone();
-    cv::Vec3b* resultP = result.ptr<cv::Vec3b>(0);
+    const float value = (source + (lut - source) * opacity) * 255.0f + 0.5f;
+    return static_cast<unsigned char>(std::min(std::max(value, 0.0f), 255.0f));
+}
 
-#pragma omp parallel for
+void CubeLUT::applyBasic1D(cv::Vec3b *pixels, const int &total, const float &opacity) const // each channel through its own curve
+{
     for (int n = 0; n < total; n++) {
-        double b = resultP[n][0] / 255.0;
-        double g = resultP[n][1] / 255.0;
-        double r = resultP[n][2] / 255.0;
+        for (int c = 0; c < 3; c++) { // BGR pixel, RGB table
+            const float value = pixels[n][c] / 255.0f;
+            const float position = value * (size - 1); // position in table
+            const int i0 = std::min(int(position), size - 2); // first entry of the segment
+            const float delta = position - i0;
 
-        double r_o = r * (LUT1D.size() - 1);
-        double g_o = g * (LUT1D.size() - 1);
-        double b_o = b * (LUT1D.size() - 1);
+            const float *lut0 = Entry1D(i0);
+            const float *lut1 = Entry1D(i0 + 1);
+            const float curve = lut0[2 - c] + (lut1[2 - c] - lut0[2 - c]) * delta;
 
-        double R1 = ceil(r_o);
-        double R0 = floor(r_o);
-        double G1 = ceil(g_o);
-        double G0 = floor(g_o);
-        double B1 = ceil(b_o);
-        double B0 = floor(b_o);
+            pixels[n][c] = blendToByte(value, curve, opacity);
+        }
+    }
+}
 
-        double delta_r { r_o - R0 == 0 || R1 - R0 == 0 ? 0.000000001 : (r_o - R0) / (R1 - R0) };
-        double delta_g { g_o - G0 == 0 || G1 - G0 == 0 ? 0.000000001 : (g_o - G0) / (G1 - G0) };
-        double delta_b { b_o - B0 == 0 || B1 - B0 == 0 ? 0.000000001 : (b_o - B0) / (B1 - B0) };
+//// apply tri-linear and tetrahedral
 
-        double new_r = LUT1D[R0][0] + (LUT1D[R1][0] - LUT1D[R0][0]) * delta_r;
-        double new_g = LUT1D[R0][1] + (LUT1D[R1][1] - LUT1D[R0][1]) * delta_g;
-        double new_b = LUT1D[R0][2] + (LUT1D[R1][2] - LUT1D[R0][2]) * delta_b;
+// Both kernels only use the flat table and a few locals : no allocation per pixel.
+// Pixels are independent and the loops have no function calls, so with -march=native
+// the compiler vectorizes them (one pixel per lane, gathers for the table reads).
 
-        resultP[n][0] = (b + (new_b - b) * opacity) * 255.0;
-        resultP[n][1] = (g + (new_g - g) * opacity) * 255.0;
-        resultP[n][2] = (r + (new_r - r) * opacity) * 255.0;
+void CubeLUT::axisCoordinates(int *index, float *fraction) const // cell and position in cell along one axis for each 8-bit value
+{
+    for (int v = 0; v < 256; v++) {
+        const float position = v * (size - 1) / 255.0f; // position in table
+        index[v] = std::min(int(position), size - 2); // first entry of the cell - the last value is at the end of the last cell
+        fraction[v] = position - index[v]; // in [0..1]
     }
+}
+
+static inline float TrilinearValue(const float *c000, const int &sr, const int &sg, const int &sb,
+                                   const float &dr, const float &dg, const float &db) // one channel from the 8 corners of the cell
+{
+    const float vr_gz_bz = c000[0]                + (c000[sr]                - c000[0])                * dr;
+    const float vr_go_bz = c000[sg]               + (c000[sg + sr]           - c000[sg])               * dr;
+    const float vr_gz_bo = c000[sb]               + (c000[sb + sr]           - c000[sb])               * dr;
+    const float vr_go_bo = c000[sb + sg]          + (c000[sb + sg + sr]      - c000[sb + sg])          * dr;
+
+    const float vrg_b0 = vr_gz_bz + (vr_go_bz - vr_gz_bz) * dg;
+    const float vrg_b1 = vr_gz_bo + (vr_go_bo - vr_gz_bo) * dg;
+
+    return vrg_b0 + (vrg_b1 - vrg_b0) * db;
+}
 
-    return result;
+static inline void TetrahedralCorners(const float &dr, const float &dg, const float &db, const int &sr, const int &sg, const int &sb,
+                                      int &first, int &second, float *w) // tetrahedron of the cell containing the color : offsets of the 2 middle corners and weights of the 4 corners
+{
+    // the cell is cut in 6 tetrahedra along its diagonal : the order of the 3 fractions gives the tetrahedron
+    // path from corner 000 to corner 111 : first along the axis of the biggest fraction, then the middle one
+    if (dr > dg) {
+        if (dg > db) { // r > g > b
+            first = sr; second = sr + sg;
+            w[0] = 1.0f - dr; w[1] = dr - dg; w[2] = dg - db; w[3] = db;
+        }
+        else if (dr > db) { // r > b >= g
+            first = sr; second = sr + sb;
+            w[0] = 1.0f - dr; w[1] = dr - db; w[2] = db - dg; w[3] = dg;
+        }
+        else { // b >= r > g
+            first = sb; second = sr + sb;
+            w[0] = 1.0f - db; w[1] = db - dr; w[2] = dr - dg; w[3] = dg;
+        }
+    }
+    else {
+        if (db > dg) { // b > g >= r
+            first = sb; second = sg + sb;
+            w[0] = 1.0f - db; w[1] = db - dg; w[2] = dg - dr; w[3] = dr;
+        }
+        else if (db > dr) { // g >= b > r
+            first = sg; second = sg + sb;
+            w[0] = 1.0f - dg; w[1] = dg - db; w[2] = db - dr; w[3] = dr;
+        }
+        else { // g >= r >= b
+            first = sg; second = sr + sg;
+            w[0] = 1.0f - dg; w[1] = dg - dr; w[2] = dr - db; w[3] = db;
+        }
+    }
 }
 
-//// apply tri-linear
-std::vector<double> CubeLUT::mul(const std::vector<double> &vec, const double val)
+void CubeLUT::applyTrilinear(cv::Vec3b *pixels, const int &total, const float &opacity, const int *index, const float *fraction) const
 {
-    std::vector<double> newVec(3, 0.0f);
-    for (int i = 0; i < 3; ++i)
-        newVec[i] = vec[i] * val;
+    const int sr = 3; // strides of each axis in the flat table
+    const int sg = 3 * size;
+    const int sb = 3 * size * size;
+    const float *lut = LUT3D.data();
 
-    return newVec;
+#pragma omp simd
+    for (int n = 0; n < total; n++) {
+        const int B = pixels[n][0];
+        const int G = pixels[n][1];
+        const int R = pixels[n][2];
+
+        const float dr = fraction[R];
+        const float dg = fraction[G];
+        const float db = fraction[B];
+        const float *c000 = lut + index[R] * sr + index[G] * sg + index[B] * sb; // first corner of the cell
+
+        pixels[n][0] = blendToByte(B / 255.0f, TrilinearValue(c000 + 2, sr, sg, sb, dr, dg, db), opacity);
+        pixels[n][1] = blendToByte(G / 255.0f, TrilinearValue(c000 + 1, sr, sg, sb, dr, dg, db), opacity);
+        pixels[n][2] = blendToByte(R / 255.0f, TrilinearValue(c000, sr, sg, sb, dr, dg, db), opacity);
+    }
 }
 
-std::vector<double> CubeLUT::sum(const std::vector<double> &a, const std::vector<double> &b)
+void CubeLUT::applyTetrahedral(cv::Vec3b *pixels, const int &total, const float &opacity, const int *index, const float *fraction) const // 4 corners instead of 8 : faster, and keeps the neutral axis exact
 {
-    std::vector<double> newVec(3, 0.0f);
-    for (int i = 0; i < 3; ++i)
-        newVec[i] = a[i] + b[i];
+    const int sr = 3; // strides of each axis in the flat table
+    const int sg = 3 * size;
+    const int sb = 3 * size * size;
+    const int last = sr + sg + sb; // corner 111
+    const float *lut = LUT3D.data();
 
-    return newVec;
+#pragma omp simd
+    for (int n = 0; n < total; n++) {
+        const int B = pixels[n][0];
+        const int G = pixels[n][1];
+        const int R = pixels[n][2];
+
+        const float dr = fraction[R];
+        const float dg = fraction[G];
+        const float db = fraction[B];
+        const float *c000 = lut + index[R] * sr + index[G] * sg + index[B] * sb; // first corner of the cell
+
+        int first, second; // offsets of the 2 corners between 000 and 111
+        float w[4]; // weights of the 4 corners
+        TetrahedralCorners(dr, dg, db, sr, sg, sb, first, second, w);
+
+        float vrgb[3]; // interpolated color
+        for (int c = 0; c < 3; c++)
+            vrgb[c] = c000[c] * w[0] + c000[c + first] * w[1] + c000[c + second] * w[2] + c000[c + last] * w[3];
+
+        pixels[n][0] = blendToByte(B / 255.0f, vrgb[2], opacity);
+        pixels[n][1] = blendToByte(G / 255.0f, vrgb[1], opacity);
+        pixels[n][2] = blendToByte(R / 255.0f, vrgb[0], opacity);
+    }
+}
+
+//// apply nearest value
+void CubeLUT::applyNearest(cv::Vec3b *pixels, const int &total, const float &opacity) const
+{
+    for (int n = 0; n < total; n++) {
+            unsigned int b_ind = round(pixels[n][0] * (size - 1) / 255.0f);
+            unsigned int g_ind = round(pixels[n][1] * (size - 1) / 255.0f);
+            unsigned int r_ind = round(pixels[n][2] * (size - 1) / 255.0f);
+
+            const float *lut = Entry3D(r_ind, g_ind, b_ind);
+            pixels[n][0] = blendToByte(pixels[n][0] / 255.0f, lut[2], opacity);
+            pixels[n][1] = blendToByte(pixels[n][1] / 255.0f, lut[1], opacity);
+            pixels[n][2] = blendToByte(pixels[n][2] / 255.0f, lut[0], opacity);
+    }
 }
 
-cv::Mat CubeLUT::applyTrilinear(cv::Mat img, const double opacity)
+//// output colors
+void CubeLUT::OutputColors(std::vector<cv::Vec3d> &colors, std::vector<double> &weights, const LUTWeighting weighting) const // RGB output of each table entry in [0..1] with its weight
 {
-    int total = img.cols * img.rows;
-    cv::Mat result = img.clone();
-    cv::Vec3b* resultP = result.ptr<cv::Vec3b>(0);
+    const table &values = LUT1D.empty() ? LUT3D : LUT1D;
+    const int total = values.size() / 3;
+    const int dimensions = LUT1D.empty() ? 3 : 1;
+
+    colors.resize(total);
+    weights.resize(total);
 
 #pragma omp parallel for
     for (int n = 0; n < total; n++) {
-        double b = resultP[n][0] / 255.0;
-        double g = resultP[n][1] / 255.0;
-        double r = resultP[n][2] / 255.0;
+        for (int c = 0; c < 3; c++)
+            colors[n][c] = std::min(std::max(double(values[3 * size_t(n) + c]), 0.0), 1.0); // values out of range are clipped
+
+        double weight = 1.0;
+        if (weighting == WeightInputVolume) { // trapezoidal rule : entries on the borders of the domain only have half of their cell inside
+            int index = n;
+            for (int d = 0; d < dimensions; d++) { // r, g then b coordinate
+                const int i = index % size;
+                if ((i == 0) or (i == size - 1))
+                    weight *= 0.5;
+                index /= size;
+            }
+        }
+        weights[n] = weight;
+    }
+}
 
-        double r_o = r * (LUT3D[0].size() - 1);
-        double g_o = g * (LUT3D[1].size() - 1);
-        double b_o = b * (LUT3D[2].size() - 1);
+//// apply baked table
+bool CubeLUT::Bake(const LUTMode mode) // evaluate the LUT for all 2^24 8-bit RGB values
+{
+    ClearBake();
+    if (status != OK)
+        return false;
 
-        double R1 = ceil(r_o);
-        double R0 = floor(r_o);
-        double G1 = ceil(g_o);
-        double G0 = floor(g_o);
-        double B1 = ceil(b_o);
-        double B0 = floor(b_o);
+    cv::Mat all = cv::Mat(4096, 4096, CV_8UC3); // every RGB value once, at index 0xRRGGBB
+    cv::Vec3b* allP = all.ptr<cv::Vec3b>(0);
+#pragma omp parallel for
+    for (int n = 0; n < (1 << 24); n++)
+        allP[n] = cv::Vec3b(n & 0xff, (n >> 8) & 0xff, n >> 16); // 0xRRGGBB -> BGR
 
-        double delta_r { r_o - R0 == 0 || R1 - R0 == 0 ? 0.000000001 : (r_o - R0) / (R1 - R0) };
-        double delta_g { g_o - G0 == 0 || G1 - G0 == 0 ? 0.000000001 : (g_o - G0) / (G1 - G0) };
-        double delta_b { b_o - B0 == 0 || B1 - B0 == 0 ? 0.000000001 : (b_o - B0) / (B1 - B0) };
+    ApplyLUTTiles(all, 1.0, mode); // full LUT effect : opacity is applied when the table is read
+    baked = all;
+    bakedMode = mode;
 
-        std::vector<double> vr_gz_bz = sum(mul(LUT3D[R0][G0][B0], 1.0 - delta_r), mul(LUT3D[R1][G0][B0], delta_r));
-        std::vector<double> vr_gz_bo = sum(mul(LUT3D[R0][G0][B1], 1.0 - delta_r), mul(LUT3D[R1][G0][B1], delta_r));
-        std::vector<double> vr_go_bz = sum(mul(LUT3D[R0][G1][B0], 1.0 - delta_r), mul(LUT3D[R1][G1][B0], delta_r));
-        std::vector<double> vr_go_bo = sum(mul(LUT3D[R0][G1][B1], 1.0 - delta_r), mul(LUT3D[R1][G1][B1], delta_r));
+    return true;
+}
 
-        std::vector<double> vrg_b0 = sum(mul(vr_gz_bz, 1.0 - delta_g), mul(vr_go_bz, delta_g));
-        std::vector<double> vrg_b1 = sum(mul(vr_gz_bo, 1.0 - delta_g), mul(vr_go_bo, delta_g));
+void CubeLUT::ClearBake() // free the baked table
+{
+    baked.release();
+}
 
-        std::vector<double> vrgb = sum(mul(vrg_b0, 1.0 - delta_b), mul(vrg_b1, delta_b));
+void CubeLUT::applyBaked(cv::Vec3b *pixels, const int &total, const float &opacity) const // one table read per pixel
+{
+    const cv::Vec3b* bakedP = baked.ptr<cv::Vec3b>(0);
 
-        resultP[n][0] = (b + (vrgb[2] - b) * opacity) * 255.0;
-        resultP[n][1] = (g + (vrgb[1] - g) * opacity) * 255.0;
-        resultP[n][2] = (r + (vrgb[0] - r) * opacity) * 255.0;
+    if (opacity == 1.0f) { // no blending
+        for (int n = 0; n < total; n++)
+            pixels[n] = bakedP[(pixels[n][2] << 16) | (pixels[n][1] << 8) | pixels[n][0]];
+    }
+    else {
+        for (int n = 0; n < total; n++) {
+            const cv::Vec3b source = pixels[n];
+            const cv::Vec3b lut = bakedP[(source[2] << 16) | (source[1] << 8) | source[0]];
+            for (int c = 0; c < 3; c++) // between source and LUT value : always positive
+                pixels[n][c] = static_cast<unsigned char>(source[c] + (lut[c] - source[c]) * opacity + 0.5f);
+        }
     }
-
-    return result;
 }
 
-//// apply nearest value
-cv::Mat CubeLUT::applyNearest(cv::Mat img, const double opacity)
+//// evaluate and compose
+void CubeLUT::Evaluate(const float *rgb, float *result, const LUTMode mode) const // LUT value of one RGB color in [0..1] - no 8-bit rounding
 {
-    int total = img.cols * img.rows;
-    cv::Mat result = img.clone();
-    cv::Vec3b* resultP = result.ptr<cv::Vec3b>(0);
+    float position[3]; // position in table of each channel
+    int i0[3]; // first entry of segment or cell
+    float delta[3]; // position in segment or cell
+    for (int c = 0; c < 3; c++) {
+        position[c] = std::min(std::max(rgb[c], 0.0f), 1.0f) * (size - 1);
+        i0[c] = std::min(int(position[c]), size - 2);
+        delta[c] = position[c] - i0[c];
+    }
 
-#pragma omp parallel for
-    for (int n = 0; n < total; n++) {
-            unsigned int b_ind = round(resultP[n][0] * (LUT3D.size() - 1) / 255.0f);
-            unsigned int g_ind = round(resultP[n][1] * (LUT3D.size() - 1) / 255.0f);
-            unsigned int r_ind = round(resultP[n][2] * (LUT3D.size() - 1) / 255.0f);
+    if (!LUT1D.empty()) { // each channel through its own curve
+        for (int c = 0; c < 3; c++)
+            result[c] = Entry1D(i0[c])[c] + (Entry1D(i0[c] + 1)[c] - Entry1D(i0[c])[c]) * delta[c];
+        return;
+    }
 
-            int newB = (int)(LUT3D[r_ind][g_ind][b_ind][2] * 255);
-            int newG = (int)(LUT3D[r_ind][g_ind][b_ind][1] * 255);
-            int newR = (int)(LUT3D[r_ind][g_ind][b_ind][0] * 255);
+    if (mode == Nearest) {
+        const float *lut = Entry3D(int(round(position[0])), int(round(position[1])), int(round(position[2])));
+        std::copy(lut, lut + 3, result);
+        return;
+    }
 
-            unsigned char finalB = resultP[n][0] + (newB - resultP[n][0]) * opacity;
-            unsigned char finalG = resultP[n][1] + (newG - resultP[n][1]) * opacity;
-            unsigned char finalR = resultP[n][2] + (newR - resultP[n][2]) * opacity;
+    const int sr = 3; // strides of each axis in the flat table
+    const int sg = 3 * size;
+    const int sb = 3 * size * size;
+    const float *c000 = Entry3D(i0[0], i0[1], i0[2]); // first corner of the cell
+
+    if (mode == Tetrahedral) {
+        int first, second;
+        float w[4];
+        TetrahedralCorners(delta[0], delta[1], delta[2], sr, sg, sb, first, second, w);
+        for (int c = 0; c < 3; c++)
+            result[c] = c000[c] * w[0] + c000[c + first] * w[1] + c000[c + second] * w[2] + c000[c + sr + sg + sb] * w[3];
+    }
+    else
+        for (int c = 0; c < 3; c++)
+            result[c] = TrilinearValue(c000 + c, sr, sg, sb, delta[0], delta[1], delta[2]);
+}
 
-            resultP[n][0] = finalB;
-            resultP[n][1] = finalG;
-            resultP[n][2] = finalR;
+CubeLUT CubeLUT::Compose(const std::vector<const CubeLUT*> &chain, const LUTMode mode, const int &composedSize) // one 3D LUT with the effect of all LUTs of chain, applied in order
+{
+    CubeLUT composed;
+    if (chain.empty())
+        return composed; // not initialized
+
+    int N = composedSize; // size of the result : same precision as the biggest 3D LUT
+    for (const CubeLUT *lut : chain) {
+        if (lut->status != OK)
+            return composed;
+        if ((composedSize == 0) and (!lut->LUT3D.empty()))
+            N = std::max(N, lut->size);
+        if (!composed.title.empty())
+            composed.title += " + ";
+        composed.title += lut->title;
     }
+    if ((composedSize == 0) or (N < 2)) // at least 33 entries per axis : on a coarse grid the interpolation errors of each stage add up
+        N = std::max(N, 33);
+    N = std::min(N, 256);
+
+    composed.status = OK;
+    composed.size = N;
+    composed.LUT3D = table(3 * size_t(N) * N * N);
 
-    return result;
+    const int total = N * N * N;
+#pragma omp parallel for
+    for (int n = 0; n < total; n++) {
+        float color[3] = {float(n % N) / (N - 1), float((n / N) % N) / (N - 1), float(n / (N * N)) / (N - 1)}; // input of entry n, red varies fastest
+        for (const CubeLUT *lut : chain) { // each LUT output is the input of the next one
+            float next[3];
+            lut->Evaluate(color, next, mode);
+            std::copy(next, next + 3, color);
+        }
+        std::copy(color, color + 3, &composed.LUT3D[3 * size_t(n)]);
+    }
+
+    return composed;
 }
 
 //// Apply
 cv::Mat_<cv::Vec3b> CubeLUT::ApplyLUT(const cv::Mat image, double opacity, LUTMode mode)
 {
     if (status == OK) {
-        cv::Mat result;
-
-        if (!LUT1D.empty()) {
-            result = applyBasic1D(image, opacity);
-        }
-        else if (!LUT3D.empty()) {
-            if (mode == Trilinear)
-                result = applyTrilinear(image, opacity);
-            else
-                result = applyNearest(image, opacity);
-        }
+        cv::Mat result = image.clone();
+        ApplyLUTTiles(result, opacity, mode);
 
         return result;
     }
     else
         return cv::Mat();
 }
+
+bool CubeLUT::ApplyLUTTiles(cv::Mat &image, const double opacity, const LUTMode mode, const std::function<void(cv::Mat &tile, const int &firstRow)> &next) const // apply LUT in place, by bands of rows processed in parallel
+{
+    if ((status != OK) or (image.empty()) or (image.type() != CV_8UC3))
+        return false;
+
+    int index[256]; // same coordinates for the 3 axes
+    float fraction[256];
+    if (!LUT3D.empty())
+        axisCoordinates(index, fraction);
+
+    const int tilePixels = 65536; // a band and its next stage stay in cache
+    const int tileRows = std::max(1, tilePixels / image.cols);
+    const int nbTiles = (image.rows + tileRows - 1) / tileRows;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int t = 0; t < nbTiles; t++) {
+        cv::Mat tile = image.rowRange(t * tileRows, std::min(image.rows, (t + 1) * tileRows)); // no copy
+
+        if (tile.isContinuous()) // whole band at once...
+            applyPixels(tile.ptr<cv::Vec3b>(0), tile.rows * tile.cols, opacity, mode, index, fraction);
+        else // ... or row by row
+            for (int y = 0; y < tile.rows; y++)
+                applyPixels(tile.ptr<cv::Vec3b>(y), tile.cols, opacity, mode, index, fraction);
+
+        if (next) // next stage while the band is in cache
+            next(tile, t * tileRows);
+    }
+
+    return true;
+}
+
+void CubeLUT::applyPixels(cv::Vec3b *pixels, const int &total, const float &opacity, const LUTMode &mode, const int *index, const float *fraction) const // apply LUT to consecutive pixels with the best kernel
+{
+    if ((!baked.empty()) and ((bakedMode == mode) or (!LUT1D.empty()))) // baked table : 1D LUTs have only one mode
+        applyBaked(pixels, total, opacity);
+    else if (!LUT1D.empty())
+        applyBasic1D(pixels, total, opacity);
+    else if (mode == Tetrahedral)
+        applyTetrahedral(pixels, total, opacity, index, fraction);
+    else if (mode == Trilinear)
+        applyTrilinear(pixels, total, opacity, index, fraction);
+    else
+        applyNearest(pixels, total, opacity);
+}
@@ -4,13 +4,26 @@
 #
 #    by AbsurdePhoton - www.absurdephoton.fr
 #
-#                v1.0 - 2022/03/09
+#                v1.1 - 2026/10/18
 #
-#   - Load 3D Cube LUT files
+#   - Load 3D Cube LUT files : whole file read at once,
+#     numbers parsed in place with std::from_chars
+#   - Tables stored as flat float arrays : one block
+#     of N*3 (1D) or N*N*N*3 (3D) values, in file order
 #   - Apply Cube LUT with opacity factor :
 #       * 1D
 #       * Nearest
-#       * Tri-linear (best)
+#       * Tri-linear
+#       * Tetrahedral (best)
+#   - Bake : LUT evaluated once for all 2^24 8-bit
+#     values, then applied with table reads only
+#   - Output colors of all entries with weights, for
+#     gamut analysis
+#   - Binary cache : compiled LUTs keyed by a hash of
+#     the .cube file contents, loaded without parsing
+#   - Apply in place by bands of rows, with an optional
+#     next stage on each band
+#   - Compose : a chain of LUTs in one 3D table
 #
 #-------------------------------------------------*/
 
@@ -20,15 +33,15 @@
 #include "opencv2/opencv.hpp"
 
 #include <fstream>
+#include <cstdint>
+#include <functional>
 
 
 class CubeLUT
 {
 public:
         using tableRow = std::vector<double>;
-        using table1D = std::vector<tableRow>;
-        using table2D = std::vector<table1D>;
-        using table3D = std::vector<table2D>;
+        using table = std::vector<float>; // contiguous RGB triplets
 
         enum LUTState {
             OK = 0,
@@ -41,44 +54,83 @@ public:
             TitleMissingQuote,
             DomainBoundsReversed,
             LUTSizeOutOfRange,
-            CouldNotParseTableData
+            CouldNotParseTableData,
+            CacheMismatch = 30,
+            CacheCorrupted
+        };
+
+        enum LUTWeighting {
+            WeightUniform = 0, // all entries count the same
+            WeightInputVolume = 1 // volume of input colors around each entry : half on faces, quarter on edges, eighth on corners
         };
 
         enum LUTMode {
             Trilinear = 0,
-            Nearest = 1
+            Nearest = 1,
+            Tetrahedral = 2
         };
 
         LUTState status;
         std::string title;
         tableRow domainMin;
         tableRow domainMax;
-        table1D LUT1D;
-        table3D LUT3D;
+        int size; // entries per axis
+        table LUT1D; // size * 3 values
+        table LUT3D; // size^3 * 3 values - red varies fastest, then green, then blue
 
         CubeLUT()
         {
                 status = NotInitialized;
+                size = 0;
+                bakedMode = Trilinear;
         }
 
+        size_t Index1D(const int &i) const { return 3 * size_t(i); } // first value of entry i
+        size_t Index3D(const int &r, const int &g, const int &b) const { return 3 * ((size_t(b) * size + g) * size + r); } // first value of entry (r,g,b)
+        const float* Entry1D(const int &i) const { return &LUT1D[Index1D(i)]; } // RGB values of entry i
+        const float* Entry3D(const int &r, const int &g, const int &b) const { return &LUT3D[Index3D(r, g, b)]; } // RGB values of entry (r,g,b)
+
         LUTState LoadCubeFile(std::ifstream& infile);
+        LUTState LoadCubeFileCached(const std::string &filename, const std::string &cacheDir); // load .cube file through a binary cache in cacheDir - cache file is written the first time
+
+        LUTState SaveCache(const std::string &filename, const uint64_t &sourceHash) const; // write LUT in binary format
+        LUTState LoadCache(const std::string &filename, const uint64_t &sourceHash); // read LUT in binary format - CacheMismatch if it wasn't made from this source
+        static uint64_t Hash(const void *data, const size_t &length); // FNV-1a style 64-bit hash of .cube file contents
 
-        cv::Mat_<cv::Vec3b> ApplyLUT(const cv::Mat image, double opacity, LUTMode mode);
+        cv::Mat_<cv::Vec3b> ApplyLUT(const cv::Mat image, double opacity, LUTMode mode); // uses the baked table if it was baked with this mode
+        bool ApplyLUTTiles(cv::Mat &image, const double opacity, const LUTMode mode,
+                           const std::function<void(cv::Mat &tile, const int &firstRow)> &next = nullptr) const; // apply LUT in place by bands of rows, in parallel - next is called on each band with its first row while it is still in cache
+
+        void Evaluate(const float *rgb, float *result, const LUTMode mode) const; // LUT value of one RGB color in [0..1], without 8-bit rounding
+        static CubeLUT Compose(const std::vector<const CubeLUT*> &chain, const LUTMode mode, const int &composedSize = 0); // one 3D LUT with the effect of all LUTs of chain, applied in order - size 0 = biggest 3D size in chain, at least 33
+
+        void OutputColors(std::vector<cv::Vec3d> &colors, std::vector<double> &weights, LUTWeighting weighting) const; // RGB output of each table entry in [0..1] with its weight
+
+        bool Bake(LUTMode mode); // evaluate the LUT for all 2^24 8-bit RGB values (48 MB) - for a LUT applied to many images
+        void ClearBake(); // free the baked table
+        bool IsBaked() const { return !baked.empty(); } // baked table ready
 
 private:
-        std::string ReadLine(std::ifstream& infile, char lineSeparator);
-        tableRow ParseTableRow(const std::string& lineOfText);
+        cv::Mat baked; // 4096x4096 BGR image : LUT result of RGB value 0xRRGGBB at index 0xRRGGBB
+        LUTMode bakedMode; // interpolation used for the baked table
+
+        void Reset(); // empty LUT with default values
+        LUTState ParseCubeText(const std::string &text); // parse a whole .cube file
 
+        //// kernels : in place on consecutive BGR pixels, no allocation
+        void applyPixels(cv::Vec3b *pixels, const int &total, const float &opacity, const LUTMode &mode, const int *index, const float *fraction) const; // best kernel for this LUT and mode
+        //// for baked table
+        void applyBaked(cv::Vec3b *pixels, const int &total, const float &opacity) const;
         //// for 1D
         double getAvgVal(int nValues, unsigned char value, unsigned char channel);
         unsigned char getColor(double value);
-        cv::Mat_<cv::Vec3b> applyBasic1D(const cv::Mat& img, double opacity);
-        //// for tri-linear
-        std::vector<double> mul(const std::vector<double>& vec, const double val);
-        std::vector<double> sum(const std::vector<double>& a, const std::vector<double>& b);
-        cv::Mat applyTrilinear(cv::Mat img, double opacity);
+        void applyBasic1D(cv::Vec3b *pixels, const int &total, const float &opacity) const;
+        //// for tri-linear and tetrahedral
+        void axisCoordinates(int *index, float *fraction) const; // cell and position in cell along one axis for each 8-bit value
+        void applyTrilinear(cv::Vec3b *pixels, const int &total, const float &opacity, const int *index, const float *fraction) const;
+        void applyTetrahedral(cv::Vec3b *pixels, const int &total, const float &opacity, const int *index, const float *fraction) const;
         //// for nearest
-        cv::Mat applyNearest(cv::Mat img, double opacity);
+        void applyNearest(cv::Vec3b *pixels, const int &total, const float &opacity) const;
 };
 
 #endif
@@ -4,7 +4,7 @@
 #
 #    by AbsurdePhoton - www.absurdephoton.fr
 #
-#                v2.0 - 2022/12/12
+#                v2.1 - 2026/10/18
 #
 #   - Utilities :
 #       * Range values utils for int and uchar
@@ -21,6 +21,8 @@
 #   - Image analysis, get :
 #       * Sobel gradients
 #       * Gray histogram (option with mask)
+#       * 24-bit RGB histogram, presence bitset and
+#         unique colors
 #       * Color mean using histograms
 #       * Color palette
 #       * Reflectance and Illumination
@@ -31,6 +33,8 @@
 
 #include "image-utils.h"
 
+static const size_t rgb24SparseLimit = 65536; // below this number of pixels, 24-bit RGB values are sorted instead of using 2^24 tables
+
 
 ///////////////////////////////////////////////////////////
 //// General
@@ -51,14 +55,15 @@ int GetByteInRange(const int &byte) // get a byte in range [0..255]
 //// Utils
 ///////////////////////////////////////////////////////////
 
-int CountRGBUniqueValues(const cv::Mat &source) // count number of RGB colors in BGR non-alpha image
+int CountRGBUniqueValues(const cv::Mat &source, const cv::Mat &mask) // count number of RGB colors in BGR non-alpha image - only pixels where 8-bit mask is not 0
 {
-    std::set<int> unique;
-
-    for (cv::Vec3b &p : cv::Mat_<cv::Vec3b>(source)) // iterate over pixels (assummes CV_8UC3 !)
-        unique.insert((p[2] << 16) | (p[1] << 8) | (p[0])); // "hash" representation of the pixel
+    std::vector<int> colors;
+    if (source.total() < rgb24SparseLimit) { // small image : sort its few values, no 2 MB bitset
+        UniqueColorsImageRGB24(source, colors, mask);
+        return colors.size();
+    }
 
-    return unique.size();
+    return CountPresenceRGB24(PresenceImageRGB24(source, mask)); // 2^24 bitset, no list of colors needed
 }
 
 cv::Mat NormalizeImage(const cv::Mat & source) // normalize [0..255] image to [0..1] - returns a CV_64F image
@@ -649,6 +654,139 @@ std::vector<double> HistogramImageGrayWithMask(const cv::Mat &source, const cv::
     return histogram;
 }
 
+std::vector<int> HistogramImageRGB24(const cv::Mat &source, const cv::Mat &mask) // count occurences of each 24-bit RGB value (index 0xRRGGBB) in BGR image - 2^24 values
+{
+    std::vector<int> histogram(1 << 24, 0); // all possible RGB values - 64 MB, too big for one copy per thread
+
+    #pragma omp parallel for
+    for (int y = 0; y < source.rows; y++) { // rows may not be continuous
+        const cv::Vec3b* sourceP = source.ptr<cv::Vec3b>(y);
+        const uchar* maskP = mask.empty() ? nullptr : mask.ptr<uchar>(y);
+        int runValue = -1; // same consecutive values are counted locally : flat areas need one atomic add per run, not per pixel
+        int runCount = 0;
+        for (int x = 0; x < source.cols; x++) {
+            if ((maskP) and (maskP[x] == 0)) // excluded pixel
+                continue;
+            const int value = (sourceP[x][2] << 16) | (sourceP[x][1] << 8) | sourceP[x][0]; // BGR -> 0xRRGGBB
+            if (value != runValue) { // end of run
+                if (runCount > 0) {
+                    #pragma omp atomic
+                    histogram[runValue] += runCount;
+                }
+                runValue = value;
+                runCount = 0;
+            }
+            runCount++;
+        }
+        if (runCount > 0) { // last run of the row
+            #pragma omp atomic
+            histogram[runValue] += runCount;
+        }
+    }
+
+    return histogram;
+}
+
+std::vector<uint64_t> PresenceImageRGB24(const cv::Mat &source, const cv::Mat &mask) // bitset of 24-bit RGB values present in BGR image (bit 0xRRGGBB) - 2^24 bits = 2 MB
+{
+    std::vector<uint64_t> presence(1 << 18, 0); // 64 values per word
+
+    #pragma omp parallel
+    {
+        std::vector<uint64_t> local(1 << 18, 0); // one small bitset per thread : no atomic operation per pixel
+
+        #pragma omp for nowait
+        for (int y = 0; y < source.rows; y++) { // rows may not be continuous
+            const cv::Vec3b* sourceP = source.ptr<cv::Vec3b>(y);
+            const uchar* maskP = mask.empty() ? nullptr : mask.ptr<uchar>(y);
+            for (int x = 0; x < source.cols; x++) {
+                if ((maskP) and (maskP[x] == 0)) // excluded pixel
+                    continue;
+                const int value = (sourceP[x][2] << 16) | (sourceP[x][1] << 8) | sourceP[x][0]; // BGR -> 0xRRGGBB
+                local[value >> 6] |= uint64_t(1) << (value & 63);
+            }
+        }
+
+        #pragma omp critical
+        for (int n = 0; n < (1 << 18); n++) // merge
+            presence[n] |= local[n];
+    }
+
+    return presence;
+}
+
+int CountPresenceRGB24(const std::vector<uint64_t> &presence) // number of values present in a 24-bit RGB bitset
+{
+    int count = 0;
+    for (const uint64_t &word : presence)
+        count += __builtin_popcountll(word);
+
+    return count;
+}
+
+static std::vector<int> SortedPixelsRGB24(const cv::Mat &source, const cv::Mat &mask) // all 24-bit RGB values of BGR image, sorted - for small images
+{
+    std::vector<int> values;
+    values.reserve(source.total());
+    for (int y = 0; y < source.rows; y++) {
+        const cv::Vec3b* sourceP = source.ptr<cv::Vec3b>(y);
+        const uchar* maskP = mask.empty() ? nullptr : mask.ptr<uchar>(y);
+        for (int x = 0; x < source.cols; x++)
+            if ((!maskP) or (maskP[x] != 0)) // included pixel
+                values.push_back((sourceP[x][2] << 16) | (sourceP[x][1] << 8) | sourceP[x][0]); // BGR -> 0xRRGGBB
+    }
+    std::sort(values.begin(), values.end());
+
+    return values;
+}
+
+void UniqueColorsImageRGB24(const cv::Mat &source, std::vector<int> &colors, const cv::Mat &mask) // list 24-bit RGB values present in BGR image, by increasing RGB value
+{
+    colors.clear();
+
+    if (source.total() < rgb24SparseLimit) { // small image : sorting its values is cheaper than clearing and scanning a bitset
+        colors = SortedPixelsRGB24(source, mask);
+        colors.erase(std::unique(colors.begin(), colors.end()), colors.end());
+        return;
+    }
+
+    const std::vector<uint64_t> presence = PresenceImageRGB24(source, mask);
+    colors.reserve(CountPresenceRGB24(presence));
+    for (int n = 0; n < (1 << 18); n++)
+        for (uint64_t word = presence[n]; word != 0; word &= word - 1) // each bit set, lowest first
+            colors.push_back((n << 6) | __builtin_ctzll(word));
+}
+
+void UniqueColorsImageRGB24(const cv::Mat &source, std::vector<int> &colors, std::vector<int> &counts, const cv::Mat &mask) // list 24-bit RGB values present in BGR image with their counts, by increasing RGB value
+{
+    if (source.total() >= rgb24SparseLimit) { // big image : full histogram
+        UniqueColorsFromHistogram(HistogramImageRGB24(source, mask), colors, counts);
+        return;
+    }
+
+    colors.clear(); // small image : runs of equal sorted values
+    counts.clear();
+    const std::vector<int> values = SortedPixelsRGB24(source, mask);
+    for (size_t n = 0; n < values.size(); n++) {
+        if ((colors.empty()) or (colors.back() != values[n])) {
+            colors.push_back(values[n]);
+            counts.push_back(0);
+        }
+        counts.back()++;
+    }
+}
+
+void UniqueColorsFromHistogram(const std::vector<int> &histogram, std::vector<int> &colors, std::vector<int> &counts) // list values present in a 24-bit RGB histogram with their counts, by increasing RGB value
+{
+    colors.clear();
+    counts.clear();
+    for (int n = 0; n < int(histogram.size()); n++)
+        if (histogram[n] > 0) { // color present
+            colors.push_back(n);
+            counts.push_back(histogram[n]);
+        }
+}
+
 cv::Vec3d MeanWeightedColor(const cv::Mat &source, const cv::Mat &mask) // use an histogram to get mean weighted color of an image area (BGR or BGRA)
 {
     double total = cv::countNonZero(mask); // total number of pixels in mask / area
@@ -687,20 +825,16 @@ cv::Mat CreatePaletteImageFromImage(const cv::Mat3b &source) // parse BGR image
     // the resulting Mat can be used as palette values
     // it is in RGB format, not BGR !
 {
-    // get RGB values in array std::set (super-fast !)
-    std::set<int> paletteInt;
-    for (cv::Vec3b &p : cv::Mat_<cv::Vec3b>(source)) // iterate over pixels
-        paletteInt.insert((p[2] << 16) | (p[1] << 8) | (p[0])); // RGB "hatch" representation of the pixel
+    // get RGB values from a 2^24 bitset (super-fast !), by increasing value
+    std::vector<int> paletteInt;
+    UniqueColorsImageRGB24(source, paletteInt);
 
     int nbColors = paletteInt.size(); // how many colors found ?
     cv::Mat3b palette = cv::Mat::zeros(sqrt(nbColors) + 1, sqrt(nbColors) + 1, CV_8UC3); // create palette image on one line, nbColors pixels wide
 
     cv::Vec3b* paletteP = palette.ptr<cv::Vec3b>(0);
-    auto value = paletteInt.begin();
-    for (int n = 0; n < nbColors; n++) { // parse palette
-        paletteP[n] = cv::Vec3b(*value & 0x000000FF, (*value & 0x0000FF00) >> 8, (*value & 0x00FF0000) >> 16); // and set pixel color to palette image
-        value++;
-    }
+    for (int n = 0; n < nbColors; n++) // parse palette
+        paletteP[n] = cv::Vec3b(paletteInt[n] & 0x000000FF, (paletteInt[n] & 0x0000FF00) >> 8, (paletteInt[n] & 0x00FF0000) >> 16); // and set pixel color to palette image
 
     return palette;
 }
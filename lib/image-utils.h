@@ -4,7 +4,7 @@
 #
 #    by AbsurdePhoton - www.absurdephoton.fr
 #
-#                v2.0 - 2022/12/12
+#                v2.1 - 2026/10/18
 #
 #   - Utilities :
 #       * Range values utils for int and uchar
@@ -21,6 +21,8 @@
 #   - Image analysis, get :
 #       * Sobel gradients
 #       * Gray histogram (option with mask)
+#       * 24-bit RGB histogram, presence bitset and
+#         unique colors
 #       * Color mean using histograms
 #       * Color palette
 #       * Reflectance and Illumination
@@ -38,6 +40,8 @@
 #include <QImage>
 #include <QPixmap>
 
+#include <cstdint>
+
 
 //// General
 int GetByteInRange(const int &byte); // get a byte in range [0..255]
@@ -58,7 +62,7 @@ template <typename anyValue> anyValue GetValueInRange(anyValue param, anyValue m
 }
 
 //// Utils
-int CountRGBUniqueValues(const cv::Mat &source); // count number of RGB colors in image
+int CountRGBUniqueValues(const cv::Mat &source, const cv::Mat &mask = cv::Mat()); // count number of RGB colors in image - only pixels where 8-bit mask is not 0
 cv::Mat NormalizeImage(const cv::Mat & source); // normalize [0..255] image to [0..1] - returns a CV_64F image
 cv::Mat DeNormalizeImage(const cv::Mat & source); // denormalize [0..1] image to [0..255] - needs a CV_64F input
 bool MatEqual(const cv::Mat &one, const cv::Mat &two); // compare two Mat
@@ -91,6 +95,12 @@ void SobelGradientAngle(const cv::Mat &source, const int &kernelSize, const bool
 cv::Mat SobelizeImage(const cv::Mat &source, const int &kernelSize=3, const bool blur=true); // get Sobel image
 std::vector<double> HistogramImageGray(const cv::Mat &source); // compute histogram of gray image
 std::vector<double> HistogramImageGrayWithMask(const cv::Mat &source, const cv::Mat &mask); // compute histogram of gray image using a mask
+std::vector<int> HistogramImageRGB24(const cv::Mat &source, const cv::Mat &mask = cv::Mat()); // count occurences of each 24-bit RGB value (index 0xRRGGBB) in BGR image - 2^24 values
+void UniqueColorsFromHistogram(const std::vector<int> &histogram, std::vector<int> &colors, std::vector<int> &counts); // list values present in a 24-bit RGB histogram with their counts
+std::vector<uint64_t> PresenceImageRGB24(const cv::Mat &source, const cv::Mat &mask = cv::Mat()); // bitset of 24-bit RGB values present in BGR image (bit 0xRRGGBB) - 2^24 bits = 2 MB
+int CountPresenceRGB24(const std::vector<uint64_t> &presence); // number of values present in a 24-bit RGB bitset
+void UniqueColorsImageRGB24(const cv::Mat &source, std::vector<int> &colors, const cv::Mat &mask = cv::Mat()); // list 24-bit RGB values present in BGR image, by increasing value - sorted pixels for small images, bitset otherwise
+void UniqueColorsImageRGB24(const cv::Mat &source, std::vector<int> &colors, std::vector<int> &counts, const cv::Mat &mask = cv::Mat()); // same with the number of pixels of each value - sorted pixels for small images, histogram otherwise
 cv::Vec3d MeanWeightedColor(const cv::Mat &source, const cv::Mat &mask); // use an histogram to get mean weighted color of an image area
 double MeanWeightedGray(const cv::Mat &source, const cv::Mat &mask); // use an histogram to get mean weighted gray of an image area
 cv::Mat CreatePaletteImageFromImage(const cv::Mat3b &source); // parse BGR image and create a one-line RGB palette image from all colors - super-fast !
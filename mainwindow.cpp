@@ -18,6 +18,7 @@
 //#include <QDesktopWidget>
 #include <QCursor>
 #include <QMouseEvent>
+#include <QFileInfo>
 #include <QWhatsThis>
 
 #include <fstream>
@@ -66,41 +67,41 @@ MainWindow::MainWindow(QWidget *parent) :
 
     // populate color space combobox
     ui->comboBox_color_space->blockSignals(true); // don't launch automatic update of 3D view
-    ui->comboBox_color_space->addItem(tr("RGB"));
-    ui->comboBox_color_space->addItem(tr("Wheel"));
-    ui->comboBox_color_space->addItem(tr("HSV"));
-    ui->comboBox_color_space->addItem(tr("HWB"));
-    ui->comboBox_color_space->addItem(tr("CIE L*a*b*"));
-    ui->comboBox_color_space->addItem(tr("CIE L*u*v*"));
-    ui->comboBox_color_space->addItem(tr("OKLAB"));
-    ui->comboBox_color_space->addItem(tr("----------"));
-    ui->comboBox_color_space->addItem(tr("RGB Triangle"));
-    ui->comboBox_color_space->addItem(tr("HCV"));
-    ui->comboBox_color_space->addItem(tr("HSL"));
-    ui->comboBox_color_space->addItem(tr("HCL"));
-    ui->comboBox_color_space->addItem(tr("CIE XYZ"));
-    ui->comboBox_color_space->addItem(tr("CIE xyY"));
-    ui->comboBox_color_space->addItem(tr("LMS"));
-    ui->comboBox_color_space->addItem(tr("Hunter Lab"));
-    //ui->comboBox_color_space->addItem(tr("CIE LCHab")); // same as CIE L*a*b*
-    //ui->comboBox_color_space->addItem(tr("CIE LCHuv")); // same as CIE L*u*v*
+    ui->comboBox_color_space->addItem(tr("RGB"), ColorSpaceRGB);
+    ui->comboBox_color_space->addItem(tr("Wheel"), ColorSpaceWheel);
+    ui->comboBox_color_space->addItem(tr("HSV"), ColorSpaceHSV);
+    ui->comboBox_color_space->addItem(tr("HWB"), ColorSpaceHWB);
+    ui->comboBox_color_space->addItem(tr("CIE L*a*b*"), ColorSpaceCIELAB);
+    ui->comboBox_color_space->addItem(tr("CIE L*u*v*"), ColorSpaceLUV);
+    ui->comboBox_color_space->addItem(tr("OKLAB"), ColorSpaceOKLAB);
+    ui->comboBox_color_space->addItem(tr("----------"), -1); // separator, not a color space
+    ui->comboBox_color_space->addItem(tr("RGB Triangle"), ColorSpaceRGBTriangle);
+    ui->comboBox_color_space->addItem(tr("HCV"), ColorSpaceHCV);
+    ui->comboBox_color_space->addItem(tr("HSL"), ColorSpaceHSL);
+    ui->comboBox_color_space->addItem(tr("HCL"), ColorSpaceHCL);
+    ui->comboBox_color_space->addItem(tr("CIE XYZ"), ColorSpaceXYZ);
+    ui->comboBox_color_space->addItem(tr("CIE xyY"), ColorSpaceXYY);
+    ui->comboBox_color_space->addItem(tr("LMS"), ColorSpaceLMS);
+    ui->comboBox_color_space->addItem(tr("Hunter Lab"), ColorSpaceHLAB);
+    //ui->comboBox_color_space->addItem(tr("CIE LCHab"), ColorSpaceLCHAB); // same as CIE L*a*b*
+    //ui->comboBox_color_space->addItem(tr("CIE LCHuv"), ColorSpaceLCHUV); // same as CIE L*u*v*
     ui->comboBox_color_space->blockSignals(false); // return to normal behavior
 
     // populate sort combobox
     ui->comboBox_sort->blockSignals(true); // don't launch automatic update of palette
-    ui->comboBox_sort->addItem("Percentage");
-    ui->comboBox_sort->addItem("Hue");
-    ui->comboBox_sort->addItem("Chroma");
-    ui->comboBox_sort->addItem("Saturation");
-    ui->comboBox_sort->addItem("Value");
-    ui->comboBox_sort->addItem("Lightness");
-    ui->comboBox_sort->addItem("Luminance");
-    ui->comboBox_sort->addItem("Distance");
-    ui->comboBox_sort->addItem("Whiteness");
-    ui->comboBox_sort->addItem("Blackness");
-    ui->comboBox_sort->addItem("RGB");
-    ui->comboBox_sort->addItem("Luma");
-    ui->comboBox_sort->addItem("Rainbow6");
+    ui->comboBox_sort->addItem("Percentage", SortPercentage);
+    ui->comboBox_sort->addItem("Hue", SortHue);
+    ui->comboBox_sort->addItem("Chroma", SortChroma);
+    ui->comboBox_sort->addItem("Saturation", SortSaturation);
+    ui->comboBox_sort->addItem("Value", SortValue);
+    ui->comboBox_sort->addItem("Lightness", SortLightness);
+    ui->comboBox_sort->addItem("Luminance", SortLuminance);
+    ui->comboBox_sort->addItem("Distance", SortDistance);
+    ui->comboBox_sort->addItem("Whiteness", SortWhiteness);
+    ui->comboBox_sort->addItem("Blackness", SortBlackness);
+    ui->comboBox_sort->addItem("RGB", SortRGB);
+    ui->comboBox_sort->addItem("Luma", SortLuma);
+    ui->comboBox_sort->addItem("Rainbow6", SortRainbow6);
     ui->comboBox_sort->blockSignals(false); // return to normal behavior
 
     // fullscreen button
@@ -126,6 +127,7 @@ void MainWindow::InitializeValues() // Global variables init
 
     loaded = false; // main image NOT loaded
     computed = false; // dominant colors NOT computed
+    lutLoaded = false; // no LUT loaded
 
     converted = "No color to convert"; // convert string for displaying color values in a QMessageBox
 
@@ -198,59 +200,12 @@ void MainWindow::on_button_compute_clicked() // compute dominant colors and resu
 
 void MainWindow::on_button_3d_reset_clicked() // recenter position & zoom for 3D scene for each color space
 {
-    ui->openGLWidget_3d->zoom3D = 4; // zoom coefficient
+    const struct_color_space_3d &space = ColorSpaces3D[ui->openGLWidget_3d->colorSpace]; // default camera of the current color space
 
-    if (ui->openGLWidget_3d->color_space == "Wheel") {
-        ui->openGLWidget_3d->SetXRotation(180);
-        ui->openGLWidget_3d->SetYRotation(0);
-        ui->openGLWidget_3d->SetZRotation(-90);
-    }
-    if (ui->openGLWidget_3d->color_space == "RGB") {
-        ui->openGLWidget_3d->SetXRotation(287);
-        ui->openGLWidget_3d->SetYRotation(0);
-        ui->openGLWidget_3d->SetZRotation(300);
-    }
-    if (ui->openGLWidget_3d->color_space == "CIE XYZ") {
-        ui->openGLWidget_3d->SetXRotation(287);
-        ui->openGLWidget_3d->SetYRotation(0);
-        ui->openGLWidget_3d->SetZRotation(280);
-    }
-    if (ui->openGLWidget_3d->color_space == "LMS") {
-        ui->openGLWidget_3d->SetXRotation(287);
-        ui->openGLWidget_3d->SetYRotation(0);
-        ui->openGLWidget_3d->SetZRotation(300);
-    }
-    if (ui->openGLWidget_3d->color_space == "RGB Triangle") {
-        ui->openGLWidget_3d->SetXRotation(26);
-        ui->openGLWidget_3d->SetYRotation(30);
-        ui->openGLWidget_3d->SetZRotation(180);
-    }
-    if ((ui->openGLWidget_3d->color_space == "HSV") or (ui->openGLWidget_3d->color_space == "HCV")
-            or (ui->openGLWidget_3d->color_space == "HSL") or (ui->openGLWidget_3d->color_space == "HCL")) {
-        ui->openGLWidget_3d->SetXRotation(280);
-        ui->openGLWidget_3d->SetYRotation(0);
-        ui->openGLWidget_3d->SetZRotation(90);
-    }
-    if (ui->openGLWidget_3d->color_space == "HWB") {
-        ui->openGLWidget_3d->SetXRotation(100);
-        ui->openGLWidget_3d->SetYRotation(0);
-        ui->openGLWidget_3d->SetZRotation(-90);
-    }
-    if ((ui->openGLWidget_3d->color_space == "CIE L*a*b*") or (ui->openGLWidget_3d->color_space == "Hunter Lab") or (ui->openGLWidget_3d->color_space == "OKLAB")) {
-        ui->openGLWidget_3d->SetXRotation(290);
-        ui->openGLWidget_3d->SetYRotation(0);
-        ui->openGLWidget_3d->SetZRotation(120);
-    }
-    if (ui->openGLWidget_3d->color_space == "CIE xyY") {
-        ui->openGLWidget_3d->SetXRotation(210);
-        ui->openGLWidget_3d->SetYRotation(240);
-        ui->openGLWidget_3d->SetZRotation(270);
-    }
-    if (ui->openGLWidget_3d->color_space == "CIE L*u*v*") {
-        ui->openGLWidget_3d->SetXRotation(280);
-        ui->openGLWidget_3d->SetYRotation(0);
-        ui->openGLWidget_3d->SetZRotation(120);
-    }
+    ui->openGLWidget_3d->zoom3D = space.zoom; // zoom coefficient
+    ui->openGLWidget_3d->SetXRotation(space.rotation_x);
+    ui->openGLWidget_3d->SetYRotation(space.rotation_y);
+    ui->openGLWidget_3d->SetZRotation(space.rotation_z);
 
     ui->openGLWidget_3d->SetXShift(0); // initial (x,y) position
     ui->openGLWidget_3d->SetYShift(0);
@@ -262,6 +217,12 @@ void MainWindow::on_checkBox_3d_light_clicked() // light on/off in 3D scene
     ui->openGLWidget_3d->update(); // view 3D scene
 }
 
+void MainWindow::on_checkBox_3d_pixels_clicked() // show all colors of the image as points in 3D scene
+{
+    ui->openGLWidget_3d->pointCloudEnabled = ui->checkBox_3d_pixels->isChecked(); // set value
+    ui->openGLWidget_3d->update(); // view 3D scene
+}
+
 void MainWindow::on_checkBox_3d_fullscreen_clicked() // view 3D scene fullscreen, <ESC> to return from it
 {
     saveXOpenGL = ui->openGLWidget_3d->x(); // save openGL widget position and size
@@ -304,15 +265,17 @@ void MainWindow::on_button_3d_exit_fullscreen_clicked() // exit fullscreen view
     ui->verticalSlider_3D_rotate_x->raise();
     ui->button_3d_reset->raise();
     ui->checkBox_3d_light->raise();
+    ui->checkBox_3d_pixels->raise();
     ui->checkBox_3d_fullscreen->raise();
 }
 
 void MainWindow::on_button_3d_reset_flags_clicked() // reset visibility and selection flags in 3D view
 {
     for (int n = 0; n < ui->openGLWidget_3d->nb_palettes; n++) {
-        ui->openGLWidget_3d->palettes[n].selected = false;
-        ui->openGLWidget_3d->palettes[n].visible = true;
+        ui->openGLWidget_3d->palettes.selected[n] = false;
+        ui->openGLWidget_3d->palettes.visible[n] = true;
     }
+    ui->openGLWidget_3d->PaletteChanged(); // hidden spheres are shown again
 
     ui->openGLWidget_3d->update();
     ShowImages();
@@ -320,7 +283,11 @@ void MainWindow::on_button_3d_reset_flags_clicked() // reset visibility and sele
 
 void MainWindow::on_comboBox_color_space_currentIndexChanged(int index) // change color space
 {
-    ui->openGLWidget_3d->color_space = ui->comboBox_color_space->currentText().toStdString(); // set value
+    int space = ui->comboBox_color_space->currentData().toInt(); // color space index
+    if (space < 0) // separator
+        return;
+
+    ui->openGLWidget_3d->SetColorSpace(ColorSpace3D(space)); // set value
     ui->openGLWidget_3d->update(); // view 3D scene
 }
 
@@ -368,6 +335,7 @@ void MainWindow::keyPressEvent(QKeyEvent *keyEvent) // keyboard events
         ui->verticalSlider_3D_rotate_x->raise();
         ui->button_3d_reset->raise();
         ui->checkBox_3d_light->raise();
+        ui->checkBox_3d_pixels->raise();
         ui->checkBox_3d_fullscreen->raise();
     }
 
@@ -454,24 +422,26 @@ void MainWindow::mousePressEvent(QMouseEvent *eventPress) // event triggered by
         // find color in palette
         bool found = false; // picked color found in palette ?
         for (int n = 0; n < ui->openGLWidget_3d->nb_palettes; n++) { // search in palette
-            if ((round(ui->openGLWidget_3d->palettes[n].RGB.R * 255.0) == R)
-                    and (round(ui->openGLWidget_3d->palettes[n].RGB.G * 255.0) == G)
-                    and (round(ui->openGLWidget_3d->palettes[n].RGB.B * 255.0) == B)) { // identical RGB values found
-                QString value = QString::number(ui->openGLWidget_3d->palettes[n].percentage * 100, 'f', 2) + "%"; // picked color percentage in quantized image
+            if ((round(ui->openGLWidget_3d->palettes.RGB[n].R * 255.0) == R)
+                    and (round(ui->openGLWidget_3d->palettes.RGB[n].G * 255.0) == G)
+                    and (round(ui->openGLWidget_3d->palettes.RGB[n].B * 255.0) == B)) { // identical RGB values found
+                QString value = QString::number(ui->openGLWidget_3d->palettes.percentage[n] * 100, 'f', 2) + "%"; // picked color percentage in quantized image
                 ui->label_color_percentage->setText(value); // display percentage
-                ui->label_color_name->setText(QString::fromStdString(ui->openGLWidget_3d->palettes[n].name));
-                ui->label_color_hex->setText(QString::fromStdString(ui->openGLWidget_3d->palettes[n].hexa)); // show hexa
+                ui->label_color_name->setText(QString::fromStdString(ui->openGLWidget_3d->palettes.Name(n)));
+                ui->label_color_hex->setText(QString::fromStdString(ui->openGLWidget_3d->palettes.Hexa(n))); // show hexa
 
                 found = true; // color found in palette
 
                 if (key_control) {
-                    ui->openGLWidget_3d->palettes[n].selected = !ui->openGLWidget_3d->palettes[n].selected; // ctrl key = switch selected state for this color in 3D scene
+                    ui->openGLWidget_3d->palettes.selected[n] = !ui->openGLWidget_3d->palettes.selected[n]; // ctrl key = switch selected state for this color in 3D scene
                     ShowImages();
                 }
-                if (key_alt)
-                    ui->openGLWidget_3d->palettes[n].visible = !ui->openGLWidget_3d->palettes[n].visible; // alt key = switch visibility state for this color in 3D scene
+                if (key_alt) {
+                    ui->openGLWidget_3d->palettes.visible[n] = !ui->openGLWidget_3d->palettes.visible[n]; // alt key = switch visibility state for this color in 3D scene
+                    ui->openGLWidget_3d->PaletteChanged(); // spheres must be rebuilt
+                }
 
-                converted = ConvertColor(ui->openGLWidget_3d->palettes[n].RGB.R, ui->openGLWidget_3d->palettes[n].RGB.G, ui->openGLWidget_3d->palettes[n].RGB.B); // compute string with values in most known color spaces
+                converted = ConvertColor(ui->openGLWidget_3d->palettes.RGB[n].R, ui->openGLWidget_3d->palettes.RGB[n].G, ui->openGLWidget_3d->palettes.RGB[n].B); // compute string with values in most known color spaces
 
                 ui->openGLWidget_3d->update(); // update 3D view
 
@@ -513,6 +483,14 @@ void MainWindow::ChangeBaseDir(QString filename) // set base dir and file
     SaveDirBaseFile(); // Save current path to ini file
 }
 
+std::string MainWindow::LUTCacheDir() // folder of compiled LUTs, next to the folder ini file
+{
+    QString cacheDir = QDir::currentPath() + "/lut-cache";
+    QDir().mkpath(cacheDir); // create it if needed
+
+    return cacheDir.toUtf8().constData();
+}
+
 void MainWindow::on_button_load_image_clicked() // load image to analyze
 {
     PreviewFileDialog* mpOpenDialog = new PreviewFileDialog(this, "Load image...", QString::fromStdString(basedir), tr("Images (*.jpg *.jpeg *.jp2 *.png *.tif *.tiff *.webp)"));
@@ -526,7 +504,20 @@ void MainWindow::on_button_load_image_clicked() // load image to analyze
     ChangeBaseDir(filename); // save current path to ini file
 
     std::string filesession = filename.toUtf8().constData(); // base file name
-    image = cv::imread(filesession); // load image
+    imageMask.release(); // no alpha channel yet
+    image.release();
+    if (filename.endsWith(".png", Qt::CaseInsensitive) or filename.endsWith(".tif", Qt::CaseInsensitive)
+            or filename.endsWith(".tiff", Qt::CaseInsensitive) or filename.endsWith(".webp", Qt::CaseInsensitive)) { // formats with transparency
+        cv::Mat imageAlpha = cv::imread(filesession, cv::IMREAD_UNCHANGED); // keep alpha channel
+        if ((imageAlpha.channels() == 4) and (imageAlpha.depth() == CV_8U)) { // 8-bit BGRA
+            cv::Mat alpha;
+            ImageToBGRplusAlpha(imageAlpha, image, alpha);
+            if (cv::countNonZero(alpha < 128) > 0) // transparent pixels are not analyzed
+                imageMask = alpha >= 128;
+        }
+    }
+    if (image.empty()) // no alpha channel
+        image = cv::imread(filesession); // load image
     if (image.empty()) {
         QMessageBox::critical(this, "File error", "There was a problem reading the image file");
         return;
@@ -534,10 +525,17 @@ void MainWindow::on_button_load_image_clicked() // load image to analyze
 
     if (ui->checkBox_gaussian_blur->isChecked()) cv::GaussianBlur(image, image, Size(3,3), 0, 0); // gaussian blur
     if (ui->checkBox_reduce_size->isChecked()) {
-        if ((image.rows > 512) or (image.cols > 512)) image = ResizeImageAspectRatio(image, cv::Size(512,512)); // resize image to 512 pixels
+        if ((image.rows > 512) or (image.cols > 512)) {
+            image = ResizeImageAspectRatio(image, cv::Size(512,512)); // resize image to 512 pixels
+            if (!imageMask.empty()) // same size for the mask
+                imageMask = ResizeImageAspectRatio(imageMask, cv::Size(512,512)) >= 128;
+        }
     }
 
     loaded = true; // loaded successfully !
+    lutLoaded = false; // image analyzed, not LUT
+    lutColors.clear();
+    lutWeights.clear();
 
     ui->label_filename->setText(filename); // display filename in ui
 
@@ -548,6 +546,8 @@ void MainWindow::on_button_load_image_clicked() // load image to analyze
 
     ShowImages(); // show images in GUI
     ui->openGLWidget_3d->nb_palettes = -1; // no palette to show yet
+    ui->openGLWidget_3d->PaletteChanged(); // spheres must be removed
+    ui->openGLWidget_3d->SetPointCloudImage(image); // all colors of the image as points
     ui->openGLWidget_3d->update(); // show empty 3D view
 
     ui->timer->display("-------"); // reset timer in GUI
@@ -576,58 +576,44 @@ void MainWindow::on_button_load_lut_clicked() // load .cube LUT to analyze
 
     // Cube LUT
     CubeLUT cube; // new cube
-    std::ifstream cubeFile; // file for this cube
-    cubeFile.open(filesession, std::ifstream::in); // open cube file
-    bool ok = cubeFile.is_open(); // indicator
-
-    if (ok) { // file loaded successfully
-        CubeLUT::LUTState state = cube.LoadCubeFile(cubeFile);
-
-        if (state == CubeLUT::OK) {
-            QApplication::setOverrideCursor(Qt::WaitCursor); // wait cursor
-            timer.start(); // start of elapsed time
-            ShowTimer(true); // show elapsed time
-            qApp->processEvents();
-
-            if (!cube.LUT1D.empty()) {
-                image = cv::Mat::zeros(1, cube.LUT1D.size(), CV_8UC3);
-                cv::Vec3b* imageP = image.ptr<cv::Vec3b>(0);
-                for (int n = 0; n < int(cube.LUT1D.size()); n++) {
-                    imageP[n] = cv::Vec3b(cube.LUT1D[n][2] * 255.0, cube.LUT1D[n][1] * 255.0, cube.LUT1D[n][0] * 255.0);
-                }
-            }
-            else if (!cube.LUT3D.empty()) {
-                image = cv::Mat::zeros(1, cube.LUT3D[0].size() * cube.LUT3D[0].size() * cube.LUT3D[0].size(), CV_8UC3);
-                cv::Vec3b* imageP = image.ptr<cv::Vec3b>(0);
-                int n = 0;
-                for (int x = 0; x < int(cube.LUT3D[0].size()); x++) {
-                    for (int y = 0; y < int(cube.LUT3D[1].size()); y++) {
-                        for (int z = 0; z < int(cube.LUT3D[2].size()); z++) {
-                            imageP[n] = cv::Vec3b(cube.LUT3D[x][y][z][2] * 255.0, cube.LUT3D[x][y][z][1] * 255.0, cube.LUT3D[x][y][z][0] * 255.0);
-                            n++;
-                        }
-                    }
-                }
-            }
-            else {
-                ShowTimer(false); // show elapsed time
-                QApplication::restoreOverrideCursor(); // Restore cursor
-                loaded = false;
-                QMessageBox::information(this, "Error", "Cube LUT bad format");
-                return;
-            }
+    CubeLUT::LUTState state = cube.LoadCubeFileCached(filesession, LUTCacheDir()); // compiled table if this file was already loaded
 
-            ShowTimer(false); // show elapsed time
-            QApplication::restoreOverrideCursor(); // Restore cursor
-        }
-    }
-    else {
-        loaded = false;
+    if (state == CubeLUT::ReadError) { // file could not be read : the previous image or LUT stays
         QMessageBox::information(this, "Error", "Problem loading Cube LUT");
         return;
     }
+    if (state != CubeLUT::OK) { // any parse error : the previous image or LUT stays
+        QMessageBox::information(this, "Error", "Cube LUT bad format (error " + QString::number(state) + ")");
+        return;
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor); // wait cursor
+    timer.start(); // start of elapsed time
+    ShowTimer(true); // show elapsed time
+    qApp->processEvents();
+
+    std::vector<cv::Vec3d> colors; // replace the analyzed colors only if this LUT has some
+    std::vector<double> weights;
+    cube.OutputColors(colors, weights, CubeLUT::WeightInputVolume); // analyzed directly, entries on the borders of the domain count less
+
+    ShowTimer(false); // show elapsed time
+    QApplication::restoreOverrideCursor(); // Restore cursor
+
+    if (colors.empty()) {
+        QMessageBox::information(this, "Error", "Cube LUT bad format");
+        return;
+    }
+
+    lutColors = colors;
+    lutWeights = weights;
+    image = cv::Mat::zeros(1, lutColors.size(), CV_8UC3); // image of LUT colors, only for the point cloud and the quantized view
+    imageMask.release(); // all LUT colors are analyzed
+    cv::Vec3b* imageP = image.ptr<cv::Vec3b>(0);
+    for (int n = 0; n < int(lutColors.size()); n++)
+        imageP[n] = cv::Vec3b(round(lutColors[n][2] * 255.0), round(lutColors[n][1] * 255.0), round(lutColors[n][0] * 255.0));
 
     loaded = true; // loaded successfully !
+    lutLoaded = true; // compute LUT colors, not image pixels
 
     ui->label_filename->setText(filename); // display filename in ui
 
@@ -639,6 +625,8 @@ void MainWindow::on_button_load_lut_clicked() // load .cube LUT to analyze
 
     ShowImages(); // show images in GUI
     ui->openGLWidget_3d->nb_palettes = -1; // no palette to show yet
+    ui->openGLWidget_3d->PaletteChanged(); // spheres must be removed
+    ui->openGLWidget_3d->SetPointCloudImage(image); // all colors of the image as points
     ui->openGLWidget_3d->update(); // show empty 3D view
 
     ui->timer->display("-------"); // reset timer in GUI
@@ -652,12 +640,46 @@ void MainWindow::on_button_load_lut_clicked() // load .cube LUT to analyze
     ui->label_color_percentage->setText("");
     ui->label_color_name->setText("");
 
-    // set special options for LUTs
-    ui->checkBox_filter_grays->setChecked(false); // don't filter grays
-    ui->checkBox_filter_percent->setChecked(false); // don't filter low values
-    ui->spinBox_nb_palettes->setValue(512); // 512 levels of color
+    Compute(); // with the number of colors chosen by the user - gray and percent filters don't apply to LUTs
+}
+
+void MainWindow::on_checkBox_apply_lut_clicked() // choose LUTs applied to the image before analysis
+{
+    if (!ui->checkBox_apply_lut->isChecked()) { // no more grading
+        gradingLUT = CubeLUT();
+        ui->checkBox_apply_lut->setToolTip("Several LUTs are applied in file name order");
+        return;
+    }
 
-    Compute();
+    QStringList filenames = QFileDialog::getOpenFileNames(this, "Load Cube LUTs to apply...", QString::fromStdString(basedir),
+                                                          tr("LUT (*.cube *.CUBE)"), NULL, QFileDialog::DontUseNativeDialog); // .cube LUT file names
+
+    if (filenames.isEmpty()) { // cancel ?
+        ui->checkBox_apply_lut->setChecked(false);
+        return;
+    }
+    filenames.sort(); // chain order = file name order, whatever the selection order
+
+    std::vector<CubeLUT> cubes(filenames.size()); // all LUTs of the chain
+    std::vector<const CubeLUT*> chain;
+    for (int n = 0; n < filenames.size(); n++) {
+        CubeLUT::LUTState state = cubes[n].LoadCubeFileCached(filenames[n].toUtf8().constData(), LUTCacheDir());
+        if (state != CubeLUT::OK) {
+            ui->checkBox_apply_lut->setChecked(false);
+            QMessageBox::information(this, "Error", "Problem loading Cube LUT:\n" + filenames[n]);
+            return;
+        }
+        chain.push_back(&cubes[n]);
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor); // wait cursor
+    gradingLUT = CubeLUT::Compose(chain, CubeLUT::Tetrahedral); // one table for the whole chain : one lookup per pixel
+    QApplication::restoreOverrideCursor(); // Restore cursor
+
+    QString applied = "Applied in file name order :"; // show applied LUTs in chain order
+    for (int n = 0; n < filenames.size(); n++)
+        applied += "\n" + QString::number(n + 1) + ". " + QFileInfo(filenames[n]).fileName();
+    ui->checkBox_apply_lut->setToolTip(applied);
 }
 
 void MainWindow::on_button_save_clicked() // save dominant colors results
@@ -683,81 +705,82 @@ void MainWindow::on_button_save_clicked() // save dominant colors results
     save.open(basedir + basefile + "-palette.csv"); // save palette file
 
     if (save) { // if successfully open
+        ui->openGLWidget_3d->ConvertPaletteExtended(); // Hunter Lab, LMS and LCHuv are computed on demand
         setlocale(LC_ALL, "C"); // force numeric separator=dot instead of comma (I'm French) when using std functions
         save << "Name;RGB.R;RGB.G;RGB.B;RGB.R normalized;RGB.G normalized;RGB.B normalized;RGB hexadecimal;HSV.H °;HSV.S;HSV.V;HSV.C;HSL.H °;HSL.S;HSL.L;HSL.C;HWB.H °;HWB.W;HWB.B;XYZ.X;XYZ.Y;XYZ.Z;xyY.x;xyY.y;xyY.Y;L*u*v*.L;L*u*v*.u;L*u*v*.v;LCHuv.L;LCHuv.C;LCHuv.H °;L*A*B*.L;L*A*B*.a signed;L*A*B*.b signed;LCHab.L;LCHab.C;LCHab.H °;Hunter LAB.L;Hunter LAB.a signed;Hunter LAB.b signed;LMS.L;LMS.M;LMS.S;CMYK.C;CMYK.M;CMYK.Y;CMYK.K;OKLAB.L;OKLAB.a signed;OKLAB.b signed;OKLCH.L;OKLCH.C;OKLCH.H °;Percentage\n"; // CSV header
         for (int n = 0; n < ui->openGLWidget_3d->nb_palettes; n++) { // read palette
-            save << ui->openGLWidget_3d->palettes[n].name << ";";
+            save << ui->openGLWidget_3d->palettes.Name(n) << ";";
             // RGB [0..255]
-            save << ui->openGLWidget_3d->palettes[n].RGB.R * 255.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].RGB.G * 255.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].RGB.B * 255.0 << ";";
+            save << ui->openGLWidget_3d->palettes.RGB[n].R * 255.0 << ";";
+            save << ui->openGLWidget_3d->palettes.RGB[n].G * 255.0 << ";";
+            save << ui->openGLWidget_3d->palettes.RGB[n].B * 255.0 << ";";
             // RGB [0..1]
-            save << ui->openGLWidget_3d->palettes[n].RGB.R << ";";
-            save << ui->openGLWidget_3d->palettes[n].RGB.G << ";";
-            save << ui->openGLWidget_3d->palettes[n].RGB.B << ";";
+            save << ui->openGLWidget_3d->palettes.RGB[n].R << ";";
+            save << ui->openGLWidget_3d->palettes.RGB[n].G << ";";
+            save << ui->openGLWidget_3d->palettes.RGB[n].B << ";";
             // RGB hexa
-            save << ui->openGLWidget_3d->palettes[n].hexa << ";";
+            save << ui->openGLWidget_3d->palettes.Hexa(n) << ";";
             // HSV+C
-            save << ui->openGLWidget_3d->palettes[n].HSV.H * 360.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].HSV.S * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].HSV.V * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].HSV.C * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.HSV[n].H * 360.0 << ";";
+            save << ui->openGLWidget_3d->palettes.HSV[n].S * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.HSV[n].V * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.HSV[n].C * 100.0 << ";";
             // HSL+C
-            save << ui->openGLWidget_3d->palettes[n].HSL.H * 360.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].HSL.S * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].HSL.L * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].HSL.C * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.HSL[n].H * 360.0 << ";";
+            save << ui->openGLWidget_3d->palettes.HSL[n].S * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.HSL[n].L * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.HSL[n].C * 100.0 << ";";
             // HWB
-            save << ui->openGLWidget_3d->palettes[n].HWB.H * 360.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].HWB.W * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].HWB.B * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.HWB[n].H * 360.0 << ";";
+            save << ui->openGLWidget_3d->palettes.HWB[n].W * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.HWB[n].B * 100.0 << ";";
             // CIE XYZ
-            save << ui->openGLWidget_3d->palettes[n].XYZ.X * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].XYZ.Y * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].XYZ.Z * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.XYZ[n].X * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.XYZ[n].Y * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.XYZ[n].Z * 100.0 << ";";
             // CIE xyY
-            save << ui->openGLWidget_3d->palettes[n].XYY.x << ";";
-            save << ui->openGLWidget_3d->palettes[n].XYY.y << ";";
-            save << ui->openGLWidget_3d->palettes[n].XYY.Y * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.XYY[n].x << ";";
+            save << ui->openGLWidget_3d->palettes.XYY[n].y << ";";
+            save << ui->openGLWidget_3d->palettes.XYY[n].Y * 100.0 << ";";
             // CIE Luv
-            save << ui->openGLWidget_3d->palettes[n].LUV.L * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].LUV.u * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].LUV.v * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.LUV[n].L * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.LUV[n].u * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.LUV[n].v * 100.0 << ";";
             // CIE LCHuv
-            save << ui->openGLWidget_3d->palettes[n].LCHUV.L * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].LCHUV.C * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].LCHUV.H * 360.0 << ";";
+            save << ui->openGLWidget_3d->palettes.LCHUV[n].L * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.LCHUV[n].C * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.LCHUV[n].H * 360.0 << ";";
             // CIE L*a*b*
-            save << ui->openGLWidget_3d->palettes[n].CIELAB.L * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].CIELAB.A * 127.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].CIELAB.B * 127.0 << ";";
+            save << ui->openGLWidget_3d->palettes.CIELAB[n].L * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.CIELAB[n].A * 127.0 << ";";
+            save << ui->openGLWidget_3d->palettes.CIELAB[n].B * 127.0 << ";";
             // CIE LCHab
-            save << ui->openGLWidget_3d->palettes[n].LCHAB.L * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].LCHAB.C * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].LCHAB.H * 360.0 << ";";
+            save << ui->openGLWidget_3d->palettes.LCHAB[n].L * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.LCHAB[n].C * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.LCHAB[n].H * 360.0 << ";";
             // Hunter LAB
-            save << ui->openGLWidget_3d->palettes[n].HLAB.L * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].HLAB.A * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].HLAB.B * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.HLAB[n].L * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.HLAB[n].A * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.HLAB[n].B * 100.0 << ";";
             // CIE LMS
-            save << ui->openGLWidget_3d->palettes[n].LMS.L * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].LMS.M * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].LMS.S * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.LMS[n].L * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.LMS[n].M * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.LMS[n].S * 100.0 << ";";
             // CMYK
-            save << ui->openGLWidget_3d->palettes[n].CMYK.C * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].CMYK.M * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].CMYK.Y * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].CMYK.K * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.CMYK[n].C * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.CMYK[n].M * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.CMYK[n].Y * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.CMYK[n].K * 100.0 << ";";
             // OKLAB
-            save << ui->openGLWidget_3d->palettes[n].OKLAB.L * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].OKLAB.A * 127.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].OKLAB.B * 127.0 << ";";
+            save << ui->openGLWidget_3d->palettes.OKLAB[n].L * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.OKLAB[n].A * 127.0 << ";";
+            save << ui->openGLWidget_3d->palettes.OKLAB[n].B * 127.0 << ";";
             // OKLCH
-            save << ui->openGLWidget_3d->palettes[n].OKLCH.L * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].OKLCH.C * 100.0 << ";";
-            save << ui->openGLWidget_3d->palettes[n].OKLCH.H * 360.0 << ";";
+            save << ui->openGLWidget_3d->palettes.OKLCH[n].L * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.OKLCH[n].C * 100.0 << ";";
+            save << ui->openGLWidget_3d->palettes.OKLCH[n].H * 360.0 << ";";
             // percentage
-            save << ui->openGLWidget_3d->palettes[n].percentage << "\n";
+            save << ui->openGLWidget_3d->palettes.percentage[n] << "\n";
         }
 
         save.close(); // close text file
@@ -772,9 +795,9 @@ void MainWindow::on_button_save_clicked() // save dominant colors results
         nbValues = 256; // so we'll save first 256 values
 
     for (int n = 0; n < nbValues; n++) { // palette values to buffer
-        buffer[n * 3 + 0] = round(ui->openGLWidget_3d->palettes[n].RGB.R * 255.0);
-        buffer[n * 3 + 1] = round(ui->openGLWidget_3d->palettes[n].RGB.G * 255.0);
-        buffer[n * 3 + 2] = round(ui->openGLWidget_3d->palettes[n].RGB.B * 255.0);
+        buffer[n * 3 + 0] = round(ui->openGLWidget_3d->palettes.RGB[n].R * 255.0);
+        buffer[n * 3 + 1] = round(ui->openGLWidget_3d->palettes.RGB[n].G * 255.0);
+        buffer[n * 3 + 2] = round(ui->openGLWidget_3d->palettes.RGB[n].B * 255.0);
     }
     buffer[768] = (unsigned short) nbValues; // last second 16-bit value : number of colors in palette
     buffer[770] = (unsigned short) 255; // last 16-bit value : which color is transparency
@@ -788,9 +811,9 @@ void MainWindow::on_button_save_clicked() // save dominant colors results
         saveJASC << "JASC-PAL\n0100\n";
         saveJASC << ui->openGLWidget_3d->nb_palettes << "\n";
         for (int n = 0; n < ui->openGLWidget_3d->nb_palettes; n++) { // read palette
-            saveJASC << round(ui->openGLWidget_3d->palettes[n].RGB.R * 255.0) << " ";
-            saveJASC << round(ui->openGLWidget_3d->palettes[n].RGB.G * 255.0) << " ";
-            saveJASC << round(ui->openGLWidget_3d->palettes[n].RGB.B * 255.0) << "\n";
+            saveJASC << round(ui->openGLWidget_3d->palettes.RGB[n].R * 255.0) << " ";
+            saveJASC << round(ui->openGLWidget_3d->palettes.RGB[n].G * 255.0) << " ";
+            saveJASC << round(ui->openGLWidget_3d->palettes.RGB[n].B * 255.0) << "\n";
         }
         saveJASC.close(); // close text file
     }
@@ -801,8 +824,8 @@ void MainWindow::on_button_save_clicked() // save dominant colors results
     if (saveCOREL) { // if successfully open
         double C, M, Y, K;
         for (int n = 0; n < ui->openGLWidget_3d->nb_palettes; n++) { // read palette
-            RGBtoCMYK(ui->openGLWidget_3d->palettes[n].RGB.R, ui->openGLWidget_3d->palettes[n].RGB.G, ui->openGLWidget_3d->palettes[n].RGB.B, C, M, Y, K);
-            saveCOREL << '"' << ui->openGLWidget_3d->palettes[n].name << '"' << " " << int(round(C * 100.0)) << " " << int(round(M * 100.0)) << " " << int(round(Y * 100.0)) << " " << int(round(K * 100.0)) << "\n";
+            RGBtoCMYK(ui->openGLWidget_3d->palettes.RGB[n].R, ui->openGLWidget_3d->palettes.RGB[n].G, ui->openGLWidget_3d->palettes.RGB[n].B, C, M, Y, K);
+            saveCOREL << '"' << ui->openGLWidget_3d->palettes.Name(n) << '"' << " " << int(round(C * 100.0)) << " " << int(round(M * 100.0)) << " " << int(round(Y * 100.0)) << " " << int(round(K * 100.0)) << "\n";
         }
         saveCOREL.close(); // close text file
     }
@@ -812,69 +835,124 @@ void MainWindow::on_button_save_clicked() // save dominant colors results
 
 /////////////////// Core functions //////////////////////
 
+static void MaskGrays(const cv::Mat &image, cv::Mat mask) // exclude whites, blacks and greys from 8-bit mask of same size
+{
+    double H, S, L, C;
+
+    for (int y = 0; y < image.rows; y++) { // parse image
+        const Vec3b* imageP = image.ptr<Vec3b>(y);
+        uchar* maskP = mask.ptr<uchar>(y);
+        for (int x = 0; x < image.cols; x++) {
+            RGBtoHSL(double(imageP[x][2]) / 255.0, double(imageP[x][1]) / 255.0, double(imageP[x][0]) / 255.0, H, S, L, C); // convert current pixel color to HSL
+
+            if ((S < 0.25) or (L < 0.15) or (L > 0.8)) // white or black or grey pixel ?
+                maskP[x] = 0; // don't analyze it
+        }
+    }
+}
+
 void MainWindow::Compute() // analyze image dominant colors
 {
     if (!loaded) { // nothing loaded yet = get out
         return;
     }
 
+    if (lutLoaded) { // LUT colors are weighted samples, not pixels
+        ComputeLUT();
+        return;
+    }
+
     QApplication::setOverrideCursor(Qt::WaitCursor); // wait cursor
     timer.start(); // start of elapsed time
     ShowTimer(true); // show elapsed time
     qApp->processEvents();
 
-    Mat imageCopy; // work on a copy of the image, because gray colors can be filtered
+    Mat imageCopy; // work on a copy of the image, because it can be graded
     image.copyTo(imageCopy);
 
-    if (ui->checkBox_filter_grays->isChecked()) { // filter whites, blacks and greys
-        Vec3b RGB;
-        double H, S, L, C;
-
-        for (int x = 0; x < imageCopy.cols; x++) // parse temp image
-            for  (int y = 0; y < imageCopy.rows; y++) {
-                RGB = imageCopy.at<Vec3b>(y, x); // current pixel color
-                RGBtoHSL(double(RGB[2]) / 255.0, double(RGB[1]) / 255.0, double(RGB[0]) / 255.0, H, S, L, C); // convert it to HSL
+    Mat pixelMask; // pixels analyzed : transparent pixels and filtered grays are excluded - empty = all pixels
+    if (!imageMask.empty())
+        pixelMask = imageMask.clone();
+    const bool filterGrays = ui->checkBox_filter_grays->isChecked();
+    if ((filterGrays) and (pixelMask.empty()))
+        pixelMask = Mat(imageCopy.rows, imageCopy.cols, CV_8UC1, Scalar(255));
+
+    if ((ui->checkBox_apply_lut->isChecked()) and (gradingLUT.status == CubeLUT::OK)) { // apply LUTs, then analyze : gray filter on each band while it is in cache
+        std::function<void(cv::Mat &tile, const int &firstRow)> maskGrays = nullptr;
+        if (filterGrays)
+            maskGrays = [&pixelMask](cv::Mat &tile, const int &firstRow) { MaskGrays(tile, pixelMask.rowRange(firstRow, firstRow + tile.rows)); };
+        gradingLUT.ApplyLUTTiles(imageCopy, 1.0, CubeLUT::Tetrahedral, maskGrays);
+    }
+    else if (filterGrays) // filter whites, blacks and greys
+        MaskGrays(imageCopy, pixelMask);
+
+    int total = pixelMask.empty() ? imageCopy.rows * imageCopy.cols : countNonZero(pixelMask); // pixels analyzed
+    if (total == 0) { // nothing left to analyze
+        ShowTimer(false); // show elapsed time
+        QApplication::restoreOverrideCursor(); // Restore cursor
+        QMessageBox::information(this, "Error", "No pixel left to analyze : the image is transparent or only has grays");
+        return;
+    }
 
-                if ((S < 0.25) or (L < 0.15) or (L > 0.8)) // white or black or grey pixel ?
-                    imageCopy.at<Vec3b>(y, x) = Vec3b(0, 0, 0); // replace it with black
-            }
+    // coarse to fine : dominant colors are found on a small proxy, then each pixel of the full image gets its nearest color
+    Mat proxy = imageCopy; // image and mask analyzed by the algorithms
+    Mat proxyMask = pixelMask;
+    bool coarseToFine = (ui->checkBox_coarse_to_fine->isChecked()) and ((imageCopy.rows > 512) or (imageCopy.cols > 512));
+    if (coarseToFine) {
+        proxy = ResizeImageAspectRatio(imageCopy, cv::Size(512, 512)); // same size as "reduce size"
+        if (!pixelMask.empty())
+            proxyMask = ResizeImageAspectRatio(pixelMask, cv::Size(512, 512)) >= 128;
+        if ((!proxyMask.empty()) and (countNonZero(proxyMask) == 0)) { // included pixels too small to be in the proxy : full image
+            proxy = imageCopy;
+            proxyMask = pixelMask;
+            coarseToFine = false;
+        }
     }
 
     ui->openGLWidget_3d->nb_palettes= ui->spinBox_nb_palettes->value(); // how many dominant colors
     int nb_palettes_asked = ui->openGLWidget_3d->nb_palettes; // save asked number of colors for later
     ui->spinBox_nb_palettes->setStyleSheet("QSpinBox{color:black;}"); // show number of colors in black (in case it was red before)
 
-    if (ui->checkBox_filter_grays->isChecked()) { // if grays and blacks and whites filtered
-        Mat1b black_mask;
-        inRange(imageCopy, Vec3b(0, 0, 0), Vec3b(0, 0, 0), black_mask); // extract black pixels from image
-        if ((cv::sum(black_mask) != Scalar(0,0,0))) // image contains black pixels ?
-                ui->openGLWidget_3d->nb_palettes++; // add one color to asked number of colors in palette, to remove it later and get only colors
-    }
+    if (ui->openGLWidget_3d->palettes.Size() < ui->openGLWidget_3d->nb_palettes) // palette store too small ?
+        ui->openGLWidget_3d->palettes.Resize(ui->openGLWidget_3d->nb_palettes); // grow it
 
     // set palette values to 0;
     for (int n = 0; n < ui->openGLWidget_3d->nb_palettes; n++) {
-        ui->openGLWidget_3d->palettes[n].RGB.R = 0.0;
-        ui->openGLWidget_3d->palettes[n].RGB.G = 0.0;
-        ui->openGLWidget_3d->palettes[n].RGB.B = 0.0;
-        ui->openGLWidget_3d->palettes[n].count = 0;
-        ui->openGLWidget_3d->palettes[n].percentage = 0.0;
-        ui->openGLWidget_3d->palettes[n].selected = false; // color not selected
-        ui->openGLWidget_3d->palettes[n].visible = true; // color shown
+        ui->openGLWidget_3d->palettes.RGB[n].R = 0.0;
+        ui->openGLWidget_3d->palettes.RGB[n].G = 0.0;
+        ui->openGLWidget_3d->palettes.RGB[n].B = 0.0;
+        ui->openGLWidget_3d->palettes.count[n] = 0;
+        ui->openGLWidget_3d->palettes.percentage[n] = 0.0;
+        ui->openGLWidget_3d->palettes.selected[n] = false; // color not selected
+        ui->openGLWidget_3d->palettes.visible[n] = true; // color shown
     }
 
     if (ui->radioButton_eigenvectors->isChecked()) { // eigen method
-        cv::Mat cielab = ConvertImageRGBtoCIELab(imageCopy);
-        std::vector<cv::Vec3d> palette_vec = DominantColorsEigen(cielab, ui->openGLWidget_3d->nb_palettes, quantized); // get dominant palette, palette image and quantized image
-        quantized = ConvertImageCIELabToRGB(quantized);
+        cv::Mat cielab = ConvertImageRGBtoCIELab(proxy);
+        std::vector<cv::Vec3d> palette_vec = DominantColorsEigen(cielab, ui->openGLWidget_3d->nb_palettes, quantized, proxyMask); // get dominant palette, palette image and quantized image
+        if (coarseToFine) { // full size quantized image from the proxy palette
+            std::vector<cv::Vec3b> centerColors(palette_vec.size()); // BGR colors of the palette, rounded like the quantized image
+            for (int n = 0; n < int(palette_vec.size()); n++) {
+                double R, G, B;
+                CIELabToRGB(palette_vec[n][0], palette_vec[n][1], palette_vec[n][2], R, G, B);
+                centerColors[n] = Vec3b(round(B * 255.0), round(G * 255.0), round(R * 255.0));
+            }
+            quantized = QuantizeToNearestColors(imageCopy, palette_vec, centerColors, CentersCIELab, pixelMask); // excluded pixels are black
+        }
+        else {
+            quantized = ConvertImageCIELabToRGB(quantized);
+            if (!pixelMask.empty()) // excluded pixels in black
+                quantized.setTo(Vec3b(0, 0, 0), pixelMask == 0);
+        }
 
         /*for (int n = 0; n < ui->openGLWidget_3d->nb_palettes; n++) // store palette values in structured array
         {
             double R, G, B;
             CIELabToRGB(palette_vec[n][0], palette_vec[n][1], palette_vec[n][2], R, G, B);
             // RGB
-            ui->openGLWidget_3d->palettes[n].RGB.R = R;
-            ui->openGLWidget_3d->palettes[n].RGB.G = G;
-            ui->openGLWidget_3d->palettes[n].RGB.B = B;
+            ui->openGLWidget_3d->palettes.RGB[n].R = R;
+            ui->openGLWidget_3d->palettes.RGB[n].G = G;
+            ui->openGLWidget_3d->palettes.RGB[n].B = B;
         }*/
 
         // palette from quantized image
@@ -882,6 +960,8 @@ void MainWindow::Compute() // analyze image dominant colors
         int nbColor = 0; // current color
         for (int x = 0; x < quantized.cols; x++) // parse entire image
             for (int y = 0; y < quantized.rows; y++) {
+                if ((!pixelMask.empty()) and (pixelMask.at<uchar>(y, x) == 0)) // excluded pixel
+                    continue;
                 cv::Vec3b col = quantized.at<cv::Vec3b>(y, x); // current pixel color
                 bool found = false;
                 for (int i = 0; i < nbColor; i++) // look into temp palette
@@ -891,9 +971,9 @@ void MainWindow::Compute() // analyze image dominant colors
                     }
                 if (!found) { // color not already in temp palette
                     color[nbColor] = col; // save new color
-                    ui->openGLWidget_3d->palettes[nbColor].RGB.R = col[2] / 255.0; // copy RGB values to global palette
-                    ui->openGLWidget_3d->palettes[nbColor].RGB.G = col[1] / 255.0;
-                    ui->openGLWidget_3d->palettes[nbColor].RGB.B = col[0] / 255.0;
+                    ui->openGLWidget_3d->palettes.RGB[nbColor].R = col[2] / 255.0; // copy RGB values to global palette
+                    ui->openGLWidget_3d->palettes.RGB[nbColor].G = col[1] / 255.0;
+                    ui->openGLWidget_3d->palettes.RGB[nbColor].B = col[0] / 255.0;
                     nbColor++; // one more color
                 }
             }
@@ -902,94 +982,67 @@ void MainWindow::Compute() // analyze image dominant colors
     }
     else if (ui->radioButton_k_means->isChecked()) { // K-means method
         cv::Mat1f colors; // to store palette from K-means
-        quantized = DominantColorsKMeansRGB(imageCopy, ui->spinBox_nb_palettes->value(), colors); // get quantized image and palette
+        quantized = DominantColorsKMeansRGB(proxy, ui->spinBox_nb_palettes->value(), colors, proxyMask); // get quantized image and palette - excluded pixels are black
+        ui->openGLWidget_3d->nb_palettes = std::min(ui->openGLWidget_3d->nb_palettes, colors.rows); // fewer pixels than asked colors
+
+        if (coarseToFine) { // full size quantized image from the proxy palette
+            std::vector<cv::Vec3d> centers(colors.rows); // BGR cluster centers
+            std::vector<cv::Vec3b> centerColors(colors.rows); // rounded like the quantized image
+            for (int n = 0; n < colors.rows; n++) {
+                centers[n] = cv::Vec3d(colors(n, 0), colors(n, 1), colors(n, 2));
+                centerColors[n] = Vec3b(cv::saturate_cast<uchar>(colors(n, 0)), cv::saturate_cast<uchar>(colors(n, 1)), cv::saturate_cast<uchar>(colors(n, 2)));
+            }
+            quantized = QuantizeToNearestColors(imageCopy, centers, centerColors, CentersBGR, pixelMask); // excluded pixels are black
+        }
 
         for (int n = 0; n < ui->openGLWidget_3d->nb_palettes; n++) // store palette in structured array
         {
             // RGB
-            ui->openGLWidget_3d->palettes[n].RGB.R = double(colors(n, 2)) / 255.0;
-            ui->openGLWidget_3d->palettes[n].RGB.G = double(colors(n, 1)) / 255.0;
-            ui->openGLWidget_3d->palettes[n].RGB.B = double(colors(n, 0)) / 255.0;
+            ui->openGLWidget_3d->palettes.RGB[n].R = double(colors(n, 2)) / 255.0;
+            ui->openGLWidget_3d->palettes.RGB[n].G = double(colors(n, 1)) / 255.0;
+            ui->openGLWidget_3d->palettes.RGB[n].B = double(colors(n, 0)) / 255.0;
         }
         ui->openGLWidget_3d->ConvertPaletteFromRGB(); // convert RGB to other values
 
         //classification.release();
     }
 
-    // compute HSL values from RGB + compute hexa
-    for (int n = 0; n < ui->openGLWidget_3d->nb_palettes; n++) {
-        // HSL value
-        double C;
-        RGBtoHSL(ui->openGLWidget_3d->palettes[n].RGB.R, ui->openGLWidget_3d->palettes[n].RGB.G, ui->openGLWidget_3d->palettes[n].RGB.B,
-                 ui->openGLWidget_3d->palettes[n].HSL.H, ui->openGLWidget_3d->palettes[n].HSL.S, ui->openGLWidget_3d->palettes[n].HSL.L, C); // convert current color to HSL
-
-        // hexadecimal value
-        QString hex = QString(" %1").arg(((int(round(ui->openGLWidget_3d->palettes[n].RGB.R * 255.0)) & 0xff) << 16)
-                                       + ((int(round(ui->openGLWidget_3d->palettes[n].RGB.G * 255.0)) & 0xff) << 8)
-                                       +  (int(round(ui->openGLWidget_3d->palettes[n].RGB.B * 255.0)) & 0xff)
-                                         , 6, 16, QChar('0')).trimmed(); // compute hexa RGB value
-        hex = "#" + hex;
-        ui->openGLWidget_3d->palettes[n].hexa = hex.toUpper().toUtf8().constData();
-    }
-
     // clean palette : number of asked colors may be superior to number of colors found
-    int n = CountRGBUniqueValues(quantized); // how many colors in quantized image, really ?
+    int n = CountRGBUniqueValues(quantized, pixelMask); // how many colors in quantized image, really ?
     if (n < ui->openGLWidget_3d->nb_palettes) { // if asked number of colors exceeds total number of colors in image
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-                  [](const struct_palette& a, const struct_palette& b) {return a.hexa > b.hexa;}); // sort palette by hexa value, decreasing values
-        if ((ui->openGLWidget_3d->palettes[0].RGB.R == ui->openGLWidget_3d->palettes[1].RGB.R)
-                and (ui->openGLWidget_3d->palettes[0].RGB.G == ui->openGLWidget_3d->palettes[1].RGB.G)
-                and (ui->openGLWidget_3d->palettes[0].RGB.B == ui->openGLWidget_3d->palettes[1].RGB.B)) // if first color in palette is equal to second we have to reverse sort by percentage
-            std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-                      [](const struct_palette& a, const struct_palette& b) {return a.hexa > b.hexa;}); // sort the palette, this time by increasing hexa values
+        ui->openGLWidget_3d->palettes.Sort(ui->openGLWidget_3d->nb_palettes,
+                  [this](const int &a, const int &b) {return ui->openGLWidget_3d->palettes.RGB24[a] > ui->openGLWidget_3d->palettes.RGB24[b];}); // sort palette by hexa value, decreasing values
+        if ((ui->openGLWidget_3d->palettes.RGB[0].R == ui->openGLWidget_3d->palettes.RGB[1].R)
+                and (ui->openGLWidget_3d->palettes.RGB[0].G == ui->openGLWidget_3d->palettes.RGB[1].G)
+                and (ui->openGLWidget_3d->palettes.RGB[0].B == ui->openGLWidget_3d->palettes.RGB[1].B)) // if first color in palette is equal to second we have to reverse sort by percentage
+            ui->openGLWidget_3d->palettes.Sort(ui->openGLWidget_3d->nb_palettes,
+                      [this](const int &a, const int &b) {return ui->openGLWidget_3d->palettes.RGB24[a] > ui->openGLWidget_3d->palettes.RGB24[b];}); // sort the palette, this time by increasing hexa values
         ui->openGLWidget_3d->nb_palettes = n; // new number of colors in palette
         ui->spinBox_nb_palettes->setValue(ui->openGLWidget_3d->nb_palettes); // show new number of colors
     }
 
-    int total = quantized.rows * quantized.cols; // size of quantized image in pixels
-
-    // delete blacks in palette if needed
-    bool black_found = false;
-    if (ui->checkBox_filter_grays->isChecked()) { // delete last "black" values in palette
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-              [](const struct_palette& a, const struct_palette& b) {return a.HSL.L > b.HSL.L;}); // sort palette by lightness value
-        while (ui->openGLWidget_3d->palettes[ui->openGLWidget_3d->nb_palettes - 1].HSL.L < 0.15) { // at the end of palette, find black colors
-            Mat1b black_mask;
-            inRange(quantized, Vec3b(int(round(ui->openGLWidget_3d->palettes[ui->openGLWidget_3d->nb_palettes - 1].RGB.B * 255.0)), int(round(ui->openGLWidget_3d->palettes[ui->openGLWidget_3d->nb_palettes - 1].RGB.G * 255.0)), int(round(ui->openGLWidget_3d->palettes[ui->openGLWidget_3d->nb_palettes - 1].RGB.R * 255.0))),
-                               Vec3b(int(round(ui->openGLWidget_3d->palettes[ui->openGLWidget_3d->nb_palettes - 1].RGB.B * 255.0)), int(round(ui->openGLWidget_3d->palettes[ui->openGLWidget_3d->nb_palettes - 1].RGB.G * 255.0)), int(round(ui->openGLWidget_3d->palettes[ui->openGLWidget_3d->nb_palettes - 1].RGB.R * 255.0))),
-                               black_mask); // extract black color from image
-            int c = countNonZero(black_mask);
-            total = total - c; // update total pixel count
-            ui->openGLWidget_3d->nb_palettes--; // exclude this black color from palette
-            if (c > 0) // really found black color ?
-                black_found = true; // black color found !
-        }
-        if (black_found) { // if black color found
-            ui->spinBox_nb_palettes->setValue(ui->openGLWidget_3d->nb_palettes); // show new number of colors without black values
-        }
-    }
+    auto CountColor = [&](const int &n) { // pixels analyzed with color n of palette in quantized image
+        const Vec3b color(int(round(ui->openGLWidget_3d->palettes.RGB[n].B * 255.0)), int(round(ui->openGLWidget_3d->palettes.RGB[n].G * 255.0)), int(round(ui->openGLWidget_3d->palettes.RGB[n].R * 255.0)));
+        Mat1b mask; // current color mask
+        inRange(quantized, color, color, mask); // create mask for current color
+        if (!pixelMask.empty()) // excluded pixels don't count
+            mask &= pixelMask;
+        return cv::countNonZero(mask); // count pixels in this mask
+    };
 
     // compute percentages
     for (int n = 0;n < ui->openGLWidget_3d->nb_palettes; n++) { // for each color in palette
-        Mat1b mask; // current color mask
-        inRange(quantized, Vec3b(int(round(ui->openGLWidget_3d->palettes[n].RGB.B * 255.0)), int(round(ui->openGLWidget_3d->palettes[n].RGB.G * 255.0)), int(round(ui->openGLWidget_3d->palettes[n].RGB.R * 255.0))),
-                           Vec3b(int(round(ui->openGLWidget_3d->palettes[n].RGB.B * 255.0)), int(round(ui->openGLWidget_3d->palettes[n].RGB.G * 255.0)), int(round(ui->openGLWidget_3d->palettes[n].RGB.R * 255.0))),
-                           mask); // create mask for current color
-        ui->openGLWidget_3d->palettes[n].count = cv::countNonZero(mask); // count pixels in this mask
-        ui->openGLWidget_3d->palettes[n].percentage = double(ui->openGLWidget_3d->palettes[n].count) / double(total); // compute color use percentage
+        ui->openGLWidget_3d->palettes.count[n] = CountColor(n);
+        ui->openGLWidget_3d->palettes.percentage[n] = double(ui->openGLWidget_3d->palettes.count[n]) / double(total); // compute color use percentage
     }
 
     // delete non significant values in palette by percentage
     if (ui->checkBox_filter_percent->isChecked()) { // filter by x% ?
         bool cleaning_found = false; // indicator
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-              [](const struct_palette& a, const struct_palette& b) {return a.percentage > b.percentage;}); // sort palette by percentage
-        while (double(ui->openGLWidget_3d->palettes[ui->openGLWidget_3d->nb_palettes - 1].count) / double(total) < double(ui->spinBox_nb_percentage->value()) / 100.0) { // at the end of palette, find values < x%
-            Mat1b cleaning_mask;
-            inRange(quantized, Vec3b(int(round(ui->openGLWidget_3d->palettes[ui->openGLWidget_3d->nb_palettes - 1].RGB.B * 255.0)), int(round(ui->openGLWidget_3d->palettes[ui->openGLWidget_3d->nb_palettes - 1].RGB.G * 255.0)), int(round(ui->openGLWidget_3d->palettes[ui->openGLWidget_3d->nb_palettes - 1].RGB.R * 255.0))),
-                               Vec3b(int(round(ui->openGLWidget_3d->palettes[ui->openGLWidget_3d->nb_palettes - 1].RGB.B * 255.0)), int(round(ui->openGLWidget_3d->palettes[ui->openGLWidget_3d->nb_palettes - 1].RGB.G * 255.0)), int(round(ui->openGLWidget_3d->palettes[ui->openGLWidget_3d->nb_palettes - 1].RGB.R * 255.0))),
-                               cleaning_mask); // extract color from image
-            int c = countNonZero(cleaning_mask); // count occurences
+        ui->openGLWidget_3d->palettes.Sort(ui->openGLWidget_3d->nb_palettes,
+              [this](const int &a, const int &b) {return ui->openGLWidget_3d->palettes.percentage[a] > ui->openGLWidget_3d->palettes.percentage[b];}); // sort palette by percentage
+        while (double(ui->openGLWidget_3d->palettes.count[ui->openGLWidget_3d->nb_palettes - 1]) / double(total) < double(ui->spinBox_nb_percentage->value()) / 100.0) { // at the end of palette, find values < x%
+            int c = CountColor(ui->openGLWidget_3d->nb_palettes - 1); // count occurences
             total = total - c; // update total pixel count
             ui->openGLWidget_3d->nb_palettes--; // exclude this color from palette
             if (c > 0) // really found this color ?
@@ -999,38 +1052,108 @@ void MainWindow::Compute() // analyze image dominant colors
             ui->spinBox_nb_palettes->setValue(ui->openGLWidget_3d->nb_palettes); // show new number of colors without cleaned values
             // re-compute percentages
             for (int n = 0;n < ui->openGLWidget_3d->nb_palettes; n++) // for each color in palette
-                ui->openGLWidget_3d->palettes[n].percentage = double(ui->openGLWidget_3d->palettes[n].count) / double(total); // update percentage
+                ui->openGLWidget_3d->palettes.percentage[n] = double(ui->openGLWidget_3d->palettes.count[n]) / double(total); // update percentage
         }
     }
 
-    // find color name by euclidian distance
-    for (int n = 0;n < ui->openGLWidget_3d->nb_palettes; n++) { // for each color in palette
-        bool found = false;
-        int distance = 1000000; // distance formula can never reach this high
-        int index; // to keep nearest color index in color names table
+    SetPaletteNames(); // find color names
 
-        for (int c = 0; c < nb_color_names; c++) { // search in color names table
-            int d = pow(ui->openGLWidget_3d->palettes[n].RGB.R * 255.0 - color_names[c].R, 2) + pow(ui->openGLWidget_3d->palettes[n].RGB.G * 255.0 - color_names[c].G, 2) + pow(ui->openGLWidget_3d->palettes[n].RGB.B * 255.0 - color_names[c].B, 2); // euclidian distance
-            if (d == 0) { // exact RGB values found
-                ui->openGLWidget_3d->palettes[n].name = color_names[c].name.toUtf8().constData(); // assign color name
-                found = true; // color found in palette
-                break; // get out of loop
-            }
-            else {
-                if (d < distance) { // if distance is smaller
-                    distance = d; // new distance
-                    index = c; // keep index
-                }
-            }
+    SortPalettes(); // sort and create palette image
+
+    // reset UI elements
+    ui->spinBox_nb_palettes->setStyleSheet("QSpinBox{color:black;}"); // show number of colors in black (in case it was red before)
+    ui->label_color_bar->setPixmap(QPixmap()); // reset picked color
+    ui->label_color_bar->setText("Pick\nColor");
+    ui->label_color_r->setText("R"); // show RGB values
+    ui->label_color_g->setText("G");
+    ui->label_color_b->setText("B");
+    ui->label_color_hex->setText("Hex");
+    ui->label_color_percentage->setText("");
+    ui->label_color_name->setText("");
+    if (ui->openGLWidget_3d->nb_palettes < nb_palettes_asked) { // more colors asked than were really found ?
+        ui->spinBox_nb_palettes->setStyleSheet("QSpinBox{color:red;}"); // show new number of colors in red
+        ui->spinBox_nb_palettes->setValue(ui->openGLWidget_3d->nb_palettes); // show new number of colors
+    }
+
+    ui->openGLWidget_3d->update(); // show 3D view
+    ShowImages(); // show result images
+
+    ShowTimer(false); // show elapsed time
+    QApplication::restoreOverrideCursor(); // Restore cursor
+
+    computed = true; // success !
+}
+
+void MainWindow::ComputeLUT() // analyze LUT output colors : each entry is a weighted sample, no image pipeline
+{
+    QApplication::setOverrideCursor(Qt::WaitCursor); // wait cursor
+    timer.start(); // start of elapsed time
+    ShowTimer(true); // show elapsed time
+    qApp->processEvents();
+
+    const int nb_palettes_asked = ui->spinBox_nb_palettes->value(); // how many dominant colors
+    ui->spinBox_nb_palettes->setStyleSheet("QSpinBox{color:black;}"); // show number of colors in black (in case it was red before)
+
+    std::vector<int> labels; // cluster of each LUT entry
+    std::vector<cv::Vec3d> colors; // RGB values of clusters in [0..1]
+    if (ui->radioButton_eigenvectors->isChecked()) { // eigen method, in CIELab like images
+        std::vector<cv::Vec3d> cielab(lutColors.size());
+        #pragma omp parallel for
+        for (int n = 0; n < int(lutColors.size()); n++)
+            RGBtoCIELab(lutColors[n][0], lutColors[n][1], lutColors[n][2], cielab[n][0], cielab[n][1], cielab[n][2]);
+
+        colors = DominantColorsEigenSamples(cielab, lutWeights, nb_palettes_asked, labels);
+        for (cv::Vec3d &color : colors) { // back to RGB
+            double R, G, B;
+            CIELabToRGB(color[0], color[1], color[2], R, G, B);
+            color = cv::Vec3d(R, G, B);
         }
-        if (!found) // picked color not found in palette so display nearest color
-            ui->openGLWidget_3d->palettes[n].name = color_names[index].name.toUtf8().constData(); // assign color name
     }
+    else // K-means method, in RGB like images
+        colors = DominantColorsKMeansSamples(lutColors, lutWeights, nb_palettes_asked, labels);
+
+    std::vector<int> counts(colors.size(), 0); // entries in each cluster
+    std::vector<double> weights(colors.size(), 0.0); // weight of each cluster
+    double total = 0;
+    for (int n = 0; n < int(labels.size()); n++) {
+        counts[labels[n]]++;
+        weights[labels[n]] += lutWeights[n];
+        total += lutWeights[n];
+    }
+
+    if (ui->openGLWidget_3d->palettes.Size() < int(colors.size())) // palette store too small ?
+        ui->openGLWidget_3d->palettes.Resize(colors.size()); // grow it
+
+    std::vector<int> index(colors.size(), -1); // palette index of each cluster
+    int nb = 0; // non-empty clusters
+    for (int c = 0; c < int(colors.size()); c++) {
+        if (counts[c] == 0)
+            continue;
+        ui->openGLWidget_3d->palettes.RGB[nb].R = std::min(std::max(colors[c][0], 0.0), 1.0);
+        ui->openGLWidget_3d->palettes.RGB[nb].G = std::min(std::max(colors[c][1], 0.0), 1.0);
+        ui->openGLWidget_3d->palettes.RGB[nb].B = std::min(std::max(colors[c][2], 0.0), 1.0);
+        ui->openGLWidget_3d->palettes.count[nb] = counts[c];
+        ui->openGLWidget_3d->palettes.percentage[nb] = weights[c] / total; // weighted percentage
+        ui->openGLWidget_3d->palettes.selected[nb] = false; // color not selected
+        ui->openGLWidget_3d->palettes.visible[nb] = true; // color shown
+        index[c] = nb;
+        nb++;
+    }
+    ui->openGLWidget_3d->nb_palettes = nb;
+    ui->openGLWidget_3d->ConvertPaletteFromRGB(); // convert RGB to other values
+
+    quantized = cv::Mat(1, labels.size(), CV_8UC3); // LUT colors replaced by their dominant color
+    cv::Vec3b* quantizedP = quantized.ptr<cv::Vec3b>(0);
+    for (int n = 0; n < int(labels.size()); n++) {
+        const int p = index[labels[n]];
+        quantizedP[n] = cv::Vec3b(round(ui->openGLWidget_3d->palettes.RGB[p].B * 255.0), round(ui->openGLWidget_3d->palettes.RGB[p].G * 255.0), round(ui->openGLWidget_3d->palettes.RGB[p].R * 255.0));
+    }
+
+    SetPaletteNames(); // find color names
 
     SortPalettes(); // sort and create palette image
 
     // reset UI elements
-    ui->spinBox_nb_palettes->setStyleSheet("QSpinBox{color:black;}"); // show number of colors in black (in case it was red before)
     ui->label_color_bar->setPixmap(QPixmap()); // reset picked color
     ui->label_color_bar->setText("Pick\nColor");
     ui->label_color_r->setText("R"); // show RGB values
@@ -1053,6 +1176,32 @@ void MainWindow::Compute() // analyze image dominant colors
     computed = true; // success !
 }
 
+void MainWindow::SetPaletteNames() // find color name of each palette color by euclidian distance
+{
+    for (int n = 0;n < ui->openGLWidget_3d->nb_palettes; n++) { // for each color in palette
+        bool found = false;
+        int distance = 1000000; // distance formula can never reach this high
+        int index; // to keep nearest color index in color names table
+
+        for (int c = 0; c < nb_color_names; c++) { // search in color names table
+            int d = pow(ui->openGLWidget_3d->palettes.RGB[n].R * 255.0 - color_names[c].R, 2) + pow(ui->openGLWidget_3d->palettes.RGB[n].G * 255.0 - color_names[c].G, 2) + pow(ui->openGLWidget_3d->palettes.RGB[n].B * 255.0 - color_names[c].B, 2); // euclidian distance
+            if (d == 0) { // exact RGB values found
+                ui->openGLWidget_3d->palettes.SetName(n, color_names[c].name.toUtf8().constData()); // assign color name
+                found = true; // color found in palette
+                break; // get out of loop
+            }
+            else {
+                if (d < distance) { // if distance is smaller
+                    distance = d; // new distance
+                    index = c; // keep index
+                }
+            }
+        }
+        if (!found) // picked color not found in palette so display nearest color
+            ui->openGLWidget_3d->palettes.SetName(n, color_names[index].name.toUtf8().constData()); // assign color name
+    }
+}
+
 void MainWindow::ShowImages() // display result images in GUI
 {
     if (!thumbnail.empty())
@@ -1063,8 +1212,8 @@ void MainWindow::ShowImages() // display result images in GUI
         quantized.copyTo(selected);
         bool found = false;
         for (int n = 0; n < ui->openGLWidget_3d->nb_palettes; n++) {
-            if (ui->openGLWidget_3d->palettes[n].selected) {
-                Mat mask = quantized == Vec3b(round(ui->openGLWidget_3d->palettes[n].RGB.B * 255.0), round(ui->openGLWidget_3d->palettes[n].RGB.G * 255.0), round(ui->openGLWidget_3d->palettes[n].RGB.R * 255.0));
+            if (ui->openGLWidget_3d->palettes.selected[n]) {
+                Mat mask = quantized == Vec3b(round(ui->openGLWidget_3d->palettes.RGB[n].B * 255.0), round(ui->openGLWidget_3d->palettes.RGB[n].G * 255.0), round(ui->openGLWidget_3d->palettes.RGB[n].R * 255.0));
                 selected.setTo(Vec3b(255,255,255), mask);
                 found = true;
             }
@@ -1102,47 +1251,42 @@ void MainWindow::SortPalettes() // sort palette values and create palette image
     if (ui->openGLWidget_3d->nb_palettes < 1) // no palette -> get out
         return;
 
-    // sort by type
-    if (ui->comboBox_sort->currentText() == "Percentage")
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-                  [](const struct_palette& a, const struct_palette& b) {return a.percentage > b.percentage;});
-    else if (ui->comboBox_sort->currentText() == "Lightness")
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-                  [](const struct_palette& a, const struct_palette& b) {return a.HSL.L > b.HSL.L;});
-    else if (ui->comboBox_sort->currentText() == "Luminance")
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-                  [](const struct_palette& a, const struct_palette& b) {return a.XYZ.Y > b.XYZ.Y;});
-    else if (ui->comboBox_sort->currentText() == "Hue")
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-                  [](const struct_palette& a, const struct_palette& b) {return a.HSV.H > b.HSV.H;});
-    else if (ui->comboBox_sort->currentText() == "Saturation")
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-                  [](const struct_palette& a, const struct_palette& b) {return a.HSV.S > b.HSV.S;});
-    else if (ui->comboBox_sort->currentText() == "Chroma")
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-                  [](const struct_palette& a, const struct_palette& b) {return a.HSV.C > b.HSV.C;});
-    else if (ui->comboBox_sort->currentText() == "Value")
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-                  [](const struct_palette& a, const struct_palette& b) {return a.HSV.V > b.HSV.V;});
-    else if (ui->comboBox_sort->currentText() == "Distance")
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-                  [](const struct_palette& a, const struct_palette& b)
-                    {return pow(1-a.RGB.R, 2) + pow(1-a.RGB.G, 2) + pow(1-a.RGB.B, 2) > pow(1-b.RGB.R, 2) + pow(1-b.RGB.G, 2) + pow(1-b.RGB.B, 2);});
-    else if (ui->comboBox_sort->currentText() == "Whiteness")
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-                  [](const struct_palette& a, const struct_palette& b) {return a.HWB.W > b.HWB.W;});
-    else if (ui->comboBox_sort->currentText() == "Blackness")
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-                  [](const struct_palette& a, const struct_palette& b) {return a.HWB.B > b.HWB.B;});
-    else if (ui->comboBox_sort->currentText() == "RGB")
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-                  [](const struct_palette& a, const struct_palette& b) {return a.hexa < b.hexa;});
-    else if (ui->comboBox_sort->currentText() == "Luma") // Luma = Sqrt(0.241*R + 0.691*G + 0.068*B)
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-                  [](const struct_palette& a, const struct_palette& b) {return 0.241 * a.RGB.R + 0.691 * a.RGB.G + 0.068 * a.RGB.B < 0.241 * b.RGB.R + 0.691 * b.RGB.G + 0.068 * b.RGB.B;});
-    else if (ui->comboBox_sort->currentText() == "Rainbow6") // Hue + Luma
-        std::sort(ui->openGLWidget_3d->palettes, ui->openGLWidget_3d->palettes + ui->openGLWidget_3d->nb_palettes,
-                  [](const struct_palette& a, const struct_palette& b) {return int(a.HSL.H * 60.0) + sqrt(0.241 * a.RGB.R + 0.691 * a.RGB.G + 0.068 * a.RGB.B) < int(b.HSL.H * 60.0) + sqrt(0.241 * b.RGB.R + 0.691 * b.RGB.G + 0.068 * b.RGB.B);});
+    // compute one numeric key per value, then stable radix sort - descending sorts use reversed keys
+    const int nb = ui->openGLWidget_3d->nb_palettes;
+    const PaletteStore &p = ui->openGLWidget_3d->palettes;
+    const SortType sortType = SortType(ui->comboBox_sort->currentData().toInt()); // sort type from combobox
+    std::vector<uint64_t> keys(nb);
+
+    for (int n = 0; n < nb; n++) {
+        switch (sortType) {
+            case SortPercentage: keys[n] = PaletteStore::SortKey(p.percentage[n], true); break;
+            case SortHue:        keys[n] = PaletteStore::SortKey(p.HSV[n].H, true); break;
+            case SortChroma:     keys[n] = PaletteStore::SortKey(p.HSV[n].C, true); break;
+            case SortSaturation: keys[n] = PaletteStore::SortKey(p.HSV[n].S, true); break;
+            case SortValue:      keys[n] = PaletteStore::SortKey(p.HSV[n].V, true); break;
+            case SortLightness:  keys[n] = PaletteStore::SortKey(p.HSL[n].L, true); break;
+            case SortLuminance:  keys[n] = PaletteStore::SortKey(p.XYZ[n].Y, true); break;
+            case SortDistance: // distance from white
+                keys[n] = PaletteStore::SortKey((1.0 - p.RGB[n].R) * (1.0 - p.RGB[n].R)
+                                              + (1.0 - p.RGB[n].G) * (1.0 - p.RGB[n].G)
+                                              + (1.0 - p.RGB[n].B) * (1.0 - p.RGB[n].B), true);
+                break;
+            case SortWhiteness:  keys[n] = PaletteStore::SortKey(p.HWB[n].W, true); break;
+            case SortBlackness:  keys[n] = PaletteStore::SortKey(p.HWB[n].B, true); break;
+            case SortRGB:        keys[n] = uint64_t(p.RGB24[n]); break; // packed 0xRRGGBB is already an integer key
+            case SortLuma:       keys[n] = PaletteStore::SortKey(0.241 * p.RGB[n].R + 0.691 * p.RGB[n].G + 0.068 * p.RGB[n].B); break;
+            case SortRainbow6: { // Hue + Luma : composite key, hue sector in high bits and sqrt(luma) in low 48 bits
+                uint64_t sector = uint64_t(std::max(0, int(p.HSL[n].H * 60.0)));
+                double luma = std::min(1.0, std::max(0.0, sqrt(0.241 * p.RGB[n].R + 0.691 * p.RGB[n].G + 0.068 * p.RGB[n].B)));
+                keys[n] = (sector << 48) + uint64_t(luma * double((1ULL << 48) - 1));
+                break;
+            }
+        }
+    }
+
+    ui->openGLWidget_3d->palettes.SortByKeys(keys); // sort
+    ui->openGLWidget_3d->PaletteChanged(); // order changed : positions of spheres must be computed again
+    ui->openGLWidget_3d->update();
 
     // create palette image - could be a mess over 250 values
     palette = Mat::zeros(cv::Size(palette_width, palette_height), CV_8UC3); // create blank palette image
@@ -1150,10 +1294,10 @@ void MainWindow::SortPalettes() // sort palette values and create palette image
     for (int n = 0;n < ui->openGLWidget_3d->nb_palettes; n++) { // for each color in palette
         cv::rectangle(palette, Rect(round(offset), 0,
                                     palette_width, palette_height),
-                                    Vec3b(round(ui->openGLWidget_3d->palettes[n].RGB.B * 255.0),
-                                          round(ui->openGLWidget_3d->palettes[n].RGB.G * 255.0),
-                                          round(ui->openGLWidget_3d->palettes[n].RGB.R * 255.0)), -1); // rectangle of current color
-        offset += round(ui->openGLWidget_3d->palettes[n].percentage * double(palette_width)); // next x position in palette
+                                    Vec3b(round(ui->openGLWidget_3d->palettes.RGB[n].B * 255.0),
+                                          round(ui->openGLWidget_3d->palettes.RGB[n].G * 255.0),
+                                          round(ui->openGLWidget_3d->palettes.RGB[n].R * 255.0)), -1); // rectangle of current color
+        offset += round(ui->openGLWidget_3d->palettes.percentage[n] * double(palette_width)); // next x position in palette
     }
     if (offset <= palette_width) {
         cv::Rect crop(0, 0, offset, palette_height);
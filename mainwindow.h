@@ -23,6 +23,7 @@
 #include <QElapsedTimer>
 
 #include "openglwidget.h"
+#include "lib/image-lut.h"
 
 namespace Ui {
 class MainWindow;
@@ -56,6 +57,7 @@ private slots:
     //// load & save
     void ChangeBaseDir(QString filename); // set base dir and file
     void SaveDirBaseFile(); // just to keep the last open dir
+    std::string LUTCacheDir(); // folder of compiled LUTs, created if needed
 
     //// GUI
     void on_button_load_image_clicked(); // load image to analyze
@@ -66,7 +68,9 @@ private slots:
     void on_comboBox_color_space_currentIndexChanged(int index); // change color space
     void on_comboBox_sort_currentIndexChanged(int index); // sort palette
     void on_checkBox_3d_light_clicked(); // light on/off in 3D scene
+    void on_checkBox_3d_pixels_clicked(); // show all colors of the image as points in 3D scene
     void on_checkBox_3d_fullscreen_clicked(); // view 3D scene fullscreen, <ESC> to return from it
+    void on_checkBox_apply_lut_clicked(); // choose LUTs applied to the image before analysis
     void on_button_3d_exit_fullscreen_clicked(); // exit fullscreen view of 3d scene
     void on_button_save_3d_clicked(); // save current view of 3D color space
     void on_button_3d_reset_flags_clicked(); // reset visibility and selection flags in 3D view
@@ -88,14 +92,24 @@ private:
 
     //// General
     void Compute(); // compute dominant colors
+    void ComputeLUT(); // compute dominant colors of LUT output colors
+    void SetPaletteNames(); // nearest color name of each palette color
     void SortPalettes(); // sort palettes
     QString ConvertColor(const double &R, const double &G, const double &B); // convert a RGB color to other color spaces
 
     //// Variables
 
+    enum SortType {SortPercentage, SortHue, SortChroma, SortSaturation, SortValue, SortLightness, SortLuminance,
+                   SortDistance, SortWhiteness, SortBlackness, SortRGB, SortLuma, SortRainbow6}; // palette sort types - stored as comboBox_sort items data
+
     std::string basefile, basedir, basedirinifile; // main image filename: directory and filename without extension
     bool loaded, computed; // indicators: image loaded or computed
+    bool lutLoaded; // a LUT is analyzed instead of an image
+    std::vector<cv::Vec3d> lutColors; // RGB output colors of all LUT entries in [0..1]
+    std::vector<double> lutWeights; // weight of each LUT entry
+    CubeLUT gradingLUT; // LUTs applied to the image before analysis, composed in one table
     cv::Mat image, // main image
+            imageMask, // pixels analyzed, from the alpha channel of the image - empty = all pixels
             thumbnail, // thumbnail of main image
             quantized, // quantized image
             //classification, // classification image
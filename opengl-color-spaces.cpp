@@ -0,0 +1,998 @@
+/*#-------------------------------------------------
+#
+#      Color spaces render modules for OpenGL
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   - one module per color space, indexed by enum :
+#       . palette to 3D positions (batch)
+#       . same positions in GLSL for the common
+#         color spaces
+#       . scaffold : axes, circles, curves, labels
+#       . default camera
+#
+#-------------------------------------------------*/
+
+#include <QtOpenGL>
+
+#include <algorithm>
+
+#include "opengl-color-spaces.h"
+#include "opengl-draw.h"
+#include "lib/angles.h"
+#include "lib/color-spaces.h"
+
+using namespace std;
+
+///////////////////////////////////////////////
+//// Render modules table
+///////////////////////////////////////////////
+
+const struct_color_space_3d ColorSpaces3D[ColorSpace3DCount] = { // name, positions, scaffold, extended values needed, positions in GLSL, default rotation x/y/z, default zoom
+    {"RGB",          PositionsRGB,          ScaffoldRGB,          false, true,   287, 0,   300,  4}, // ColorSpaceRGB
+    {"RGB Triangle", PositionsRGBTriangle,  ScaffoldRGBTriangle,  false, true,   26,  30,  180,  4}, // ColorSpaceRGBTriangle
+    {"HSV",          PositionsHSV,          ScaffoldHSV,          false, true,   280, 0,   90,   4}, // ColorSpaceHSV
+    {"HSL",          PositionsHSL,          ScaffoldHSL,          false, true,   280, 0,   90,   4}, // ColorSpaceHSL
+    {"HWB",          PositionsHWB,          ScaffoldHWB,          false, false,  100, 0,   -90,  4}, // ColorSpaceHWB
+    {"HCV",          PositionsHCV,          ScaffoldHCV,          false, true,   280, 0,   90,   4}, // ColorSpaceHCV
+    {"HCL",          PositionsHCL,          ScaffoldHCL,          false, true,   280, 0,   90,   4}, // ColorSpaceHCL
+    {"CIE XYZ",      PositionsXYZ,          ScaffoldXYZ,          false, true,   287, 0,   280,  4}, // ColorSpaceXYZ
+    {"LMS",          PositionsLMS,          ScaffoldLMS,          true,  false,  287, 0,   300,  4}, // ColorSpaceLMS
+    {"CIE xyY",      PositionsXYY,          ScaffoldXYY,          false, true,   210, 240, 270,  4}, // ColorSpaceXYY
+    {"CIE L*u*v*",   PositionsLUV,          ScaffoldLUV,          false, false,  280, 0,   120,  4}, // ColorSpaceLUV
+    {"CIE L*a*b*",   PositionsCIELAB,       ScaffoldCIELAB,       false, true,   290, 0,   120,  4}, // ColorSpaceCIELAB
+    {"OKLAB",        PositionsOKLAB,        ScaffoldOKLAB,        false, true,   290, 0,   120,  4}, // ColorSpaceOKLAB
+    {"Hunter Lab",   PositionsHLAB,         ScaffoldHLAB,         true,  false,  290, 0,   120,  4}, // ColorSpaceHLAB
+    {"CIE LCHab",    PositionsLCHAB,        ScaffoldLCHAB,        false, false,  290, 0,   120,  4}, // ColorSpaceLCHAB
+    {"CIE LCHuv",    PositionsLCHUV,        ScaffoldLCHUV,        true,  false,  280, 0,   120,  4}, // ColorSpaceLCHUV
+    {"Wheel",        PositionsWheel,        ScaffoldWheel,        false, true,   180, 0,   -90,  4}, // ColorSpaceWheel
+};
+
+///////////////////////////////////////////////
+//// Positions in GLSL
+////    from sRGB values in [0..1], same formulas
+////    as the color-spaces library
+///////////////////////////////////////////////
+
+std::string ColorSpacePositionsGLSL() // GLSL function "vec3 ColorSpacePosition(int space, vec3 rgb)" - DrawSpherePlus coordinates before size3d
+{
+    std::string defines; // enum values, so the shader follows the table
+    defines += "#define COLORSPACE_RGB " + std::to_string(ColorSpaceRGB) + "\n";
+    defines += "#define COLORSPACE_RGBTRIANGLE " + std::to_string(ColorSpaceRGBTriangle) + "\n";
+    defines += "#define COLORSPACE_HSV " + std::to_string(ColorSpaceHSV) + "\n";
+    defines += "#define COLORSPACE_HSL " + std::to_string(ColorSpaceHSL) + "\n";
+    defines += "#define COLORSPACE_HCV " + std::to_string(ColorSpaceHCV) + "\n";
+    defines += "#define COLORSPACE_HCL " + std::to_string(ColorSpaceHCL) + "\n";
+    defines += "#define COLORSPACE_XYZ " + std::to_string(ColorSpaceXYZ) + "\n";
+    defines += "#define COLORSPACE_XYY " + std::to_string(ColorSpaceXYY) + "\n";
+    defines += "#define COLORSPACE_CIELAB " + std::to_string(ColorSpaceCIELAB) + "\n";
+    defines += "#define COLORSPACE_OKLAB " + std::to_string(ColorSpaceOKLAB) + "\n";
+    defines += "#define COLORSPACE_WHEEL " + std::to_string(ColorSpaceWheel) + "\n";
+
+    return defines +
+        "const float Pi2 = 6.28318530717959;\n"
+        "float Hue(vec3 c, float cmax, float diff)\n" // same as RGBtoHSV and RGBtoHSL, in [0..1]
+        "{\n"
+        "    if (diff <= 0.0)\n"
+        "        return 0.0;\n"
+        "    float h;\n"
+        "    if (cmax == c.r)\n"
+        "        h = mod((c.g - c.b) / diff, 6.0);\n"
+        "    else if (cmax == c.g)\n"
+        "        h = (c.b - c.r) / diff + 2.0;\n"
+        "    else\n"
+        "        h = (c.r - c.g) / diff + 4.0;\n"
+        "    return fract(h / 6.0);\n"
+        "}\n"
+        "vec3 ColorSpacePosition(int space, vec3 c)\n"
+        "{\n"
+        "    float cmax = max(max(c.r, c.g), c.b);\n"
+        "    float cmin = min(min(c.r, c.g), c.b);\n"
+        "    float diff = cmax - cmin;\n" // chroma
+        "    float H = Hue(c, cmax, diff);\n"
+        "    float L = (cmax + cmin) / 2.0;\n" // HSL lightness
+        "    if (space == COLORSPACE_RGB)\n"
+        "        return c.grb;\n"
+        "    if (space == COLORSPACE_RGBTRIANGLE)\n"
+        "        return c.grb / (c.r + c.g + c.b);\n"
+        "    if (space == COLORSPACE_HSV) {\n"
+        "        float S = (cmax > 0.0) ? diff / cmax : 0.0;\n"
+        "        return vec3(S * cos(-H * Pi2), S * sin(-H * Pi2), cmax);\n"
+        "    }\n"
+        "    if (space == COLORSPACE_HSL) {\n"
+        "        float S = (diff <= 0.0) ? 0.0 : ((L < 0.5) ? diff / (cmax + cmin) : diff / (2.0 - cmax - cmin));\n"
+        "        return vec3(S * cos(-H * Pi2), S * sin(-H * Pi2), L);\n"
+        "    }\n"
+        "    if (space == COLORSPACE_HCV)\n"
+        "        return vec3(diff * cos(-H * Pi2), diff * sin(-H * Pi2), cmax);\n"
+        "    if (space == COLORSPACE_HCL)\n"
+        "        return vec3(diff * cos(-H * Pi2), diff * sin(-H * Pi2), L);\n"
+        "    if (space == COLORSPACE_WHEEL)\n"
+        "        return vec3(L * cos(H * Pi2), L * sin(H * Pi2), 0.0);\n"
+        "    vec3 lin = mix(c / 12.92, pow((c + 0.055) / 1.055, vec3(2.4)), greaterThan(c, vec3(0.04045)));\n" // RGBtoLinear
+        "    if (space == COLORSPACE_OKLAB) {\n"
+        "        vec3 lms = vec3(0.4122214708 * lin.r + 0.5363325363 * lin.g + 0.0514459929 * lin.b,\n"
+        "                        0.2119034982 * lin.r + 0.6806995451 * lin.g + 0.1073969566 * lin.b,\n"
+        "                        0.0883024619 * lin.r + 0.2817188376 * lin.g + 0.6299787005 * lin.b);\n"
+        "        lms = pow(lms, vec3(1.0 / 3.0));\n"
+        "        float l = 0.2104542553 * lms.x + 0.7936177850 * lms.y - 0.0040720468 * lms.z;\n"
+        "        float a = 1.9779984951 * lms.x - 2.4285922050 * lms.y + 0.4505937099 * lms.z;\n"
+        "        float b = 0.0259040371 * lms.x + 0.7827717662 * lms.y - 0.8086757660 * lms.z;\n"
+        "        return vec3(-a, b, l);\n"
+        "    }\n"
+        "    vec3 XYZ = vec3(0.4124564 * lin.r + 0.3575761 * lin.g + 0.1804375 * lin.b,\n" // LinearRGBtoXYZ
+        "                    0.2126729 * lin.r + 0.7151522 * lin.g + 0.0721750 * lin.b,\n"
+        "                    0.0193339 * lin.r + 0.1191920 * lin.g + 0.9503041 * lin.b);\n"
+        "    if (space == COLORSPACE_XYZ)\n"
+        "        return XYZ;\n"
+        "    if (space == COLORSPACE_XYY) {\n"
+        "        float sum = XYZ.x + XYZ.y + XYZ.z;\n"
+        "        vec2 xy = (sum > 0.0) ? XYZ.xy / sum : vec2(0.3127, 0.3290);\n" // D65 white point for black
+        "        return vec3(xy.y, xy.x, 1.0 - xy.x - xy.y);\n"
+        "    }\n"
+        "    vec3 r = XYZ / vec3(0.95047, 1.0, 1.08883);\n" // XYZtoCIELab
+        "    vec3 f = mix((24389.0 / 27.0 * r + 16.0) / 116.0, pow(r, vec3(1.0 / 3.0)), greaterThan(r, vec3(216.0 / 24389.0)));\n"
+        "    return vec3(-500.0 * (f.x - f.y) / 127.0, 200.0 * (f.y - f.z) / 127.0, (116.0 * f.y - 16.0) / 100.0);\n"
+        "}\n";
+}
+
+///////////////////////////////////////////////
+//// Palette positions
+////    one pass over the palette columns
+////    for all the colors
+///////////////////////////////////////////////
+
+void PositionsRGB(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // x = G, y = R, z = B
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = palettes.RGB[n].G * size3d;
+        p[1] = palettes.RGB[n].R * size3d;
+        p[2] = palettes.RGB[n].B * size3d;
+    }
+}
+
+void PositionsRGBTriangle(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // RGB values divided by their sum
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        const float sum = palettes.RGB[n].R + palettes.RGB[n].G + palettes.RGB[n].B;
+        p[0] = palettes.RGB[n].G / sum * size3d;
+        p[1] = palettes.RGB[n].R / sum * size3d;
+        p[2] = palettes.RGB[n].B / sum * size3d;
+    }
+}
+
+void PositionsHSV(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // S and H in polar coordinates, z = V
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = palettes.HSV[n].S * cos(-palettes.HSV[n].H * 2 * Pi) * size3d;
+        p[1] = palettes.HSV[n].S * sin(-palettes.HSV[n].H * 2 * Pi) * size3d;
+        p[2] = palettes.HSV[n].V * size3d;
+    }
+}
+
+void PositionsHSL(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // S and H in polar coordinates, z = L
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = palettes.HSL[n].S * cos(-palettes.HSL[n].H * 2 * Pi) * size3d;
+        p[1] = palettes.HSL[n].S * sin(-palettes.HSL[n].H * 2 * Pi) * size3d;
+        p[2] = palettes.HSL[n].L * size3d;
+    }
+}
+
+void PositionsHWB(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // 1 - W and H in polar coordinates, z = B
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = (1 - palettes.HWB[n].W) * cos(palettes.HWB[n].H * 2 * Pi) * size3d;
+        p[1] = (1 - palettes.HWB[n].W) * sin(palettes.HWB[n].H * 2 * Pi) * size3d;
+        p[2] = palettes.HWB[n].B * size3d;
+    }
+}
+
+void PositionsHCV(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // C and H in polar coordinates, z = V
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = palettes.HSV[n].C * cos(-palettes.HSV[n].H * 2 * Pi) * size3d;
+        p[1] = palettes.HSV[n].C * sin(-palettes.HSV[n].H * 2 * Pi) * size3d;
+        p[2] = palettes.HSV[n].V * size3d;
+    }
+}
+
+void PositionsHCL(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // C and H in polar coordinates, z = L
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = palettes.HSL[n].C * cos(-palettes.HSL[n].H * 2 * Pi) * size3d;
+        p[1] = palettes.HSL[n].C * sin(-palettes.HSL[n].H * 2 * Pi) * size3d;
+        p[2] = palettes.HSL[n].L * size3d;
+    }
+}
+
+void PositionsXYZ(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // x = X, y = Y, z = Z
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = palettes.XYZ[n].X * size3d;
+        p[1] = palettes.XYZ[n].Y * size3d;
+        p[2] = palettes.XYZ[n].Z * size3d;
+    }
+}
+
+void PositionsLMS(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // x = L, y = M, z = S
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = palettes.LMS[n].L * size3d;
+        p[1] = palettes.LMS[n].M * size3d;
+        p[2] = palettes.LMS[n].S * size3d;
+    }
+}
+
+void PositionsXYY(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // x = y, y = x, z = 1 - x - y
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = palettes.XYY[n].y * size3d;
+        p[1] = palettes.XYY[n].x * size3d;
+        p[2] = (1 - palettes.XYY[n].x - palettes.XYY[n].y) * size3d;
+    }
+}
+
+void PositionsLUV(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // x = v, y = u, z = L
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = palettes.LUV[n].v * size3d;
+        p[1] = palettes.LUV[n].u * size3d;
+        p[2] = palettes.LUV[n].L * size3d;
+    }
+}
+
+void PositionsCIELAB(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // x = -a, y = b, z = L
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = -palettes.CIELAB[n].A * size3d;
+        p[1] = palettes.CIELAB[n].B * size3d;
+        p[2] = palettes.CIELAB[n].L * size3d;
+    }
+}
+
+void PositionsOKLAB(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // x = -a, y = b, z = L
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = -palettes.OKLAB[n].A * size3d;
+        p[1] = palettes.OKLAB[n].B * size3d;
+        p[2] = palettes.OKLAB[n].L * size3d;
+    }
+}
+
+void PositionsHLAB(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // x = -a, y = b, z = L
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = -palettes.HLAB[n].A * size3d;
+        p[1] = palettes.HLAB[n].B * size3d;
+        p[2] = palettes.HLAB[n].L * size3d;
+    }
+}
+
+void PositionsLCHAB(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // C and H in polar coordinates, z = L
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = -palettes.LCHAB[n].C / 127.0 * 100.0 * cos(palettes.LCHAB[n].H * 2.0f * Pi) * size3d;
+        p[1] = palettes.LCHAB[n].C / 127.0 * 100.0 * sin(palettes.LCHAB[n].H * 2.0f * Pi) * size3d;
+        p[2] = palettes.LCHAB[n].L * size3d;
+    }
+}
+
+void PositionsLCHUV(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // C and H in polar coordinates, z = L
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = -palettes.LCHUV[n].C * cos(palettes.LCHUV[n].H * 2.0f * Pi + Pi / 2.0f) * size3d;
+        p[1] = palettes.LCHUV[n].C * sin(palettes.LCHUV[n].H * 2.0f * Pi + Pi / 2.0f) * size3d;
+        p[2] = palettes.LCHUV[n].L * size3d;
+    }
+}
+
+void PositionsWheel(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions) // L and H of HSL in polar coordinates, flat
+{
+    positions.resize(3 * std::max(nb, 0));
+    float *p = positions.data();
+    for (int n = 0; n < nb; n++, p += 3) {
+        p[0] = palettes.HSL[n].L * cos(palettes.HSL[n].H * 2 * Pi) * size3d;
+        p[1] = palettes.HSL[n].L * sin(palettes.HSL[n].H * 2 * Pi) * size3d;
+        p[2] = 0.0f;
+    }
+}
+
+///////////////////////////////////////////////
+//// Scaffolds
+////    compiled once in a display list
+///////////////////////////////////////////////
+
+static void ScaffoldLabAxes(const float &size3d) // L, a and b axes shared by the Lab-like color spaces
+{
+    // vertical L axis
+    glLineWidth(32);
+    glBegin(GL_LINES); // vertical axis
+        glColor3d(0,0,0); // axis origin : black
+        glVertex3f(0.0f, 0.0f, 0.0f);
+        glColor3d(1,1,1); // axis end : white
+        glVertex3f(0.0f, 0.0f, size3d);
+    glEnd();
+    DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("L", -150.0f, 150.0f, size3d + 300, 15, 1, 1, 1, 4);
+
+    // a axis (x) : green (-) to red (+)
+    glLineWidth(32);
+    glBegin(GL_LINES); // draw several lines
+        glColor3d(1,0,0); // red
+        glVertex3f(-size3d, 0.0f, 0.0f);
+        glColor3d(0,1,0); // green
+        glVertex3f(size3d, 0.0f, 0.0f);
+    glEnd();
+    DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 0, 1, 0); // green arrow
+    DrawText("-a", size3d + 250, -100.0f, 0.0f, 15, 0, 1, 0, 4);
+    DrawConeX(-size3d, 0.0f, 0.0f, -200.0f, 50.0f, 100, 1, 0, 0); // red arrow
+    DrawText("+a", -size3d - 400, -100.0f, 0.0f, 15, 1, 0, 0, 4);
+
+    // b axis (y) : blue (-) to yellow (+)
+    glLineWidth(32);
+    glBegin(GL_LINES);
+        glColor3d(0,0,1); // blue
+        glVertex3f( 0.0f, size3d, 0.0f );
+        glColor3d(1,1,0); // yellow
+        glVertex3f( 0.0f, -size3d, 0.0f );
+    glEnd();
+    DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 1, 0); // yellow arrow
+    DrawText("+b", -60.0f, -size3d - 450, 0.0f, 15, 1, 1, 0, 4);
+    DrawConeY(0.0f, size3d, 0.0f, 200.0f, 50.0f, 100, 0, 0, 1); // blue arrow
+    DrawText("-b", -60.0f, size3d + 250, 0.0f, 15, 0, 0, 1, 4);
+}
+
+static void WheelMarker(const float &radius, const float &degrees, const float &size, const float &r, const float &g, const float &b) // reference color on the wheel : a sphere with a white circle
+{
+    float angle = degrees / 360.0f * 2 * Pi;
+    DrawSphere(3, size, radius * cos(angle), -radius * sin(angle), 0, r, g, b);
+    DrawCircleXY(radius * cos(angle), radius * sin(angle), 0, size + 4.0f, 100, 1, 1, 1, 4);
+}
+
+void ScaffoldRGB(const float &size3d) // RGB : axes, circles, color boundaries and labels
+{
+    // green x axis
+    glLineWidth(32); // bigger width of the lines to really see them
+    glBegin(GL_LINES); // draw several lines
+        glColor3d(0,0,0); // axis origin : black
+        glVertex3f(0.0f, 0.0f, 0.0f);
+        glColor3d(0,1,0); // x/R axis color : red
+        glVertex3f(size3d, 0.0f, 0.0f);
+    glEnd();
+    DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 0, 1, 0);
+    DrawText("G", size3d + 300, -50.0f, 0.0f, 20, 0, 1, 0, 4);
+
+    // red y axis
+    glLineWidth(32); // bigger width of the lines to really see them
+    glBegin(GL_LINES);
+        glColor3d(0,0,0); // axis origin : black
+        glVertex3f( 0.0f,     0.0f, 0.0f );
+        glColor3d(1,0,0); // green
+        glVertex3f( 0.0f, -size3d, 0.0f );
+    glEnd();
+    DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 0, 0);
+    DrawText("R", -50.0f, -size3d - 400, 0.0f, 20, 1, 0, 0, 4);
+
+    // blue z axis
+    glLineWidth(32); // bigger width of the lines to really see them
+    glBegin(GL_LINES);
+        glColor3d(0,0,0); // axis origin : black
+        glVertex3f( 0.0f, 0.0f,    0.0f);
+        glColor3d(0,0,1); // z axis color : blue
+        glVertex3f( 0.0f, 0.0f, size3d);
+    glEnd();
+    DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 0, 0, 1);
+    DrawText("B", -150.0f, 150.0f, size3d + 300, 20, 0, 0, 1, 4);
+
+    // Triangle
+    glLineWidth(4);
+    glBegin(GL_LINE_LOOP); // draw closed lines
+        glColor3d(1, 0, 0); // red
+        glVertex3f(0, -size3d, 0); // vertex
+        glColor3d(0, 0, 1); // blue
+        glVertex3f(0, 0, size3d); // vertex
+        glColor3d(0, 1, 0); // green
+        glVertex3f(size3d, 0, 0); // vertex
+    glEnd();
+
+    /*// Rest of the cube
+    glLineWidth(4);
+    glBegin(GL_LINES);
+        glColor3d(1,1,1); // axis origin : white
+        glVertex3f(size3d, -size3d, size3d);
+        glColor3d(1,0,1); // violet
+        glVertex3f(size3d, 0.0f, size3d);
+    glEnd();
+
+    glBegin(GL_LINES);
+        glColor3d(1,1,1); // axis origin : white
+        glVertex3f(size3d, -size3d, size3d);
+        glColor3d(1,1,0); // yellow
+        glVertex3f(size3d, -size3d, 0.0f);
+    glEnd();
+
+    glBegin(GL_LINES);
+        glColor3d(1,1,1); // axis origin : white
+        glVertex3f(size3d, -size3d, size3d);
+        glColor3d(0,1,1); // cyan
+        glVertex3f(0.0f, -size3d, size3d);
+    glEnd();
+
+    glBegin(GL_LINES);
+        glColor3d(0,1,1); // axis origin : cyan
+        glVertex3f(0.0f, -size3d, size3d);
+        glColor3d(0,1,0); // green
+        glVertex3f(0.0f, -size3d, 0.0f);
+    glEnd();
+
+    glBegin(GL_LINES);
+        glColor3d(0,1,0); // axis origin : green
+        glVertex3f(0.0f, -size3d, 0.0f);
+        glColor3d(1,1,0); // yellow
+        glVertex3f(size3d, -size3d, 0.0f);
+    glEnd();
+
+    glBegin(GL_LINES);
+        glColor3d(1,1,0); // axis origin : yellow
+        glVertex3f(size3d, -size3d, 0.0f);
+        glColor3d(1,0,0); // red
+        glVertex3f(size3d, 0.0f, 0.0f);
+    glEnd();
+
+    glBegin(GL_LINES);
+        glColor3d(1,0,1); // axis origin : violet
+        glVertex3f(size3d, 0.0f, size3d);
+        glColor3d(1,0,0); // red
+        glVertex3f(size3d, 0.0f, 0.0f);
+    glEnd();
+
+    glBegin(GL_LINES);
+        glColor3d(1,0,1); // axis origin : violet
+        glVertex3f(size3d, 0.0f, size3d);
+        glColor3d(0,0,1); // blue
+        glVertex3f(0.0f, 0.0f, size3d);
+    glEnd();
+
+    glBegin(GL_LINES);
+        glColor3d(0,0,1); // axis origin : blue
+        glVertex3f(0.0f, 0.0f, size3d);
+        glColor3d(0,1,1); // cyan
+        glVertex3f(0.0f, -size3d, size3d);
+    glEnd();*/
+}
+
+void ScaffoldRGBTriangle(const float &size3d) // RGB Triangle : axes, circles, color boundaries and labels
+{
+    // green x axis
+    glLineWidth(32); // bigger width of the lines to really see them
+    glBegin(GL_LINES); // draw several lines
+        glColor3d(0,0,0); // axis origin : black
+        glVertex3f(0.0f, 0.0f, 0.0f);
+        glColor3d(0,1,0); // x/R axis color : red
+        glVertex3f(size3d, 0.0f, 0.0f);
+    glEnd();
+    DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 0, 1, 0);
+    DrawText("G", size3d + 300, -50.0f, 0.0f, 20, 0, 1, 0, 4);
+
+    // red y axis
+    glLineWidth(32); // bigger width of the lines to really see them
+    glBegin(GL_LINES);
+        glColor3d(0,0,0); // axis origin : black
+        glVertex3f( 0.0f,     0.0f, 0.0f );
+        glColor3d(1,0,0); // green
+        glVertex3f( 0.0f, -size3d, 0.0f );
+    glEnd();
+    DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 0, 0);
+    DrawText("R", -50.0f, -size3d - 400, 0.0f, 20, 1, 0, 0, 4);
+
+    // blue z axis
+    glLineWidth(32); // bigger width of the lines to really see them
+    glBegin(GL_LINES);
+        glColor3d(0,0,0); // axis origin : black
+        glVertex3f( 0.0f, 0.0f,    0.0f);
+        glColor3d(0,0,1); // z axis color : blue
+        glVertex3f( 0.0f, 0.0f, size3d);
+    glEnd();
+    DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 0, 0, 1);
+    DrawText("B", -150.0f, 150.0f, size3d + 300, 20, 0, 0, 1, 4);
+
+    // Triangle
+    glLineWidth(4);
+    glBegin(GL_LINE_LOOP); // draw closed lines
+        glColor3d(1, 0, 0); // red
+        glVertex3f(0, -size3d, 0); // vertex
+        glColor3d(0, 0, 1); // blue
+        glVertex3f(0, 0, size3d); // vertex
+        glColor3d(0, 1, 0); // green
+        glVertex3f(size3d, 0, 0); // vertex
+    glEnd();
+}
+
+void ScaffoldHSV(const float &size3d) // HSV : axes, circles, color boundaries and labels
+{
+    // colored circle
+    int num_segments = 360;
+    double R, G, B;
+    glLineWidth(32);
+    glBegin(GL_LINE_LOOP); // colored circle
+        for (int i = 0; i < num_segments; i++) {
+            double angle = double(i) / double(num_segments); //current angle
+            HSVtoRGB(angle, 1, 1, R, G, B);
+            glColor3d(R, G, B); // color of segment
+            glVertex3f(size3d * cosl(-angle * 2.0f * Pi), -size3d * sin(-angle * 2.0f * Pi), size3d); // vertex
+        }
+    glEnd();
+
+    // arc = H
+    DrawCircleArcXY(0, 0, size3d + 300, size3d + 400, 360, 315, 360,  1, 1, 1, 32);
+    DrawConeY(size3d + 400, -30, size3d + 300, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("H", size3d + 530, 0, size3d + 300, 20, 1, 1, 1, 4);
+
+    /*// black circle
+    DrawCircleXY(0, 0, 0, size3d, 360, 0, 0, 0, 32);*/
+
+    // vertical axis black to white
+    glLineWidth(32);
+    glBegin(GL_LINES);
+        glColor3d(0,0,0); // axis origin : black
+        glVertex3f(0.0f, 0.0f, 0.0f);
+        glColor3d(1,1,1); // axis end : white
+        glVertex3f(0.0f, 0.0f, size3d);
+    glEnd();
+    DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("V", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
+}
+
+void ScaffoldHSL(const float &size3d) // HSL : axes, circles, color boundaries and labels
+{
+    // colored circle
+    int num_segments = 360;
+    double R, G, B;
+    glLineWidth(32);
+    glBegin(GL_LINE_LOOP); // colored circle
+        for (int i = 0; i < num_segments; i++) {
+            double theta = 2.0f * Pi * double(i) / double(num_segments); //current angle
+            HSLtoRGB(-double(i) / double(num_segments), 1, 0.5, R, G, B);
+            glColor3d(R, G, B); // color of segment
+            glVertex3f(size3d * cosl(theta), -size3d * sin(theta), 500.0f); // vertex
+        }
+    glEnd();
+
+    // arc = H
+    DrawCircleArcXY(0, 0, size3d + 300, size3d + 400, 360, 315, 360,  1, 1, 1, 32);
+    DrawConeY(size3d + 400, -30, size3d + 300, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("H", size3d + 530, 0, size3d + 300, 20, 1, 1, 1, 4);
+
+    /*// black circle
+    DrawCircleXY(0, 0, 0, size3d, 360, 0, 0, 0, 32);
+
+    // white circle
+    DrawCircleXY(0, 0, size3d, size3d, 360, 1, 1, 1, 32);*/
+
+    // vertical axis black to white
+    glLineWidth(32);
+    glBegin(GL_LINES);
+        glColor3d(0,0,0); // axis origin : black
+        glVertex3f(0.0f, 0.0f, 0.0f);
+        glColor3d(1,1,1); // axis end : white
+        glVertex3f(0.0f, 0.0f, size3d);
+    glEnd();
+    DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("L", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
+}
+
+void ScaffoldHWB(const float &size3d) // HWB : axes, circles, color boundaries and labels
+{
+    // colored circle
+    int num_segments = 360;
+    double R, G, B;
+    glLineWidth(32); // bigger width of the lines to really see them
+    glBegin(GL_LINE_LOOP);       
+        for (int i = 0; i < num_segments; i++) {
+            double theta = 2.0f * Pi * double(i) / double(num_segments); //current angle
+            HWBtoRGB(double(i) / double(num_segments), 0, 0, R, G, B);
+            glColor3d(R, G, B); // color of segment
+            glVertex3f(size3d * cosl(theta), -size3d * sin(theta), 0.0f); // vertex
+        }
+    glEnd();
+
+    // arc = H
+    DrawCircleArcXY(0, 0, size3d + 300, size3d + 400, 360, 0, 45,  1, 1, 1, 32);
+    DrawConeY(size3d + 400, 0, size3d + 300, -200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("H", size3d + 530, 0, size3d + 300, 20, 1, 1, 1, 4);
+
+    /*// black circle
+    DrawCircleXY(0, 0, size3d, size3d, 360, 0, 0, 0, 32);*/
+
+    // vertical axis white to black
+    glLineWidth(32);
+    glBegin(GL_LINES); // vertical axis
+        glColor3d(0.75,0.75,0.75); // axis origin : white
+        glVertex3f(0.0f, 0.0f, 0.0f);
+        glColor3d(0,0,0); // axis end : black
+        glVertex3f(0.0f, 0.0f, size3d);
+    glEnd();
+    DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 0, 0, 0);
+    DrawText("B", -150.0f, 150.0f, size3d + 300, 20, 0.15, 0.15, 0.15, 4);
+}
+
+void ScaffoldHCV(const float &size3d) // HCV : axes, circles, color boundaries and labels
+{
+    // colored circle
+    int num_segments = 360;
+    double R, G, B;
+    glLineWidth(32); // bigger width of the lines to really see them
+    glBegin(GL_LINE_LOOP); // colored circle   
+        for (int i = 0; i < num_segments; i++) {
+            double angle = double(i) / double(num_segments); //current angle
+            HSVtoRGB(angle, 1, 1, R, G, B);
+            glColor3d(R, G, B); // color of segment
+            glVertex3f(size3d * cosl(-angle * 2.0f * Pi), -size3d * sin(-angle * 2.0f * Pi), size3d); // vertex
+        }
+    glEnd();
+
+    // arc = H
+    DrawCircleArcXY(0, 0, size3d + 300, size3d + 400, 360, 315, 360,  1, 1, 1, 32);
+    DrawConeY(size3d + 400, -30, size3d + 300, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("H", size3d + 530, 0, size3d + 300, 20, 1, 1, 1, 4);
+
+    // vertical axis black to white
+    glLineWidth(32);
+    glBegin(GL_LINES); // vertical axis
+        glColor3d(0,0,0); // axis origin : black
+        glVertex3f(0.0f, 0.0f, 0.0f);
+        glColor3d(1,1,1); // axis end : white
+        glVertex3f(0.0f, 0.0f, size3d);
+    glEnd();
+    DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("V", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
+}
+
+void ScaffoldHCL(const float &size3d) // HCL : axes, circles, color boundaries and labels
+{
+    // colored circle
+    int num_segments = 360;
+    double R, G, B;
+    glLineWidth(32);
+    glBegin(GL_LINE_LOOP); // colored circle
+        for (int i = 0; i < num_segments; i++) {
+            double theta = 2.0f * Pi * double(i) / double(num_segments); //current angle
+            HSLtoRGB(-double(i) / double(num_segments), 1, 0.5, R, G, B);
+            glColor3d(R, G, B); // color of segment
+            glVertex3f(size3d * cosl(theta), -size3d * sin(theta), 500.0f); // vertex
+        }
+    glEnd();
+
+    // arc = H
+    DrawCircleArcXY(0, 0, size3d + 300, size3d + 400, 360, 315, 360,  1, 1, 1, 32);
+    DrawConeY(size3d + 400, -30, size3d + 300, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("H", size3d + 530, 0, size3d + 300, 20, 1, 1, 1, 4);
+
+    // vertical axis black to white
+    glLineWidth(32);
+    glBegin(GL_LINES); // vertical axis
+        glColor3d(0,0,0); // axis origin : black
+        glVertex3f(0.0f, 0.0f, 0.0f);
+        glColor3d(1,1,1); // axis end : white
+        glVertex3f(0.0f, 0.0f, size3d);
+    glEnd();
+    DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("L", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
+    //DrawConeZ(0.0f, 0.0f, 0.0f, -200.0f, 50.0f, 100, 0, 0, 0);
+    //DrawText("-L", -150.0f, 150.0f, 0 - 300, 20, 0.15, 0.15, 0.15, 4);
+}
+
+void ScaffoldXYZ(const float &size3d) // CIE XYZ : axes, circles, color boundaries and labels
+{
+    // colored boundaries
+    DrawCMFinXYZ(size3d, false);
+
+    // x axis
+    glLineWidth(32);
+    glBegin(GL_LINES); // draw several lines
+        glColor3d(1,1,1);
+        glVertex3f(0.0f, 0.0f, 0.0f);
+        glVertex3f(size3d, 0.0f, 0.0f);
+    glEnd();
+    DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("X", size3d + 300, -50.0f, 0.0f, 20, 1, 1, 1, 4);
+
+    // y axis
+    glLineWidth(32);
+    glBegin(GL_LINES);
+        glVertex3f( 0.0f,     0.0f, 0.0f );
+        glVertex3f( 0.0f, -size3d, 0.0f );
+    glEnd();
+    DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("Y", -50.0f, -size3d - 400, 0.0f, 20, 1, 1, 1, 4);
+
+    // z axis
+    glLineWidth(32);
+    glBegin(GL_LINES);
+        glColor3d(0,0,0);
+        glVertex3f( 0.0f, 0.0f,    0.0f);
+        glColor3d(1,1,1);
+        glVertex3f( 0.0f, 0.0f, size3d);
+    glEnd();
+    DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("Z", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
+}
+
+void ScaffoldLMS(const float &size3d) // LMS : axes, circles, color boundaries and labels
+{
+    // x axis
+    glLineWidth(32);
+    glBegin(GL_LINES); // draw several lines
+        glColor3d(1,1,1);
+        glVertex3f(0.0f, 0.0f, 0.0f);
+        glVertex3f(size3d, 0.0f, 0.0f);
+    glEnd();
+    DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("L", size3d + 300, -50.0f, 0.0f, 20, 1, 1, 1, 4);
+
+    // y axis
+    glLineWidth(32);
+    glBegin(GL_LINES);
+        glVertex3f( 0.0f,     0.0f, 0.0f );
+        glVertex3f( 0.0f, -size3d, 0.0f );
+    glEnd();
+    DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("M", -50.0f, -size3d - 400, 0.0f, 20, 1, 1, 1, 4);
+
+    // z axis
+    glLineWidth(32);
+    glBegin(GL_LINES);
+        glVertex3f( 0.0f, 0.0f,    0.0f);
+        glVertex3f( 0.0f, 0.0f, size3d);
+    glEnd();
+    DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("S", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
+
+    // colored boundaries
+    DrawCMFinLMS(size3d);
+}
+
+void ScaffoldXYY(const float &size3d) // CIE xyY : axes, circles, color boundaries and labels
+{
+    // colored boundaries
+    DrawCMFinXYZ(size3d, true);
+
+    // White point
+    glLineWidth(4);
+    glBegin(GL_LINES); // draw several lines
+        glColor3d(1,1,1);
+        glVertex3f(0,0,0);
+        float sum = 0.9505f + 1.0f + 1.089f;
+        glVertex3f(1.0f / sum * size3d, -0.9505f / sum * size3d, 1.089f / sum * size3d);
+    glEnd();
+
+    // y axis
+    glLineWidth(32);
+    glBegin(GL_LINES); // draw several lines
+        glColor3d(1,1,1);
+        glVertex3f(0.0f, 0.0f, 0.0f);
+        glVertex3f(size3d, 0.0f, 0.0f);
+    glEnd();
+    DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("y", size3d + 300, -50.0f, 0.0f, 20, 1, 1, 1, 4);
+
+    // x axis
+    glLineWidth(32);
+    glBegin(GL_LINES);
+        glVertex3f( 0.0f,     0.0f, 0.0f );
+        glVertex3f( 0.0f, -size3d, 0.0f );
+    glEnd();
+    DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("x", -50.0f, -size3d - 400, 0.0f, 20, 1, 1, 1, 4);
+
+    // z axis
+    glLineWidth(32);
+    glBegin(GL_LINES);
+        glVertex3f( 0.0f, 0.0f,    0.0f);
+        glVertex3f( 0.0f, 0.0f, size3d);
+    glEnd();
+    DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("Y", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
+}
+
+void ScaffoldLUV(const float &size3d) // CIE L*u*v* : axes, circles, color boundaries and labels
+{
+    // x axis
+    glLineWidth(32);
+    glBegin(GL_LINES); // draw several lines
+        glColor3d(1,1,1);
+        glVertex3f(0.0f, 0.0f, 0.0f);
+        glVertex3f(size3d, 0.0f, 0.0f);
+    glEnd();
+    DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("v", size3d + 300, -50.0f, 0.0f, 20, 1, 1, 1, 4);
+
+    // y axis
+    glLineWidth(32);
+    glBegin(GL_LINES);
+        glVertex3f( 0.0f,     0.0f, 0.0f );
+        glVertex3f( 0.0f, -size3d, 0.0f );
+    glEnd();
+    DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("u", -50.0f, -size3d - 400, 0.0f, 20, 1, 1, 1, 4);
+
+    // z axis
+    glLineWidth(32);
+    glBegin(GL_LINES);
+        glColor3d(0,0,0);
+        glVertex3f( 0.0f, 0.0f,    0.0f);
+        glColor3d(1,1,1);
+        glVertex3f( 0.0f, 0.0f, size3d);
+    glEnd();
+    DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
+    DrawText("L", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
+
+    // color boundaries
+    DrawCMFinLuv(size3d);
+}
+
+void ScaffoldCIELAB(const float &size3d) // CIE L*a*b* : axes, circles, color boundaries and labels
+{
+    ScaffoldLabAxes(size3d);
+
+    // color boundaries
+    DrawCMFinLab(size3d);
+}
+
+void ScaffoldOKLAB(const float &size3d) // OKLAB : axes, circles, color boundaries and labels
+{
+    ScaffoldLabAxes(size3d);
+
+    // color boundaries
+    DrawCMFinOKLAB(size3d);
+}
+
+void ScaffoldHLAB(const float &size3d) // Hunter Lab : axes, circles, color boundaries and labels
+{
+    ScaffoldLabAxes(size3d);
+
+    // color boundaries
+    DrawCMFinHLAB(size3d);
+}
+
+void ScaffoldLCHAB(const float &size3d) // CIE LCHab : axes, circles, color boundaries and labels
+{
+    // vertical L axis
+    glLineWidth(32);
+    glBegin(GL_LINES); // vertical axis
+        glColor3d(0,0,0); // axis origin : black
+        glVertex3f(0.0f, 0.0f, 0.0f);
+        glColor3d(1,1,1); // axis end : white
+        glVertex3f(0.0f, 0.0f, size3d);
+    glEnd();
+    DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
+
+    // a axis (x) : green (-) to red (+)
+    glLineWidth(32);
+    glBegin(GL_LINES); // draw several lines
+        glColor3d(1,0,0); // red
+        glVertex3f(-size3d, 0.0f, 0.0f);
+        glColor3d(0,1,0); // green
+        glVertex3f(size3d, 0.0f, 0.0f);
+    glEnd();
+    DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 0, 1, 0); // green arrow
+    DrawConeX(-size3d, 0.0f, 0.0f, -200.0f, 50.0f, 100, 1, 0, 0); // red arrow
+
+    // b axis (y) : blue (-) to yellow (+)
+    glLineWidth(32);
+    glBegin(GL_LINES);
+        glColor3d(0,0,1); // blue
+        glVertex3f( 0.0f, size3d, 0.0f );
+        glColor3d(1,1,0); // yellow
+        glVertex3f( 0.0f, -size3d, 0.0f );
+    glEnd();
+    DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 1, 0); // yellow arrow
+    DrawConeY(0.0f, size3d, 0.0f, 200.0f, 50.0f, 100, 0, 0, 1); // blue arrow
+
+    // color boundaries
+    DrawCMFinLab(size3d);
+}
+
+void ScaffoldLCHUV(const float &size3d) // CIE LCHuv : axes, circles, color boundaries and labels
+{
+    // x axis
+    glLineWidth(32);
+    glBegin(GL_LINES); // draw several lines
+        glColor3d(1,1,1);
+        glVertex3f(0.0f, 0.0f, 0.0f);
+        glVertex3f(size3d, 0.0f, 0.0f);
+    glEnd();
+    DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 1, 1, 1);
+
+    // y axis
+    glLineWidth(32);
+    glBegin(GL_LINES);
+        glVertex3f( 0.0f,     0.0f, 0.0f );
+        glVertex3f( 0.0f, -size3d, 0.0f );
+    glEnd();
+    DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 1, 1);
+
+    // z axis
+    glLineWidth(32);
+    glBegin(GL_LINES);
+        glColor3d(0,0,0);
+        glVertex3f( 0.0f, 0.0f,    0.0f);
+        glColor3d(1,1,1);
+        glVertex3f( 0.0f, 0.0f, size3d);
+    glEnd();
+    DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
+
+    // color boundaries
+    DrawCMFinLuv(size3d);
+}
+
+void ScaffoldWheel(const float &size3d) // Wheel : axes, circles, color boundaries and labels
+{
+    // external circle
+    float radius = size3d + 150.0f;
+    DrawCircleXY(0, 0, 0, radius, 100, 1, 1, 1, 32);
+
+    // internal circle
+    DrawCircleXY(0, 0, 0, size3d, 100, 0.5, 0.5, 0.5, 4);
+
+    // cross = middle
+    glLineWidth(4);
+    glColor3d(0.5,0.5,0.5); // gray
+    glBegin(GL_LINES); // a white line on each axis
+        glVertex3f( 50.0f, 0.0f, 0.0f);
+        glVertex3f(-50.0f, 0.0f, 0.0f);
+        glVertex3f(0.0f, -50.0f, 0.0f );
+        glVertex3f(0.0f,  50.0f, 0.0f );
+        glVertex3f(0.0f, 0.0f,  50.0f );
+        glVertex3f(0.0f, 0.0f, -50.0f );
+    glEnd();
+
+    // primary, secondary and tertiary colors : a sphere with a white circle
+    WheelMarker(radius,   0.0f, 100, 1, 0, 0); // red
+    WheelMarker(radius, 120.0f, 100, 0, 0, 1); // blue
+    WheelMarker(radius, 240.0f, 100, 0, 1, 0); // green
+    WheelMarker(radius,  60.0f,  75, 1, 0, 1); // magenta
+    WheelMarker(radius, 180.0f,  75, 0, 1, 1); // cyan
+    WheelMarker(radius, 300.0f,  75, 1, 1, 0); // yellow
+    WheelMarker(radius,  30.0f,  50, 1, 0, 0.5); // pink
+    WheelMarker(radius,  90.0f,  50, 0.5, 0, 1); // purple
+    WheelMarker(radius, 150.0f,  50, 0, 0.5, 1); // azure
+    WheelMarker(radius, 210.0f,  50, 0, 1, 0.5); // blue-green
+    WheelMarker(radius, 270.0f,  50, 0.5, 1, 0); // chartreuse
+    WheelMarker(radius, 330.0f,  50, 1, 0.5, 0); // orange
+}
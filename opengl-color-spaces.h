@@ -0,0 +1,86 @@
+/*#-------------------------------------------------
+#
+#      Color spaces render modules for OpenGL
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   - one module per color space, indexed by enum :
+#       . palette to 3D positions (batch)
+#       . same positions in GLSL for the common
+#         color spaces
+#       . scaffold : axes, circles, curves, labels
+#       . default camera
+#
+#-------------------------------------------------*/
+
+#ifndef OPENGLCOLORSPACES_H
+#define OPENGLCOLORSPACES_H
+
+#include <string>
+#include <vector>
+
+#include "palette.h"
+
+enum ColorSpace3D {ColorSpaceRGB, ColorSpaceRGBTriangle, ColorSpaceHSV, ColorSpaceHSL, ColorSpaceHWB, ColorSpaceHCV, ColorSpaceHCL,
+                   ColorSpaceXYZ, ColorSpaceLMS, ColorSpaceXYY, ColorSpaceLUV, ColorSpaceCIELAB, ColorSpaceOKLAB, ColorSpaceHLAB,
+                   ColorSpaceLCHAB, ColorSpaceLCHUV, ColorSpaceWheel,
+                   ColorSpace3DCount}; // color spaces that can be plotted in the 3D view
+
+typedef void (*PositionsFunction)(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions); // (x,y,z) of each palette color, in DrawSpherePlus coordinates
+typedef void (*ScaffoldFunction)(const float &size3d); // immediate mode drawing of the color space scaffold
+
+struct struct_color_space_3d { // render module of one color space
+    std::string name; // name shown in the GUI and used in file names
+    PositionsFunction Positions; // palette values to 3D positions, one pass for all colors
+    ScaffoldFunction Scaffold; // axes, circles, color matching functions and labels
+    bool extended; // needs Hunter Lab, LMS or LCHuv values computed by ConvertPaletteExtended
+    bool shader; // positions can also be computed from RGB in a vertex shader, by ColorSpacePositionsGLSL
+    int rotation_x, rotation_y, rotation_z; // default camera rotation in degrees
+    double zoom; // default camera zoom
+};
+
+extern const struct_color_space_3d ColorSpaces3D[ColorSpace3DCount]; // all render modules, indexed by ColorSpace3D
+
+std::string ColorSpacePositionsGLSL(); // GLSL source of "vec3 ColorSpacePosition(int space, vec3 rgb)" for color spaces with shader = true - DrawSpherePlus coordinates before size3d
+
+/// Positions of palette colors
+void PositionsRGB(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsRGBTriangle(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsHSV(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsHSL(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsHWB(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsHCV(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsHCL(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsXYZ(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsLMS(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsXYY(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsLUV(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsCIELAB(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsOKLAB(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsHLAB(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsLCHAB(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsLCHUV(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+void PositionsWheel(const PaletteStore &palettes, const int &nb, const float &size3d, std::vector<float> &positions);
+
+/// Scaffolds
+void ScaffoldRGB(const float &size3d);
+void ScaffoldRGBTriangle(const float &size3d);
+void ScaffoldHSV(const float &size3d);
+void ScaffoldHSL(const float &size3d);
+void ScaffoldHWB(const float &size3d);
+void ScaffoldHCV(const float &size3d);
+void ScaffoldHCL(const float &size3d);
+void ScaffoldXYZ(const float &size3d);
+void ScaffoldLMS(const float &size3d);
+void ScaffoldXYY(const float &size3d);
+void ScaffoldLUV(const float &size3d);
+void ScaffoldCIELAB(const float &size3d);
+void ScaffoldOKLAB(const float &size3d);
+void ScaffoldHLAB(const float &size3d);
+void ScaffoldLCHAB(const float &size3d);
+void ScaffoldLCHUV(const float &size3d);
+void ScaffoldWheel(const float &size3d);
+
+#endif // OPENGLCOLORSPACES_H
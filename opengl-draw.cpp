@@ -98,6 +98,27 @@ void DrawCMFinLab(const float &size3d) // draw Color Matching Functions in L*a*b
     glEnd();
 }
 
+void DrawCMFinOKLAB(const float &size3d) // draw Color Matching Functions in OKLAB color space
+{
+    double W, X, Y, Z, R, G, B, L, a, b;
+
+    glLineWidth(4);
+    glBegin(GL_LINE_STRIP);
+        for (int w = 0; w < wavelength_XYZ_nb; w++) {
+            W = wavelength_XYZ[w][0];
+
+            if ((W >= 390) and (W <= 700)) {
+                WavelengthToXYZ(W, X, Y, Z);
+                XYZtoRGB(X, Y, Z, R, G, B); // convert XYZ to RGB
+                XYZtoOKLAB(X, Y, Z, L, a, b); // convert XYZ to OKLAB
+
+                glColor3d(R, G, B); // change color to computed RGB
+                glVertex3f(-a * size3d, -b * size3d, L * size3d); // add vertex
+            }
+        }
+    glEnd();
+}
+
 void DrawCMFinLMS(const float &size3d) // draw Color Matching Functions in LMS color space
 {
     double W, X, Y, Z, R, G, B, L, M, S;
@@ -309,6 +330,37 @@ void DrawSphere(const int &ndiv, const float &radius, const float &x, const floa
     glEnd();
 }
 
+void MeshTri(float *a, float *b, float *c, int div, std::vector<float> &vertices) // same subdivision as DrawTri, but vertices of the unit sphere are stored instead of drawn
+{
+    if (div <= 0) {
+        vertices.insert(vertices.end(), a, a + 3);
+        vertices.insert(vertices.end(), b, b + 3);
+        vertices.insert(vertices.end(), c, c + 3);
+    } else {
+        float ab[3], ac[3], bc[3];
+        for (int i = 0; i < 3; i++) { // half
+            ab[i] = (a[i]+b[i]) / 2.0;
+            ac[i] = (a[i]+c[i]) / 2.0;
+            bc[i] = (b[i]+c[i]) / 2.0;
+        }
+        normalize(ab);
+        normalize(ac);
+        normalize(bc);
+        MeshTri(a, ab, ac, div-1, vertices); // new divided triangles
+        MeshTri(b, bc, ab, div-1, vertices);
+        MeshTri(c, ac, bc, div-1, vertices);
+        MeshTri(ab, bc, ac, div-1, vertices);
+    }
+}
+
+void SphereMesh(const int &ndiv, std::vector<float> &vertices) // unit sphere as a list of triangles (x,y,z for each vertex) - on a unit sphere each vertex is also its normal
+{
+    vertices.clear();
+    vertices.reserve(20 * size_t(pow(4, ndiv)) * 9); // each subdivision level multiplies the number of triangles by 4
+    for (int i = 0; i < 20; i++) // 20 times
+        MeshTri(vdata[tindices[i][0]], vdata[tindices[i][1]], vdata[tindices[i][2]], ndiv, vertices); // recursive subdivision with sphere data
+}
+
 ///////////////////////////////////////////////
 //// Matrix to lines
 ///////////////////////////////////////////////
@@ -368,60 +420,88 @@ int checkCharacter(const int &c, const int &x, const int &y)
         return characters[c].data[x][y];
 }
 
-void DrawChar(const uchar ch, const float &x0, const float &y0, const float &z0, const float &scale, const float &R, const float &G, const float &B, const float &width)
-{
-    if ((ch < characters_begin) or (ch > characters_end))
-            return;
-    int c = ch - characters_begin;
-
-    glColor3f(R,G,B);
-    glLineWidth(width);
-    glBegin(GL_LINES);
-        for (int x = 0; x < characters_matrix_cols; x++) // down
-            for (int y = 0; y < characters_matrix_rows - 1; y++)
-                if ((characters[c].data[x][y] != 0) & (checkCharacter(c, x, y + 1) != 0)) {
-                    glVertex3f(scale * x + x0, scale * y + y0, z0);
-                    glVertex3f(scale * x + x0, scale * (y + 1) + y0, z0);
-                }
-        for (int x = 0; x < characters_matrix_cols - 1; x++) // right
-            for (int y = 0; y < characters_matrix_rows; y++)
-                if ((characters[c].data[x][y] != 0) & (checkCharacter(c, x + 1, y) != 0)) {
-                    glVertex3f(scale * x + x0, scale * y + y0, z0);
-                    glVertex3f(scale * (x + 1) + x0, scale * y + y0, z0);
-                }
-        for (int x = 0; x < characters_matrix_cols - 1; x++) // down-right
-            for (int y = 0; y < characters_matrix_rows - 1; y++)
-                if ((characters[c].data[x][y] != 0) & (checkCharacter(c, x + 1, y + 1) != 0) & (checkCharacter(c, x + 1, y) == 0) & (checkCharacter(c, x, y + 1) == 0)) {
-                    glVertex3f(scale * x + x0, scale * y + y0, z0);
-                    glVertex3f(scale * (x + 1) + x0, scale * (y + 1) + y0, z0);
-                }
-        for (int x = 1; x < characters_matrix_cols; x++) // down-left
-            for (int y = 0; y < characters_matrix_rows - 1; y++)
-                if ((characters[c].data[x][y] != 0) & (checkCharacter(c, x - 1, y + 1) != 0) & (checkCharacter(c, x - 1, y) == 0) & (checkCharacter(c, x, y + 1) == 0)) {
-                    glVertex3f(scale * x + x0, scale * y + y0, z0);
-                    glVertex3f(scale * (x - 1) + x0, scale * (y + 1) + y0, z0);
-                }
-    glEnd();
+struct struct_glyph { // stroke font character, tessellated once
+    std::vector<float> lines; // (x,y) cell coordinates of both ends of each stroke
+    std::vector<float> dots; // (x,y) cell coordinates of isolated dots
+};
 
-        // isolated dots
-        for (int x = 0; x < characters_matrix_cols; x++) // down-left
-            for (int y = 0; y < characters_matrix_rows; y++)
-                if ((characters[c].data[x][y] != 0)
-                        & (checkCharacter(c, x - 1, y - 1) == 0) & (checkCharacter(c, x, y - 1) == 0) & (checkCharacter(c, x + 1, y - 1) == 0)
-                        & (checkCharacter(c, x - 1, y) == 0) & (checkCharacter(c, x + 1, y) == 0)
-                        & (checkCharacter(c, x - 1, y + 1) == 0) & (checkCharacter(c, x, y + 1) == 0) & (checkCharacter(c, x + 1, y + 1) == 0)) {
-                    //DrawCircleXY(scale * x + x0, scale * y + y0, z0 , 4, 10, 1, 1, 1, 4);
-                    DrawSphere(3, width, scale * x + x0, -scale * y - y0, z0, R, G, B);
-                }
+static struct_glyph TessellateCharacter(const int &c) // strokes and dots of one character
+{
+    struct_glyph glyph;
+
+    for (int x = 0; x < characters_matrix_cols; x++) // down
+        for (int y = 0; y < characters_matrix_rows - 1; y++)
+            if ((characters[c].data[x][y] != 0) & (checkCharacter(c, x, y + 1) != 0))
+                glyph.lines.insert(glyph.lines.end(), {float(x), float(y), float(x), float(y + 1)});
+    for (int x = 0; x < characters_matrix_cols - 1; x++) // right
+        for (int y = 0; y < characters_matrix_rows; y++)
+            if ((characters[c].data[x][y] != 0) & (checkCharacter(c, x + 1, y) != 0))
+                glyph.lines.insert(glyph.lines.end(), {float(x), float(y), float(x + 1), float(y)});
+    for (int x = 0; x < characters_matrix_cols - 1; x++) // down-right
+        for (int y = 0; y < characters_matrix_rows - 1; y++)
+            if ((characters[c].data[x][y] != 0) & (checkCharacter(c, x + 1, y + 1) != 0) & (checkCharacter(c, x + 1, y) == 0) & (checkCharacter(c, x, y + 1) == 0))
+                glyph.lines.insert(glyph.lines.end(), {float(x), float(y), float(x + 1), float(y + 1)});
+    for (int x = 1; x < characters_matrix_cols; x++) // down-left
+        for (int y = 0; y < characters_matrix_rows - 1; y++)
+            if ((characters[c].data[x][y] != 0) & (checkCharacter(c, x - 1, y + 1) != 0) & (checkCharacter(c, x - 1, y) == 0) & (checkCharacter(c, x, y + 1) == 0))
+                glyph.lines.insert(glyph.lines.end(), {float(x), float(y), float(x - 1), float(y + 1)});
+
+    // isolated dots
+    for (int x = 0; x < characters_matrix_cols; x++)
+        for (int y = 0; y < characters_matrix_rows; y++)
+            if ((characters[c].data[x][y] != 0)
+                    & (checkCharacter(c, x - 1, y - 1) == 0) & (checkCharacter(c, x, y - 1) == 0) & (checkCharacter(c, x + 1, y - 1) == 0)
+                    & (checkCharacter(c, x - 1, y) == 0) & (checkCharacter(c, x + 1, y) == 0)
+                    & (checkCharacter(c, x - 1, y + 1) == 0) & (checkCharacter(c, x, y + 1) == 0) & (checkCharacter(c, x + 1, y + 1) == 0))
+                glyph.dots.insert(glyph.dots.end(), {float(x), float(y)});
+
+    return glyph;
+}
 
+static const std::vector<struct_glyph>& Glyphs() // all characters, tessellated the first time text is drawn
+{
+    static const std::vector<struct_glyph> glyphs = [] {
+        std::vector<struct_glyph> all;
+        for (int c = 0; c < characters_nb; c++)
+            all.push_back(TessellateCharacter(c));
+        return all;
+    }();
+
+    return glyphs;
 }
 
 void DrawText(const std::string &text, const float &x0, const float &y0, const float &z0, const float &scale, const float &R, const float &G, const float &B, const float &width)
 {
-    float xCurrent = 0;
+    const std::vector<struct_glyph> &glyphs = Glyphs();
 
-    for (uint n = 0; n < text.length(); n++) {
-        DrawChar(text[n], x0, y0 + xCurrent, z0, scale, R, G, B, width);
-        xCurrent += scale * characters_matrix_cols;
-    }
+    glColor3f(R,G,B);
+
+    glLineWidth(width);
+    glBegin(GL_LINES); // strokes of all characters in one batch
+        float xCurrent = 0;
+        for (uint n = 0; n < text.length(); n++) {
+            const uchar ch = text[n];
+            if ((ch >= characters_begin) and (ch <= characters_end)) {
+                const std::vector<float> &lines = glyphs[ch - characters_begin].lines;
+                for (size_t v = 0; v < lines.size(); v += 2)
+                    glVertex3f(scale * lines[v] + x0, scale * lines[v + 1] + y0 + xCurrent, z0);
+            }
+            xCurrent += scale * characters_matrix_cols;
+        }
+    glEnd();
+
+    glPointSize(width); // isolated dots as thick as the strokes
+    glBegin(GL_POINTS);
+        xCurrent = 0;
+        for (uint n = 0; n < text.length(); n++) {
+            const uchar ch = text[n];
+            if ((ch >= characters_begin) and (ch <= characters_end)) {
+                const std::vector<float> &dots = glyphs[ch - characters_begin].dots;
+                for (size_t v = 0; v < dots.size(); v += 2)
+                    glVertex3f(scale * dots[v] + x0, scale * dots[v + 1] + y0 + xCurrent, z0);
+            }
+            xCurrent += scale * characters_matrix_cols;
+        }
+    glEnd();
+    glPointSize(1);
 }
@@ -21,6 +21,7 @@
 void DrawCMFinXYZ(const float &size3d, const bool spectrum_locus); // draw Color Matching Functions in XYZ color space
 void DrawCMFinLuv(const float &size3d); // draw Color Matching Functions in L*u*v* color space
 void DrawCMFinLab(const float &size3d); // draw Color Matching Functions in L*a*b* color space
+void DrawCMFinOKLAB(const float &size3d); // draw Color Matching Functions in OKLAB color space
 void DrawCMFinLMS(const float &size3d); // draw Color Matching Functions in LMS color space
 void DrawCMFinHLAB(const float &size3d); // draw Color Matching Functions in Hunter LAB color space
 
@@ -33,6 +34,7 @@ void DrawConeY(const float &center_x, const float &center_y, const float &center
 void DrawConeZ(const float &center_x, const float &center_y, const float &center_z, const float &length, const float &radius, const int &segments, const float &R, const float &G, const float &B); // cone along Z axis
 
 void DrawSphere(const int &ndiv, const float &radius, const float &x, const float &y, const float &z, const float &r, const float &g, const float &b); // sphere
+void SphereMesh(const int &ndiv, std::vector<float> &vertices); // unit sphere triangles, same geometry as DrawSphere - used by instanced rendering
 
 void DrawLinesFromMatrix(const cv::Mat &matrix, const float &x0, const float &y0, const float &z0, const float &scale, const float &R, const float &G, const float &B, const float &width);
 
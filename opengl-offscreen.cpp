@@ -0,0 +1,144 @@
+/*#-------------------------------------------------
+#
+#        Offscreen 3D color space rendering
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   - own OpenGL context on an offscreen surface :
+#     no window needed
+#   - any resolution, multisampled framebuffer
+#   - batch capture : all views are rendered, pixels
+#     are read back asynchronously in pixel buffers
+#     and only mapped at the end
+#
+#-------------------------------------------------*/
+
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLBuffer>
+
+#include "opengl-offscreen.h"
+
+///////////////////////////////////////////////
+//// Offscreen renderer
+///////////////////////////////////////////////
+
+OffscreenRenderer3D::OffscreenRenderer3D()
+{
+    available = false; // nothing created yet
+}
+
+OffscreenRenderer3D::~OffscreenRenderer3D()
+{
+    if (available and context.makeCurrent(&surface)) { // OpenGL objects must be released with their context
+        renderer.Destroy();
+        context.doneCurrent();
+    }
+}
+
+bool OffscreenRenderer3D::Initialize() // create the OpenGL context and the offscreen surface
+{
+    if (available) // already done
+        return true;
+
+    QSurfaceFormat format = QSurfaceFormat::defaultFormat(); // same OpenGL version and profile as the widget, so the same drawing paths are used
+    surface.setFormat(format);
+    surface.create();
+    if (!surface.isValid())
+        return false;
+
+    context.setFormat(format);
+    if (!context.create())
+        return false;
+    if (!context.makeCurrent(&surface))
+        return false;
+
+    initializeOpenGLFunctions();
+    renderer.Initialize(); // states, lights, spheres and point cloud of this context
+
+    context.doneCurrent();
+
+    available = true;
+    return true;
+}
+
+void OffscreenRenderer3D::SetPointCloudImage(const cv::Mat &image) // all distinct colors of this BGR image are shown as points
+{
+    renderer.SetPointCloudImage(image); // only the histogram is computed here, positions are uploaded at next capture
+}
+
+bool OffscreenRenderer3D::Capture(const struct_view_3d &view, const PaletteStore &palettes, const int &nb_palettes,
+                                  const int &width, const int &height, const int &samples, QImage &image) // render one view
+{
+    std::vector<QImage> images;
+    if (!CaptureBatch(std::vector<struct_view_3d>(1, view), palettes, nb_palettes, width, height, samples, images))
+        return false;
+
+    image = images[0];
+    return true;
+}
+
+bool OffscreenRenderer3D::CaptureBatch(const std::vector<struct_view_3d> &views, const PaletteStore &palettes, const int &nb_palettes,
+                                       const int &width, const int &height, const int &samples, std::vector<QImage> &images) // render several views of the same palette
+{
+    images.clear();
+    if ((width < 1) or (height < 1) or (views.empty()))
+        return false;
+    if (!Initialize())
+        return false;
+    if (!context.makeCurrent(&surface))
+        return false;
+
+    QOpenGLFramebufferObjectFormat format; // multisampled render target
+    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    format.setSamples(samples);
+    QOpenGLFramebufferObject multisampled(width, height, format);
+    QOpenGLFramebufferObject resolved(width, height); // one sample per pixel : the one that is read back
+    if ((!multisampled.isValid()) or (!resolved.isValid())) {
+        context.doneCurrent();
+        return false;
+    }
+
+    multisampled.bind();
+    renderer.Resize(width, height, 1.0f); // viewport = framebuffer
+    renderer.PaletteChanged(); // palette may have changed since last capture
+
+    const int size = 4 * width * height; // RGBA bytes of one image
+    std::vector<QOpenGLBuffer> pixels(views.size(), QOpenGLBuffer(QOpenGLBuffer::PixelPackBuffer)); // one pixel buffer per view
+
+    for (size_t v = 0; v < views.size(); v++) {
+        multisampled.bind();
+        renderer.Render(views[v], palettes, nb_palettes);
+
+        QOpenGLFramebufferObject::blitFramebuffer(&resolved, &multisampled); // resolve samples
+
+        resolved.bind();
+        pixels[v].create();
+        pixels[v].setUsagePattern(QOpenGLBuffer::StreamRead);
+        pixels[v].bind();
+        pixels[v].allocate(size);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr); // copy to the pixel buffer : returns without waiting, the next view is rendered meanwhile
+        pixels[v].release();
+    }
+
+    QOpenGLFramebufferObject::bindDefault();
+
+    images.resize(views.size());
+    bool ok = true;
+    for (size_t v = 0; v < views.size(); v++) { // now wait for each copy
+        pixels[v].bind();
+        const uchar *data = static_cast<const uchar*>(pixels[v].map(QOpenGLBuffer::ReadOnly));
+        if (data) // OpenGL rows are bottom to top, alpha is not meaningful after blending
+            images[v] = QImage(data, width, height, 4 * width, QImage::Format_RGBX8888).mirrored().convertToFormat(QImage::Format_RGB32); // deep copy
+        else
+            ok = false;
+        pixels[v].unmap();
+        pixels[v].release();
+        pixels[v].destroy();
+    }
+
+    context.doneCurrent();
+
+    return ok;
+}
@@ -0,0 +1,57 @@
+/*#-------------------------------------------------
+#
+#        Offscreen 3D color space rendering
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   - own OpenGL context on an offscreen surface :
+#     no window needed
+#   - any resolution, multisampled framebuffer
+#   - batch capture : all views are rendered, pixels
+#     are read back asynchronously in pixel buffers
+#     and only mapped at the end
+#
+#-------------------------------------------------*/
+
+#ifndef OPENGLOFFSCREEN_H
+#define OPENGLOFFSCREEN_H
+
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLContext>
+#include <QOffscreenSurface>
+#include <QImage>
+
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+#include "palette.h"
+#include "opengl-renderer.h"
+
+class OffscreenRenderer3D : protected QOpenGLExtraFunctions
+{
+public:
+    OffscreenRenderer3D();
+    ~OffscreenRenderer3D();
+
+    bool Initialize(); // create the OpenGL context and the offscreen surface - must be called from the GUI thread - false if OpenGL is not available
+    bool IsAvailable() const { return available; } // offscreen rendering can be used
+
+    void SetPointCloudImage(const cv::Mat &image); // all distinct colors of this BGR image are shown as points
+
+    bool Capture(const struct_view_3d &view, const PaletteStore &palettes, const int &nb_palettes,
+                 const int &width, const int &height, const int &samples, QImage &image); // render one view at width x height with samples per pixel - false if it failed
+    bool CaptureBatch(const std::vector<struct_view_3d> &views, const PaletteStore &palettes, const int &nb_palettes,
+                      const int &width, const int &height, const int &samples, std::vector<QImage> &images); // render several views of the same palette - false if it failed
+
+private:
+    bool available; // context and surface are ready
+
+    QOpenGLContext context; // not shared with the widget
+    QOffscreenSurface surface; // no window
+    Renderer3D renderer; // same scene as the widget
+};
+
+#endif // OPENGLOFFSCREEN_H
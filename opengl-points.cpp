@@ -0,0 +1,287 @@
+/*#-------------------------------------------------
+#
+#       Image colors point cloud for OpenGL
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   - every distinct color of an image is a point
+#   - counts from a 24-bit RGB histogram
+#   - point size and opacity weighted by frequency
+#   - positions in any 3D color space, uploaded once
+#   - common color spaces : positions computed by
+#     the vertex shader, RGB values are uploaded
+#     once per image
+#   - level of detail : voxel histograms of the
+#     colors for huge images and while rotating
+#   - needs OpenGL 3.3
+#
+#-------------------------------------------------*/
+
+#include <QOpenGLContext>
+
+#include "opengl-points.h"
+#include "palette.h"
+#include "lib/image-utils.h"
+#include "lib/color-histogram.h"
+
+static const int cloudMaxPoints = 262144; // above this number of colors, fine voxels are drawn instead of all colors
+static const int cloudBins[CloudLevelCount] = {0, 128, 32}; // voxels per axis of each level - 0 = no voxels
+static const float cloudSplat[CloudLevelCount] = {1.0f, 1.5f, 3.0f}; // point size factor of each level
+
+///////////////////////////////////////////////
+//// Shaders
+///////////////////////////////////////////////
+
+static const char *pointVertexShader = // ColorSpacePositionsGLSL() is inserted after the first line
+    "layout(location = 0) in vec4 point;\n" // position (x,y,z) and weight in [0..1]
+    "layout(location = 1) in vec3 color;\n" // point color
+    "uniform mat4 projection;\n"
+    "uniform mat4 modelview;\n"
+    "uniform float pointSize;\n"
+    "uniform int colorSpace;\n" // -1 = positions already computed
+    "uniform float size3d;\n"
+    "out vec4 fragmentColor;\n"
+    "void main()\n"
+    "{\n"
+    "    vec3 position = point.xyz;\n"
+    "    if (colorSpace >= 0)\n"
+    "        position = ColorSpacePosition(colorSpace, color) * size3d * vec3(1.0, -1.0, 1.0);\n" // DrawSpherePlus coordinates -> OpenGL coordinates
+    "    gl_Position = projection * modelview * vec4(position, 1.0);\n"
+    "    gl_PointSize = max(1.0, pointSize * (0.25 + 0.75 * point.w));\n" // frequent colors are bigger...
+    "    fragmentColor = vec4(color, 0.2 + 0.8 * point.w);\n" // ... and more opaque
+    "}\n";
+
+static const char *pointFragmentShader =
+    "#version 330 core\n"
+    "in vec4 fragmentColor;\n"
+    "out vec4 outputColor;\n"
+    "void main()\n"
+    "{\n"
+    "    vec2 coord = gl_PointCoord * 2.0 - 1.0;\n" // round points
+    "    if (dot(coord, coord) > 1.0)\n"
+    "        discard;\n"
+    "    outputColor = fragmentColor;\n"
+    "}\n";
+
+///////////////////////////////////////////////
+//// Point cloud
+///////////////////////////////////////////////
+
+ColorPointCloud::ColorPointCloud()
+{
+    available = false; // nothing initialized yet
+    changed = true;
+    uploadedSpace = ColorSpaceRGB;
+    uploadedSize3d = 0;
+    uploadedShader = false;
+    for (int level = 0; level < CloudLevelCount; level++)
+        nb_points[level] = 0;
+}
+
+bool ColorPointCloud::Initialize() // create the shader and buffers - the OpenGL context must be current
+{
+    available = false;
+
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (!context)
+        return false;
+    QSurfaceFormat format = context->format();
+    if ((format.renderableType() == QSurfaceFormat::OpenGLES) or (format.version() < qMakePair(3, 3))) // GLSL 330 needed
+        return false;
+
+    initializeOpenGLFunctions();
+
+    const std::string vertexShader = "#version 330 core\n" + ColorSpacePositionsGLSL() + pointVertexShader; // color space positions first
+    if (!program.addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShader.c_str())) // compile shaders
+        return false;
+    if (!program.addShaderFromSourceCode(QOpenGLShader::Fragment, pointFragmentShader))
+        return false;
+    if (!program.link())
+        return false;
+
+    for (int level = 0; level < CloudLevelCount; level++) {
+        if (!vao[level].create())
+            return false;
+        vao[level].bind();
+
+        buffer[level].create(); // points : uploaded when the image or the color space change
+        buffer[level].setUsagePattern(QOpenGLBuffer::StaticDraw);
+        buffer[level].bind();
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 7 * sizeof(float), nullptr); // position and weight
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(float), reinterpret_cast<void*>(4 * sizeof(float))); // color
+        buffer[level].release();
+
+        vao[level].release();
+    }
+
+    available = true;
+    return true;
+}
+
+void ColorPointCloud::Destroy() // release all OpenGL objects - the OpenGL context must be current
+{
+    for (int level = 0; level < CloudLevelCount; level++) {
+        vao[level].destroy();
+        buffer[level].destroy();
+        nb_points[level] = 0;
+    }
+    program.removeAllShaders();
+    available = false;
+}
+
+void ColorPointCloud::SetImage(const cv::Mat &image) // find all distinct colors of a BGR 8-bit image and their counts
+{
+    if (image.empty() or (image.type() != CV_8UC3)) { // no usable image = no points
+        colors.clear();
+        counts.clear();
+    }
+    else
+        UniqueColorsImageRGB24(image, colors, counts); // 2^24 histogram, or sorted pixels for small images
+
+    changed = true; // positions must be computed again
+}
+
+void ColorPointCloud::Update(const ColorSpace3D &space, const float &size3d) // compute and upload positions of all colors
+{
+    if (!available)
+        return;
+
+    const bool shader = ColorSpaces3D[space].shader; // positions computed by the vertex shader : nothing to upload when the color space or size change
+    if ((!changed) and (((shader) and (uploadedShader)) or ((!shader) and (!uploadedShader) and (uploadedSpace == space) and (uploadedSize3d == size3d)))) { // nothing to do
+        uploadedSpace = space; // only uniforms change
+        uploadedSize3d = size3d;
+        return;
+    }
+
+    const int nb = Count();
+    std::vector<float> rgb(3 * size_t(nb)); // RGB values of all colors
+    #pragma omp parallel for
+    for (int n = 0; n < nb; n++) {
+        const int color = colors[n];
+        rgb[3 * size_t(n)] = ((color >> 16) & 0xff) / 255.0f;
+        rgb[3 * size_t(n) + 1] = ((color >> 8) & 0xff) / 255.0f;
+        rgb[3 * size_t(n) + 2] = (color & 0xff) / 255.0f;
+    }
+
+    std::vector<float> positions; // OpenGL coordinates of all colors - RGB values for the shader path, voxels are then made in RGB
+    if (shader)
+        positions = rgb;
+    else {
+        positions.resize(3 * size_t(nb));
+        std::vector<float> chunkPositions; // positions of one chunk
+
+        const int chunk = 65536; // colors are converted by chunks, so the palette store stays small
+        PaletteStore store; // same conversions as palette values
+        store.Resize(std::min(nb, chunk));
+
+        for (int begin = 0; begin < nb; begin += chunk) {
+            const int size = std::min(chunk, nb - begin);
+
+            for (int n = 0; n < size; n++) { // RGB values of chunk
+                store.RGB[n].R = rgb[3 * size_t(begin + n)];
+                store.RGB[n].G = rgb[3 * size_t(begin + n) + 1];
+                store.RGB[n].B = rgb[3 * size_t(begin + n) + 2];
+            }
+            store.ConvertFromRGB(size); // all common color spaces
+            if (ColorSpaces3D[space].extended)
+                store.ConvertExtended(size);
+            ColorSpaces3D[space].Positions(store, size, size3d, chunkPositions); // same positions as palette spheres
+
+            #pragma omp parallel for
+            for (int n = 0; n < size; n++) {
+                float *p = &positions[3 * size_t(begin + n)];
+                p[0] = chunkPositions[3 * n]; // DrawSpherePlus coordinates -> OpenGL coordinates
+                p[1] = -chunkPositions[3 * n + 1];
+                p[2] = chunkPositions[3 * n + 2];
+            }
+        }
+    }
+
+    for (int level = 0; level < CloudLevelCount; level++) {
+        std::vector<float> data; // x, y, z, weight, r, g, b for each point
+
+        if (cloudBins[level] == 0) { // all colors
+            int maxCount = 1; // weights are relative to the most frequent color
+            for (int n = 0; n < nb; n++)
+                maxCount = std::max(maxCount, counts[n]);
+            const double logMax = log(1.0 + maxCount);
+
+            data.resize(7 * size_t(nb));
+            #pragma omp parallel for
+            for (int n = 0; n < nb; n++) {
+                float *p = &data[7 * size_t(n)];
+                std::copy(&positions[3 * size_t(n)], &positions[3 * size_t(n)] + 3, p);
+                p[3] = log(1.0 + counts[n]) / logMax; // logarithmic weight : rare colors stay visible
+                std::copy(&rgb[3 * size_t(n)], &rgb[3 * size_t(n)] + 3, p + 4);
+            }
+        }
+        else { // voxels : number of points is bounded by the number of bins, not the number of colors
+            std::vector<struct_voxel> voxels;
+            VoxelHistogram(positions, rgb, counts, cloudBins[level], voxels);
+
+            long long maxCount = 1;
+            for (const struct_voxel &voxel : voxels)
+                maxCount = std::max(maxCount, voxel.count);
+            const double logMax = log(1.0 + maxCount);
+
+            data.reserve(7 * voxels.size());
+            for (const struct_voxel &voxel : voxels)
+                data.insert(data.end(), {voxel.x, voxel.y, voxel.z, float(log(1.0 + voxel.count) / logMax), voxel.R, voxel.G, voxel.B});
+        }
+
+        Upload(CloudLevel(level), data);
+    }
+
+    changed = false;
+    uploadedSpace = space;
+    uploadedSize3d = size3d;
+    uploadedShader = shader;
+}
+
+void ColorPointCloud::Upload(const CloudLevel &level, const std::vector<float> &data) // send points of one level to the GPU
+{
+    buffer[level].bind();
+    buffer[level].allocate(data.data(), int(data.size() * sizeof(float))); // one upload for all points
+    buffer[level].release();
+    nb_points[level] = int(data.size() / 7);
+}
+
+void ColorPointCloud::Draw(const QMatrix4x4 &projection, const QMatrix4x4 &modelview, const float &pointSize, const bool &interacting) // draw all points in one call
+{
+    CloudLevel level = CloudPoints; // level of detail
+    if (interacting) // coarse while the view moves
+        level = CloudVoxelsCoarse;
+    else if (nb_points[CloudPoints] > cloudMaxPoints) // too many colors
+        level = CloudVoxelsFine;
+
+    if ((!available) or (nb_points[level] == 0))
+        return;
+
+    glEnable(GL_PROGRAM_POINT_SIZE); // size computed by the shader
+#ifdef GL_POINT_SPRITE
+    glEnable(GL_POINT_SPRITE); // gl_PointCoord in compatibility contexts
+#endif
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // transparency
+    glDepthMask(GL_FALSE); // transparent points don't hide each other
+
+    program.bind();
+    program.setUniformValue("projection", projection);
+    program.setUniformValue("modelview", modelview);
+    program.setUniformValue("pointSize", pointSize * cloudSplat[level]); // voxels are bigger
+    program.setUniformValue("colorSpace", uploadedShader ? int(uploadedSpace) : -1); // switching color spaces only changes this value
+    program.setUniformValue("size3d", uploadedSize3d);
+
+    vao[level].bind();
+    glDrawArrays(GL_POINTS, 0, nb_points[level]); // all points at once
+    vao[level].release();
+
+    program.release(); // back to the fixed pipeline for the rest of the scene
+
+    glDepthMask(GL_TRUE); // back to default states
+    glBlendFunc(GL_ONE, GL_ZERO);
+    glDisable(GL_PROGRAM_POINT_SIZE);
+}
@@ -0,0 +1,72 @@
+/*#-------------------------------------------------
+#
+#       Image colors point cloud for OpenGL
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   - every distinct color of an image is a point
+#   - counts from a 24-bit RGB histogram
+#   - point size and opacity weighted by frequency
+#   - positions in any 3D color space, uploaded once
+#   - common color spaces : positions computed by
+#     the vertex shader, RGB values are uploaded
+#     once per image
+#   - level of detail : voxel histograms of the
+#     colors for huge images and while rotating
+#   - needs OpenGL 3.3
+#
+#-------------------------------------------------*/
+
+#ifndef OPENGLPOINTS_H
+#define OPENGLPOINTS_H
+
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLBuffer>
+#include <QOpenGLVertexArrayObject>
+#include <QMatrix4x4>
+
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+#include "opengl-color-spaces.h"
+
+enum CloudLevel {CloudPoints, CloudVoxelsFine, CloudVoxelsCoarse, CloudLevelCount}; // levels of detail : all colors, 128^3 voxels, 32^3 voxels
+
+class ColorPointCloud : protected QOpenGLExtraFunctions
+{
+public:
+    ColorPointCloud();
+
+    bool Initialize(); // create the shader and buffers - the OpenGL context must be current - false if not available
+    void Destroy(); // release all OpenGL objects - the OpenGL context must be current
+    bool IsAvailable() const { return available; } // point cloud rendering can be used
+
+    void SetImage(const cv::Mat &image); // find all distinct colors of a BGR 8-bit image and their counts
+    int Count() const { return int(colors.size()); } // number of distinct colors
+
+    void Update(const ColorSpace3D &space, const float &size3d); // compute and upload positions of all colors - only done when the image, color space or size changed
+    void Draw(const QMatrix4x4 &projection, const QMatrix4x4 &modelview, const float &pointSize, const bool &interacting); // draw all points in one call - coarse voxels while interacting, fine voxels if there are too many colors
+
+private:
+    bool available; // shader and buffers are ready
+    bool changed; // image changed since last upload
+    ColorSpace3D uploadedSpace; // color space of uploaded points
+    float uploadedSize3d; // size3d of uploaded points
+    bool uploadedShader; // uploaded points are RGB values, positions are computed by the vertex shader
+    int nb_points[CloudLevelCount]; // number of points in each buffer
+
+    std::vector<int> colors; // distinct 24-bit RGB values 0xRRGGBB
+    std::vector<int> counts; // number of pixels of each color
+
+    QOpenGLShaderProgram program; // point sprite shader
+    QOpenGLVertexArrayObject vao[CloudLevelCount]; // attributes layout of each level
+    QOpenGLBuffer buffer[CloudLevelCount]; // per point : x, y, z, weight, r, g, b
+
+    void Upload(const CloudLevel &level, const std::vector<float> &data); // send points of one level to the GPU
+};
+
+#endif // OPENGLPOINTS_H
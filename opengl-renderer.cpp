@@ -0,0 +1,240 @@
+/*#-------------------------------------------------
+#
+#          3D color space scene renderer
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   - everything drawn in the 3D view :
+#       . color space scaffold
+#       . palette spheres
+#       . image colors point cloud
+#   - owns its OpenGL objects, so the same scene can
+#     be drawn by the widget or offscreen
+#
+#-------------------------------------------------*/
+
+#include <QtOpenGL>
+
+#include "opengl-renderer.h"
+#include "opengl-draw.h"
+
+///////////////////////////////////////////////
+//// Renderer
+///////////////////////////////////////////////
+
+Renderer3D::Renderer3D()
+{
+    pixelsPerUnit3D = 0; // set by Resize
+    pixelRatio3D = 1;
+    spheresChanged = true; // no positions yet
+    spheresColorSpace = ColorSpaceRGB;
+    spheresSize3d = 0;
+    spheresSphereSize = 0;
+    scaffoldList = 0; // no display list yet
+    scaffoldColorSpace = ColorSpaceRGB;
+    scaffoldSize3d = 0;
+}
+
+void Renderer3D::Initialize() // OpenGL states, lights, instanced spheres and point cloud - the OpenGL context must be current
+{
+    glClearColor(0.2, 0.2, 0.2, 1.0);
+    glClear(Qt::black); // clear the screen with black color
+
+    glEnable(GL_DEPTH_TEST); // z-sorting
+    //glEnable(GL_DEPTH_CLAMP); // no clipping - it's a bit slower
+    glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT); // all material has ambiant light
+    glEnable(GL_COLOR_MATERIAL); // to see the two faces of a triangle, needed by lights when not shading
+    glShadeModel(GL_SMOOTH); // blend colors - GL_FLAT chooses one color in the polygon
+
+    glDisable(GL_CULL_FACE); // facet culling
+    glEnable(GL_BLEND); // prefer using GLBlendFunc, used by the anaglyphic view
+
+    //// Lights
+    GLfloat light_position[] = { 0, 0, 10000, 1.0 };
+    GLfloat light_ambient[]  = { 0.7, 0.7, 0.7, 1};
+    GLfloat light_diffuse[]  = { 1, 1, 1, 0.5};
+    glEnable(GL_LIGHTING); // enable lighting
+    glEnable(GL_LIGHT0); // define the first light
+    glLightfv(GL_LIGHT0, GL_POSITION, light_position);
+    glLightfv(GL_LIGHT0, GL_AMBIENT,  light_ambient); // ambient
+    glLightfv(GL_LIGHT0, GL_DIFFUSE,  light_diffuse); // diffuse
+
+    //// Instanced spheres
+    spheres.Initialize(3); // same subdivision as the spheres drawn by DrawSpherePlus - if it fails spheres are drawn one by one
+
+    //// Image colors point cloud
+    pointCloud.Initialize(); // if it fails the point cloud is not available
+
+    spheresChanged = true; // new OpenGL objects : everything must be uploaded
+}
+
+void Renderer3D::Destroy() // release all OpenGL objects - the OpenGL context must be current
+{
+    spheres.Destroy();
+    pointCloud.Destroy();
+    if (scaffoldList != 0)
+        glDeleteLists(scaffoldList, 1); // color space scaffold
+    scaffoldList = 0;
+}
+
+void Renderer3D::Resize(const int &width, const int &height, const float &pixelRatio) // viewport and projection
+{
+    double ratio = double(width) / height; // ratio of the viewport : width / height
+    glViewport(0, 0, width, height); // resize openGL viewport
+
+    glMatrixMode(GL_PROJECTION); // openGL projection mode
+    glLoadIdentity();
+#ifdef QT_OPENGL_ES_1 // older versions of openGL
+    glOrthof(-4 * 2048, +4 * 2048, -4 * 2048 / ratio, +4 * 2048  / ratio, -5000*2048, 5000*2048); // define view rectangle and clipping
+#else
+    glOrtho(-4 * 2048, +4 * 2048, -4 * 2048 / ratio, +4 * 2048 / ratio, -5000*2048, 5000*2048);
+#endif
+    projection3D.setToIdentity(); // same projection for the shaders
+    projection3D.ortho(-4 * 2048, +4 * 2048, -4 * 2048 / ratio, +4 * 2048 / ratio, -5000*2048, 5000*2048);
+    pixelsPerUnit3D = width * pixelRatio / (8.0 * 2048); // same scale on both axes
+    pixelRatio3D = pixelRatio;
+    glMatrixMode(GL_MODELVIEW); // now openGL model mode
+}
+
+void Renderer3D::Render(const struct_view_3d &view, const PaletteStore &palettes, const int &nb_palettes) // draw the scene
+{
+    const bool quality = view.qualityEnabled and (!view.interacting); // no antialiasing while the view moves
+    const int ndiv = view.interacting ? 1 : 3; // fewer triangles per sphere while the view moves
+
+    // lighting
+    if (view.lightEnabled) {
+        glEnable(GL_LIGHTING); // turn on the lights...
+    } else
+        glDisable(GL_LIGHTING); // ... or not
+
+    // quality
+    if (quality) { // antialiasing
+        glShadeModel(GL_SMOOTH); // blend colors
+        glEnable(GL_POINT_SMOOTH); // draw points with anti-aliasing
+        glEnable(GL_LINE_SMOOTH); // draw lines with anti-aliasing
+        glEnable(GL_POLYGON_SMOOTH); // draw polygons with anti-aliasing // can result in noise
+        glEnable(GL_DITHER); //dither color components
+        glEnable(GL_MULTISAMPLE); // use multiple fragment samples in computing the final color of a pixel
+    }
+    else { // no antialiasing
+        glShadeModel(GL_FLAT); // don't blend colors
+        glDisable(GL_POINT_SMOOTH); // draw aliased points
+        glDisable(GL_LINE_SMOOTH); // draw aliased lines
+        //glDisable(GL_POLYGON_SMOOTH); // draw aliased polygons
+        if (view.interacting)
+            glDisable(GL_POLYGON_SMOOTH); // polygon antialiasing is the most expensive
+        glDisable(GL_DITHER); //dither color components
+        glDisable(GL_MULTISAMPLE); // use multiple fragment samples in computing the final color of a pixel
+    }
+
+    //// init 3D view
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // clear color and depth buffers
+
+    glLoadIdentity(); // replace current matrix with identity matrix (reset)
+
+    glTranslatef(view.xShift, view.yShift, 0); // translation matrix for all objects - no z used
+
+    glScaled(view.zoom3D, view.zoom3D, view.zoom3D); // scale objects with zoom factor
+
+    glRotatef(view.xRot, 1.0, 0.0, 0.0); // rotate all objects
+    glRotatef(view.yRot, 0.0, 1.0, 0.0);
+    glRotatef(view.zRot, 0.0, 0.0, 1.0);
+
+    QMatrix4x4 modelview; // same transformations for the shaders
+    modelview.translate(view.xShift, view.yShift, 0);
+    modelview.scale(view.zoom3D);
+    modelview.rotate(view.xRot, 1.0, 0.0, 0.0);
+    modelview.rotate(view.yRot, 0.0, 1.0, 0.0);
+    modelview.rotate(view.zRot, 0.0, 0.0, 1.0);
+
+    //// Test text
+    //DrawText("(c)2019 AbsurdePhoton", -1000.0f, 1000.0f, size3d + 300, 15, 1, 1, 1, 4);
+
+    const struct_color_space_3d &space = ColorSpaces3D[view.colorSpace]; // render module of the current color space
+    const float size3d = view.size3d;
+    const int sphere_size = view.sphere_size;
+
+    //// draw color space
+
+    // scaffold only depends on the color space and its size : compiled once, then replayed each frame
+    if ((scaffoldList == 0) or (scaffoldColorSpace != view.colorSpace) or (scaffoldSize3d != size3d)) {
+        if (scaffoldList == 0)
+            scaffoldList = glGenLists(1); // display list id
+        glNewList(scaffoldList, GL_COMPILE); // record...
+            space.Scaffold(size3d);
+        glEndList(); // ... and stop recording
+        scaffoldColorSpace = view.colorSpace;
+        scaffoldSize3d = size3d;
+    }
+    glCallList(scaffoldList); // draw axes, circles, curves and labels
+
+    //// palette values
+
+    // positions only have to be computed and sent again to the GPU when the scene changes, not when the view is rotated, moved or zoomed
+    if (spheresChanged or (spheresColorSpace != view.colorSpace) or (spheresSize3d != size3d) or (spheresSphereSize != sphere_size)
+            or (int(positions3D.size()) != 3 * std::max(nb_palettes, 0))) {
+        space.Positions(palettes, nb_palettes, size3d, positions3D); // all positions in one pass
+
+        if (spheres.IsAvailable()) { // new instances
+            spheres.Clear();
+            for (int n = 0; n < nb_palettes; n++) // for each color in palette
+                if (palettes.visible[n])
+                    spheres.Add(positions3D[3 * n], -positions3D[3 * n + 1], positions3D[3 * n + 2],
+                                palettes.percentage[n] * size3d * nb_palettes / 500.0f * sphere_size,
+                                palettes.RGB[n].R, palettes.RGB[n].G, palettes.RGB[n].B); // same coordinates as DrawSphere
+            spheres.Upload();
+        }
+
+        spheresChanged = false;
+        spheresColorSpace = view.colorSpace;
+        spheresSize3d = size3d;
+        spheresSphereSize = sphere_size;
+    }
+
+    const float pixels = pixelsPerUnit3D * view.zoom3D; // screen pixels for one scene unit : subdivisions of each sphere follow its size on screen
+
+    for (int n = 0; n < nb_palettes; n++) { // spheres one by one, or only the circles of selected colors with instanced rendering
+        const float radius = palettes.percentage[n] * size3d * nb_palettes / 500.0f * sphere_size;
+        DrawSpherePlus(SphereLevel(radius * pixels, ndiv), radius,
+                       positions3D[3 * n], positions3D[3 * n + 1], positions3D[3 * n + 2],
+                       palettes.RGB[n].R, palettes.RGB[n].G, palettes.RGB[n].B,
+                       palettes.selected[n], palettes.visible[n]);
+    }
+
+    if (spheres.IsAvailable()) // all spheres at once, one call per level of detail
+        spheres.Draw(projection3D, modelview, view.lightEnabled, pixels, ndiv);
+
+    //// image colors, drawn last because they are transparent
+
+    if (view.pointCloudEnabled) {
+        pointCloud.Update(view.colorSpace, size3d); // only computed again when the image, color space or size changed
+        pointCloud.Draw(projection3D, modelview, sphere_size / 3.0f * pixelRatio3D * view.pointScale, view.interacting); // point size follows the sphere size factor - coarse voxels while moving
+    }
+}
+
+void Renderer3D::SetPointCloudImage(const cv::Mat &image) // all distinct colors of this BGR image are shown as points
+{
+    pointCloud.SetImage(image);
+}
+
+void Renderer3D::DrawSpherePlus(const int &ndiv, const float &radius, const float &x, const float &y, const float &z, const float &r, const float &g, const float &b, const bool &circle, const bool &visible) // draw a sphere with a white circle if color chosen
+{
+    if (!visible)
+        return;
+
+    if (!spheres.IsAvailable()) { // with instanced rendering the sphere is already in the instance buffer
+        if (ndiv < 0) { // smaller than one pixel
+            glColor3f(r, g, b);
+            glBegin(GL_POINTS);
+                glVertex3f(x, -y, z);
+            glEnd();
+        }
+        else
+            DrawSphere(ndiv, radius, x, y, z, r, g, b); // first draw the sphere
+    }
+    if (circle) // draw white circle around the sphere ?
+        DrawCircleXY(x, -y, z, radius + 4.0f, 100, 1, 1, 1, 4); // draw the white circle around the sphere
+}
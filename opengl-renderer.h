@@ -0,0 +1,80 @@
+/*#-------------------------------------------------
+#
+#          3D color space scene renderer
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   - everything drawn in the 3D view :
+#       . color space scaffold
+#       . palette spheres
+#       . image colors point cloud
+#   - owns its OpenGL objects, so the same scene can
+#     be drawn by the widget or offscreen
+#
+#-------------------------------------------------*/
+
+#ifndef OPENGLRENDERER_H
+#define OPENGLRENDERER_H
+
+#include <QOpenGLContext>
+#include <QMatrix4x4>
+
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+#include "palette.h"
+#include "opengl-spheres.h"
+#include "opengl-color-spaces.h"
+#include "opengl-points.h"
+
+struct struct_view_3d { // camera and options of one rendering of the 3D scene
+    ColorSpace3D colorSpace; // color space to plot
+    double xRot, yRot, zRot; // rotation in degrees
+    int xShift, yShift; // position
+    double zoom3D; // zoom coefficient
+    float size3d; // size of the color space
+    int sphere_size; // size factor for spheres
+    bool lightEnabled; // light
+    bool qualityEnabled; // antialiasing
+    bool pointCloudEnabled; // draw all colors of the image as points
+    bool interacting; // the view is moving : lower quality
+    float pointScale; // point cloud size factor - > 1 when the scene is rendered bigger than on screen
+};
+
+class Renderer3D
+{
+public:
+    Renderer3D();
+
+    void Initialize(); // OpenGL states, lights, instanced spheres and point cloud - the OpenGL context must be current
+    void Destroy(); // release all OpenGL objects - the OpenGL context must be current
+    void Resize(const int &width, const int &height, const float &pixelRatio); // viewport and projection - pixelRatio = framebuffer pixels for one viewport unit
+    void Render(const struct_view_3d &view, const PaletteStore &palettes, const int &nb_palettes); // draw the scene - palette values of extended color spaces must be up to date
+
+    void PaletteChanged() { spheresChanged = true; } // palette values or visibility changed : spheres are rebuilt at next render
+    void SetPointCloudImage(const cv::Mat &image); // all distinct colors of this BGR image are shown as points
+
+private:
+    QMatrix4x4 projection3D; // same projection as glOrtho, for the shaders
+    float pixelsPerUnit3D; // framebuffer pixels for one scene unit at zoom 1, from the glOrtho width - for the spheres level of detail
+    float pixelRatio3D; // framebuffer pixels for one viewport unit - point sizes
+
+    InstancedSpheres spheres; // all spheres of the scene drawn in one call
+    ColorPointCloud pointCloud; // all colors of the image
+    std::vector<float> positions3D; // (x,y,z) of each palette color in the current color space
+    bool spheresChanged; // palette changed since the positions were computed
+    ColorSpace3D spheresColorSpace; // color space of the computed positions
+    float spheresSize3d; // size3d of the computed positions
+    int spheresSphereSize; // sphere size factor of the uploaded instances
+
+    GLuint scaffoldList; // display list of the color space scaffold - 0 = not created yet
+    ColorSpace3D scaffoldColorSpace; // color space of the compiled scaffold
+    float scaffoldSize3d; // size3d of the compiled scaffold
+
+    void DrawSpherePlus(const int &ndiv, const float &radius, const float &x, const float &y, const float &z, const float &r, const float &g, const float &b, const bool &circle, const bool &visible); // draw a sphere with a white circle if selected - ndiv < 0 = point
+};
+
+#endif // OPENGLRENDERER_H
@@ -0,0 +1,236 @@
+/*#-------------------------------------------------
+#
+#        Instanced spheres for OpenGL
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   - sphere meshes of all subdivision levels
+#     uploaded once
+#   - one instance per sphere : center, radius, color
+#   - level of detail from the projected radius :
+#     one instanced draw call per level, spheres
+#     smaller than one pixel are drawn as points
+#   - needs OpenGL 3.3, else the caller keeps
+#     using DrawSphere
+#
+#-------------------------------------------------*/
+
+#include <QOpenGLContext>
+
+#include <algorithm>
+#include <numeric>
+
+#include "opengl-spheres.h"
+#include "opengl-draw.h"
+
+///////////////////////////////////////////////
+//// Shaders
+///////////////////////////////////////////////
+
+// the lighting reproduces the fixed pipeline setup of the 3D widget :
+// material ambient = color (glColorMaterial), scene ambient 0.2 + light ambient 0.7, default material diffuse 0.8, white light at (0,0,10000) in eye space
+static const char *sphereVertexShader =
+    "#version 330 core\n"
+    "layout(location = 0) in vec3 vertex;\n" // unit sphere vertex, also its normal - (0,0,0) for spheres drawn as points
+    "layout(location = 1) in vec4 sphere;\n" // center (x,y,z) and radius
+    "layout(location = 2) in vec3 color;\n" // sphere color
+    "uniform mat4 projection;\n"
+    "uniform mat4 modelview;\n"
+    "uniform bool light;\n"
+    "out vec3 fragmentColor;\n"
+    "void main()\n"
+    "{\n"
+    "    vec4 position = modelview * vec4(sphere.xyz + vertex * sphere.w, 1.0);\n"
+    "    gl_Position = projection * position;\n"
+    "    if (light && (dot(vertex, vertex) > 0.0)) {\n"
+    "        vec3 normal = normalize(mat3(modelview) * vertex);\n"
+    "        vec3 direction = normalize(vec3(0.0, 0.0, 10000.0) - position.xyz);\n"
+    "        fragmentColor = clamp(color * 0.9 + vec3(0.8 * max(dot(normal, direction), 0.0)), 0.0, 1.0);\n"
+    "    }\n"
+    "    else\n"
+    "        fragmentColor = color;\n"
+    "}\n";
+
+static const char *sphereFragmentShader =
+    "#version 330 core\n"
+    "in vec3 fragmentColor;\n"
+    "out vec4 outputColor;\n"
+    "void main()\n"
+    "{\n"
+    "    outputColor = vec4(fragmentColor, 1.0);\n"
+    "}\n";
+
+///////////////////////////////////////////////
+//// Level of detail
+///////////////////////////////////////////////
+
+int SphereLevel(const float &radiusPixels, const int &ndiv) // subdivisions needed by a sphere of this projected radius in pixels
+{
+    if (radiusPixels < 1.0f) // not even one pixel : a point is enough
+        return -1;
+
+    int level = 0; // 20 triangles under 4 pixels, then x4 triangles each time the radius is x3
+    float limit = 4.0f;
+    while ((level < ndiv) and (radiusPixels >= limit)) {
+        level++;
+        limit *= 3.0f;
+    }
+
+    return level;
+}
+
+///////////////////////////////////////////////
+//// Instanced spheres
+///////////////////////////////////////////////
+
+InstancedSpheres::InstancedSpheres()
+    : mesh(QOpenGLBuffer::VertexBuffer), instanceBuffer(QOpenGLBuffer::VertexBuffer)
+{
+    available = false; // nothing initialized yet
+    nb_instances = 0;
+}
+
+bool InstancedSpheres::Initialize(const int &ndiv) // create the shader and the sphere mesh - the OpenGL context must be current
+{
+    available = false;
+
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (!context)
+        return false;
+    QSurfaceFormat format = context->format();
+    if ((format.renderableType() == QSurfaceFormat::OpenGLES) or (format.version() < qMakePair(3, 3))) // GLSL 330 and instanced arrays needed
+        return false;
+
+    initializeOpenGLFunctions();
+
+    if (!program.addShaderFromSourceCode(QOpenGLShader::Vertex, sphereVertexShader)) // compile shaders
+        return false;
+    if (!program.addShaderFromSourceCode(QOpenGLShader::Fragment, sphereFragmentShader))
+        return false;
+    if (!program.link())
+        return false;
+
+    std::vector<float> vertices; // unit spheres of all levels one after the other, same geometry as DrawSphere
+    levelFirst.clear();
+    levelCount.clear();
+    for (int level = 0; level <= ndiv; level++) {
+        levelFirst.push_back(int(vertices.size() / 3));
+        SphereMesh(level, vertices);
+        levelCount.push_back(int(vertices.size() / 3) - levelFirst.back());
+    }
+    levelFirst.push_back(int(vertices.size() / 3)); // center only, for spheres drawn as points
+    levelCount.push_back(1);
+    vertices.insert(vertices.end(), {0.0f, 0.0f, 0.0f});
+
+    if (!vao.create())
+        return false;
+    vao.bind();
+
+    mesh.create(); // sphere mesh : uploaded once
+    mesh.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    mesh.bind();
+    mesh.allocate(vertices.data(), int(vertices.size() * sizeof(float)));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
+    mesh.release();
+
+    instanceBuffer.create(); // spheres : uploaded when the scene changes
+    instanceBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    instanceBuffer.bind(); // attribute pointers are set by Draw, for each level
+    glEnableVertexAttribArray(1); // center and radius
+    glVertexAttribDivisor(1, 1); // one value per sphere
+    glEnableVertexAttribArray(2); // color
+    glVertexAttribDivisor(2, 1);
+    instanceBuffer.release();
+
+    vao.release();
+
+    available = true;
+    return true;
+}
+
+void InstancedSpheres::Destroy() // release all OpenGL objects - the OpenGL context must be current
+{
+    vao.destroy();
+    mesh.destroy();
+    instanceBuffer.destroy();
+    program.removeAllShaders();
+    available = false;
+    nb_instances = 0;
+}
+
+void InstancedSpheres::Clear() // begin a new list of spheres
+{
+    instances.clear();
+}
+
+void InstancedSpheres::Add(const float &x, const float &y, const float &z, const float &radius, const float &r, const float &g, const float &b) // add one sphere
+{
+    instances.insert(instances.end(), {x, y, z, radius, r, g, b});
+}
+
+void InstancedSpheres::Upload() // send the list of spheres to the GPU, sorted by radius
+{
+    nb_instances = int(instances.size() / 7);
+    if (!available)
+        return;
+
+    // sorted by decreasing radius, spheres of each level of detail are contiguous whatever the zoom
+    std::vector<int> order(nb_instances);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](const int &a, const int &b) { return instances[7 * a + 3] > instances[7 * b + 3]; });
+
+    std::vector<float> sorted(instances.size());
+    radii.resize(nb_instances);
+    for (int n = 0; n < nb_instances; n++) {
+        std::copy(&instances[7 * order[n]], &instances[7 * order[n]] + 7, &sorted[7 * n]);
+        radii[n] = sorted[7 * n + 3];
+    }
+
+    instanceBuffer.bind();
+    instanceBuffer.allocate(sorted.data(), int(sorted.size() * sizeof(float))); // the buffer is reallocated, no need to wait for the previous frame
+    instanceBuffer.release();
+}
+
+void InstancedSpheres::Draw(const QMatrix4x4 &projection, const QMatrix4x4 &modelview, const bool &light, const float &pixelsPerUnit, const int &ndiv) // draw all uploaded spheres, one call per level of detail
+{
+    if ((!available) or (nb_instances == 0))
+        return;
+
+    const int maxLevel = std::min(ndiv, int(levelCount.size()) - 2); // only the levels created by Initialize
+
+    program.bind();
+    program.setUniformValue("projection", projection);
+    program.setUniformValue("modelview", modelview);
+    program.setUniformValue("light", light);
+
+    vao.bind();
+    instanceBuffer.bind();
+
+    int begin = 0; // first sphere of the current level
+    for (int level = maxLevel; level >= -1; level--) { // from the biggest spheres to the points
+        const auto last = std::partition_point(radii.begin() + begin, radii.end(),
+                                               [&](const float &radius) { return SphereLevel(radius * pixelsPerUnit, maxLevel) >= level; }); // radii are sorted
+        const int end = int(last - radii.begin());
+        if (end == begin)
+            continue;
+
+        // instance attributes start at the first sphere of the level
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 7 * sizeof(float), reinterpret_cast<void*>(7 * sizeof(float) * size_t(begin))); // center and radius
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(float), reinterpret_cast<void*>(7 * sizeof(float) * size_t(begin) + 4 * sizeof(float))); // color
+
+        if (level < 0) // smaller than one pixel
+            glDrawArraysInstanced(GL_POINTS, levelFirst.back(), 1, end - begin);
+        else
+            glDrawArraysInstanced(GL_TRIANGLES, levelFirst[level], levelCount[level], end - begin);
+
+        begin = end;
+    }
+
+    instanceBuffer.release();
+    vao.release();
+
+    program.release(); // back to the fixed pipeline for the rest of the scene
+}
@@ -0,0 +1,64 @@
+/*#-------------------------------------------------
+#
+#        Instanced spheres for OpenGL
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   - sphere meshes of all subdivision levels
+#     uploaded once
+#   - one instance per sphere : center, radius, color
+#   - level of detail from the projected radius :
+#     one instanced draw call per level, spheres
+#     smaller than one pixel are drawn as points
+#   - needs OpenGL 3.3, else the caller keeps
+#     using DrawSphere
+#
+#-------------------------------------------------*/
+
+#ifndef OPENGLSPHERES_H
+#define OPENGLSPHERES_H
+
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLBuffer>
+#include <QOpenGLVertexArrayObject>
+#include <QMatrix4x4>
+
+#include <vector>
+
+int SphereLevel(const float &radiusPixels, const int &ndiv); // subdivisions needed by a sphere of this projected radius in pixels, at most ndiv - -1 = smaller than one pixel, drawn as a point
+
+class InstancedSpheres : protected QOpenGLExtraFunctions
+{
+public:
+    InstancedSpheres();
+
+    bool Initialize(const int &ndiv); // create the shader and the sphere meshes with 0 to ndiv subdivisions - the OpenGL context must be current - false if instancing is not available
+    void Destroy(); // release all OpenGL objects - the OpenGL context must be current
+    bool IsAvailable() const { return available; } // instanced rendering can be used
+
+    void Clear(); // begin a new list of spheres
+    void Add(const float &x, const float &y, const float &z, const float &radius, const float &r, const float &g, const float &b); // add one sphere - same coordinates as the vertices sent to OpenGL
+    void Upload(); // send the list of spheres to the GPU, sorted by radius
+    int Count() const { return nb_instances; } // number of spheres uploaded
+
+    void Draw(const QMatrix4x4 &projection, const QMatrix4x4 &modelview, const bool &light, const float &pixelsPerUnit, const int &ndiv); // draw all uploaded spheres, one call per level of detail - pixelsPerUnit converts radii to screen pixels, ndiv = maximum subdivisions
+
+private:
+    bool available; // shader and buffers are ready
+    std::vector<int> levelFirst; // first vertex of the mesh of each subdivision level - last one is the center point
+    std::vector<int> levelCount; // number of vertices of the mesh of each subdivision level
+    int nb_instances; // number of spheres in the instance buffer
+
+    std::vector<float> instances; // per sphere : x, y, z, radius, r, g, b
+    std::vector<float> radii; // radius of each uploaded sphere, in decreasing order
+
+    QOpenGLShaderProgram program; // sphere shader
+    QOpenGLVertexArrayObject vao; // attributes layout
+    QOpenGLBuffer mesh; // unit sphere vertices
+    QOpenGLBuffer instanceBuffer; // per sphere values
+};
+
+#endif // OPENGLSPHERES_H
@@ -13,6 +13,9 @@
 #         . rotate view on z axis with CTRL + left mouse button
 #         . move view on x/y axes with right mouse button
 #         . sphere size with CTRL + wheel
+#     - Render on demand :
+#         . one redraw per displayed frame
+#         . lower quality while the view moves
 #
 # * QT signals sent when zoomed, moved, rotated, sphere size
 #
@@ -45,12 +48,25 @@ using namespace std;
 openGLWidget::openGLWidget(QWidget *parent)
     : QOpenGLWidget(parent)
 {
-
+    nb_palettes = 0; // no palette yet
+    extendedConverted = false; // nothing computed yet
+    colorSpace = ColorSpaceRGB; // default color space
+    offscreenImageChanged = false; // no image yet
+
+    interacting = false; // view not moving
+    frameInFlight = false; // no frame yet
+    redrawPending = false;
+    idleTimer.setSingleShot(true); // full quality again 200 ms after the last input
+    idleTimer.setInterval(200);
+    connect(&idleTimer, &QTimer::timeout, this, &openGLWidget::InteractionFinished);
+    connect(this, &QOpenGLWidget::frameSwapped, this, &openGLWidget::FrameSwapped);
 }
 
 openGLWidget::~openGLWidget()
 {
-
+    makeCurrent(); // OpenGL objects must be released with their context
+    renderer.Destroy();
+    doneCurrent();
 }
 
 ///////////////////////////////////////////////
@@ -60,17 +76,7 @@ openGLWidget::~openGLWidget()
 
 void openGLWidget::initializeGL() // launched when the widget is initialized
 {
-    glClearColor(0.2, 0.2, 0.2, 1.0);
-    glClear(Qt::black); // clear the screen with black color
-
-    glEnable(GL_DEPTH_TEST); // z-sorting
-    //glEnable(GL_DEPTH_CLAMP); // no clipping - it's a bit slower
-    glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT); // all material has ambiant light
-    glEnable(GL_COLOR_MATERIAL); // to see the two faces of a triangle, needed by lights when not shading
-    glShadeModel(GL_SMOOTH); // blend colors - GL_FLAT chooses one color in the polygon
-
-    glDisable(GL_CULL_FACE); // facet culling
-    glEnable(GL_BLEND); // prefer using GLBlendFunc, used by the anaglyphic view
+    renderer.Initialize(); // OpenGL states, lights, spheres and point cloud
 
     xRot = 287; // initial values of rotation
     yRot = 0;
@@ -81,22 +87,14 @@ void openGLWidget::initializeGL() // launched when the widget is initialized
     axesEnabled = true; // draw 3D origin axes enabled
     lightEnabled = false; // light disabled
     qualityEnabled = true; // antialiasing enabled
-
-    //// Lights
-    GLfloat light_position[] = { 0, 0, 10000, 1.0 };
-    GLfloat light_ambient[]  = { 0.7, 0.7, 0.7, 1};
-    GLfloat light_diffuse[]  = { 1, 1, 1, 0.5};
-    glEnable(GL_LIGHTING); // enable lighting
-    glEnable(GL_LIGHT0); // define the first light
-    glLightfv(GL_LIGHT0, GL_POSITION, light_position);
-    glLightfv(GL_LIGHT0, GL_AMBIENT,  light_ambient); // ambient
-    glLightfv(GL_LIGHT0, GL_DIFFUSE,  light_diffuse); // diffuse
+    pointCloudEnabled = false; // only palette colors
 
     // Initialize RGB space spheres for first display
     sphere_size = 30; // sphere size factor
-    color_space = "RGB";
+    SetColorSpace(ColorSpaceRGB);
     size3d = 1000.0;
 
+    palettes.Resize(729); // 9 * 9 * 9 values
     nb_palettes = -1; // we are going to populate the palette with 512 values
     for (int i = 0; i < 9; i++) // 9 * 9 * 9 spĥeres
         for (int j = 0; j < 9; j++)
@@ -104,12 +102,12 @@ void openGLWidget::initializeGL() // launched when the widget is initialized
                 nb_palettes++; // palette index
 
                 // RGB
-                palettes[nb_palettes].RGB.R = i / 8.0; // RGB values
-                palettes[nb_palettes].RGB.G = j / 8.0;
-                palettes[nb_palettes].RGB.B = k / 8.0;
-                palettes[nb_palettes].percentage = 1.0 / powl(9.0, 3.0); // percentage
-                palettes[nb_palettes].selected = false; // color not selected
-                palettes[nb_palettes].visible = true; // color shown
+                palettes.RGB[nb_palettes].R = i / 8.0; // RGB values
+                palettes.RGB[nb_palettes].G = j / 8.0;
+                palettes.RGB[nb_palettes].B = k / 8.0;
+                palettes.percentage[nb_palettes] = 1.0 / powl(9.0, 3.0); // percentage
+                palettes.selected[nb_palettes] = false; // color not selected
+                palettes.visible[nb_palettes] = true; // color shown
             }
     nb_palettes++; // adjust number of palettes that must be in [1..x]
     ConvertPaletteFromRGB(); // convert RGB to other values
@@ -119,1029 +117,75 @@ void openGLWidget::initializeGL() // launched when the widget is initialized
 
 void openGLWidget::paintGL() // 3D rendering
 {
-    // lighting
-    if (lightEnabled) {
-        glEnable(GL_LIGHTING); // turn on the lights...
-    } else
-        glDisable(GL_LIGHTING); // ... or not
-
-    // quality
-    if (qualityEnabled) { // antialiasing
-        glShadeModel(GL_SMOOTH); // blend colors
-        glEnable(GL_POINT_SMOOTH); // draw points with anti-aliasing
-        glEnable(GL_LINE_SMOOTH); // draw lines with anti-aliasing
-        glEnable(GL_POLYGON_SMOOTH); // draw polygons with anti-aliasing // can result in noise
-        glEnable(GL_DITHER); //dither color components
-        glEnable(GL_MULTISAMPLE); // use multiple fragment samples in computing the final color of a pixel
-    }
-    else { // no antialiasing
-        glShadeModel(GL_FLAT); // don't blend colors
-        glDisable(GL_POINT_SMOOTH); // draw aliased points
-        glDisable(GL_LINE_SMOOTH); // draw aliased lines
-        //glDisable(GL_POLYGON_SMOOTH); // draw aliased polygons
-        glDisable(GL_DITHER); //dither color components
-        glDisable(GL_MULTISAMPLE); // use multiple fragment samples in computing the final color of a pixel
-    }
-
-    //// init 3D view
-
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // clear color and depth buffers
-
-    glLoadIdentity(); // replace current matrix with identity matrix (reset)
-
-    glTranslatef(xShift, yShift, 0); // translation matrix for all objects - no z used
-
-    glScaled(zoom3D, zoom3D, zoom3D); // scale objects with zoom factor
-
-    glRotatef(xRot, 1.0, 0.0, 0.0); // rotate all objects
-    glRotatef(yRot, 0.0, 1.0, 0.0);
-    glRotatef(zRot, 0.0, 0.0, 1.0);
-
-    //// Test text
-    //DrawText("(c)2019 AbsurdePhoton", -1000.0f, 1000.0f, size3d + 300, 15, 1, 1, 1, 4);
-
-    //// draw color space
-
-    if (color_space == "RGB") { // RGB
-        // green x axis
-        glLineWidth(32); // bigger width of the lines to really see them
-        glBegin(GL_LINES); // draw several lines
-            glColor3d(0,0,0); // axis origin : black
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glColor3d(0,1,0); // x/R axis color : red
-            glVertex3f(size3d, 0.0f, 0.0f);
-        glEnd();
-        DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 0, 1, 0);
-        DrawText("G", size3d + 300, -50.0f, 0.0f, 20, 0, 1, 0, 4);
-
-        // red y axis
-        glLineWidth(32); // bigger width of the lines to really see them
-        glBegin(GL_LINES);
-            glColor3d(0,0,0); // axis origin : black
-            glVertex3f( 0.0f,     0.0f, 0.0f );
-            glColor3d(1,0,0); // green
-            glVertex3f( 0.0f, -size3d, 0.0f );
-        glEnd();
-        DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 0, 0);
-        DrawText("R", -50.0f, -size3d - 400, 0.0f, 20, 1, 0, 0, 4);
-
-        // blue z axis
-        glLineWidth(32); // bigger width of the lines to really see them
-        glBegin(GL_LINES);
-            glColor3d(0,0,0); // axis origin : black
-            glVertex3f( 0.0f, 0.0f,    0.0f);
-            glColor3d(0,0,1); // z axis color : blue
-            glVertex3f( 0.0f, 0.0f, size3d);
-        glEnd();
-        DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 0, 0, 1);
-        DrawText("B", -150.0f, 150.0f, size3d + 300, 20, 0, 0, 1, 4);
-
-        // Triangle
-        glLineWidth(4);
-        glBegin(GL_LINE_LOOP); // draw closed lines
-            glColor3d(1, 0, 0); // red
-            glVertex3f(0, -size3d, 0); // vertex
-            glColor3d(0, 0, 1); // blue
-            glVertex3f(0, 0, size3d); // vertex
-            glColor3d(0, 1, 0); // green
-            glVertex3f(size3d, 0, 0); // vertex
-        glEnd();
-
-        /*// Rest of the cube
-        glLineWidth(4);
-        glBegin(GL_LINES);
-            glColor3d(1,1,1); // axis origin : white
-            glVertex3f(size3d, -size3d, size3d);
-            glColor3d(1,0,1); // violet
-            glVertex3f(size3d, 0.0f, size3d);
-        glEnd();
-
-        glBegin(GL_LINES);
-            glColor3d(1,1,1); // axis origin : white
-            glVertex3f(size3d, -size3d, size3d);
-            glColor3d(1,1,0); // yellow
-            glVertex3f(size3d, -size3d, 0.0f);
-        glEnd();
-
-        glBegin(GL_LINES);
-            glColor3d(1,1,1); // axis origin : white
-            glVertex3f(size3d, -size3d, size3d);
-            glColor3d(0,1,1); // cyan
-            glVertex3f(0.0f, -size3d, size3d);
-        glEnd();
-
-        glBegin(GL_LINES);
-            glColor3d(0,1,1); // axis origin : cyan
-            glVertex3f(0.0f, -size3d, size3d);
-            glColor3d(0,1,0); // green
-            glVertex3f(0.0f, -size3d, 0.0f);
-        glEnd();
-
-        glBegin(GL_LINES);
-            glColor3d(0,1,0); // axis origin : green
-            glVertex3f(0.0f, -size3d, 0.0f);
-            glColor3d(1,1,0); // yellow
-            glVertex3f(size3d, -size3d, 0.0f);
-        glEnd();
-
-        glBegin(GL_LINES);
-            glColor3d(1,1,0); // axis origin : yellow
-            glVertex3f(size3d, -size3d, 0.0f);
-            glColor3d(1,0,0); // red
-            glVertex3f(size3d, 0.0f, 0.0f);
-        glEnd();
-
-        glBegin(GL_LINES);
-            glColor3d(1,0,1); // axis origin : violet
-            glVertex3f(size3d, 0.0f, size3d);
-            glColor3d(1,0,0); // red
-            glVertex3f(size3d, 0.0f, 0.0f);
-        glEnd();
-
-        glBegin(GL_LINES);
-            glColor3d(1,0,1); // axis origin : violet
-            glVertex3f(size3d, 0.0f, size3d);
-            glColor3d(0,0,1); // blue
-            glVertex3f(0.0f, 0.0f, size3d);
-        glEnd();
-
-        glBegin(GL_LINES);
-            glColor3d(0,0,1); // axis origin : blue
-            glVertex3f(0.0f, 0.0f, size3d);
-            glColor3d(0,1,1); // cyan
-            glVertex3f(0.0f, -size3d, size3d);
-        glEnd();*/
-
-        // values
-        for (int n = 0; n < nb_palettes;n++) // for each color in palette
-            DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                       palettes[n].RGB.G * size3d,
-                       palettes[n].RGB.R * size3d,
-                       palettes[n].RGB.B * size3d,
-                       palettes[n].RGB.R, palettes[n].RGB.G,palettes[n].RGB.B,
-                       palettes[n].selected, palettes[n].visible);
-    }
-
-    if (color_space == "RGB Triangle") { // RGB triangle
-        // green x axis
-        glLineWidth(32); // bigger width of the lines to really see them
-        glBegin(GL_LINES); // draw several lines
-            glColor3d(0,0,0); // axis origin : black
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glColor3d(0,1,0); // x/R axis color : red
-            glVertex3f(size3d, 0.0f, 0.0f);
-        glEnd();
-        DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 0, 1, 0);
-        DrawText("G", size3d + 300, -50.0f, 0.0f, 20, 0, 1, 0, 4);
-
-        // red y axis
-        glLineWidth(32); // bigger width of the lines to really see them
-        glBegin(GL_LINES);
-            glColor3d(0,0,0); // axis origin : black
-            glVertex3f( 0.0f,     0.0f, 0.0f );
-            glColor3d(1,0,0); // green
-            glVertex3f( 0.0f, -size3d, 0.0f );
-        glEnd();
-        DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 0, 0);
-        DrawText("R", -50.0f, -size3d - 400, 0.0f, 20, 1, 0, 0, 4);
-
-        // blue z axis
-        glLineWidth(32); // bigger width of the lines to really see them
-        glBegin(GL_LINES);
-            glColor3d(0,0,0); // axis origin : black
-            glVertex3f( 0.0f, 0.0f,    0.0f);
-            glColor3d(0,0,1); // z axis color : blue
-            glVertex3f( 0.0f, 0.0f, size3d);
-        glEnd();
-        DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 0, 0, 1);
-        DrawText("B", -150.0f, 150.0f, size3d + 300, 20, 0, 0, 1, 4);
-
-        // Triangle
-        glLineWidth(4);
-        glBegin(GL_LINE_LOOP); // draw closed lines
-            glColor3d(1, 0, 0); // red
-            glVertex3f(0, -size3d, 0); // vertex
-            glColor3d(0, 0, 1); // blue
-            glVertex3f(0, 0, size3d); // vertex
-            glColor3d(0, 1, 0); // green
-            glVertex3f(size3d, 0, 0); // vertex
-        glEnd();
-
-        // values
-        for (int n = 0; n < nb_palettes;n++) { // for each color in palette
-            float sum = palettes[n].RGB.R + palettes[n].RGB.G + palettes[n].RGB.B;
-            float r = palettes[n].RGB.R / sum;
-            float g = palettes[n].RGB.G / sum;
-            float b = palettes[n].RGB.B / sum;
-            DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                       g * size3d, r * size3d, b * size3d,
-                       palettes[n].RGB.R, palettes[n].RGB.G,palettes[n].RGB.B,
-                       palettes[n].selected, palettes[n].visible);
-        }
-    }
-
-    if (color_space == "HSV") { // HSV
-        // colored circle
-        int num_segments = 360;
-        double R, G, B;
-        glLineWidth(32);
-        glBegin(GL_LINE_LOOP); // colored circle
-            for (int i = 0; i < num_segments; i++) {
-                double angle = double(i) / double(num_segments); //current angle
-                HSVtoRGB(angle, 1, 1, R, G, B);
-                glColor3d(R, G, B); // color of segment
-                glVertex3f(size3d * cosl(-angle * 2.0f * Pi), -size3d * sin(-angle * 2.0f * Pi), size3d); // vertex
-            }
-        glEnd();
-
-        // arc = H
-        DrawCircleArcXY(0, 0, size3d + 300, size3d + 400, 360, 315, 360,  1, 1, 1, 32);
-        DrawConeY(size3d + 400, -30, size3d + 300, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("H", size3d + 530, 0, size3d + 300, 20, 1, 1, 1, 4);
-
-        /*// black circle
-        DrawCircleXY(0, 0, 0, size3d, 360, 0, 0, 0, 32);*/
-
-        // vertical axis black to white
-        glLineWidth(32);
-        glBegin(GL_LINES);
-            glColor3d(0,0,0); // axis origin : black
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glColor3d(1,1,1); // axis end : white
-            glVertex3f(0.0f, 0.0f, size3d);
-        glEnd();
-        DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("V", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
-
-        // values
-        for (int n = 0; n < nb_palettes;n++) // for each color in palette
-            DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                       palettes[n].HSV.S * cos(-palettes[n].HSV.H * 2 * Pi) * size3d,
-                       palettes[n].HSV.S * sin(-palettes[n].HSV.H * 2 * Pi) * size3d,
-                       palettes[n].HSV.V * size3d,
-                       palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B,
-                       palettes[n].selected, palettes[n].visible);
-    }
-
-    if (color_space == "HSL") { // HSL
-        // colored circle
-        int num_segments = 360;
-        double R, G, B;
-        glLineWidth(32);
-        glBegin(GL_LINE_LOOP); // colored circle
-            for (int i = 0; i < num_segments; i++) {
-                double theta = 2.0f * Pi * double(i) / double(num_segments); //current angle
-                HSLtoRGB(-double(i) / double(num_segments), 1, 0.5, R, G, B);
-                glColor3d(R, G, B); // color of segment
-                glVertex3f(size3d * cosl(theta), -size3d * sin(theta), 500.0f); // vertex
-            }
-        glEnd();
-
-        // arc = H
-        DrawCircleArcXY(0, 0, size3d + 300, size3d + 400, 360, 315, 360,  1, 1, 1, 32);
-        DrawConeY(size3d + 400, -30, size3d + 300, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("H", size3d + 530, 0, size3d + 300, 20, 1, 1, 1, 4);
-
-        /*// black circle
-        DrawCircleXY(0, 0, 0, size3d, 360, 0, 0, 0, 32);
-
-        // white circle
-        DrawCircleXY(0, 0, size3d, size3d, 360, 1, 1, 1, 32);*/
-
-        // vertical axis black to white
-        glLineWidth(32);
-        glBegin(GL_LINES);
-            glColor3d(0,0,0); // axis origin : black
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glColor3d(1,1,1); // axis end : white
-            glVertex3f(0.0f, 0.0f, size3d);
-        glEnd();
-        DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("L", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
-
-        // values
-        for (int n = 0; n < nb_palettes;n++) // for each color in palette
-            DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                       palettes[n].HSL.S * cos(-palettes[n].HSL.H * 2 * Pi) * size3d,
-                       palettes[n].HSL.S * sin(-palettes[n].HSL.H * 2 * Pi) * size3d,
-                       palettes[n].HSL.L * size3d,
-                       palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B,
-                       palettes[n].selected, palettes[n].visible);
-    }
-
-    if (color_space == "HWB") { // HWB
-        // colored circle
-        int num_segments = 360;
-        double R, G, B;
-        glLineWidth(32); // bigger width of the lines to really see them
-        glBegin(GL_LINE_LOOP);       
-            for (int i = 0; i < num_segments; i++) {
-                double theta = 2.0f * Pi * double(i) / double(num_segments); //current angle
-                HWBtoRGB(double(i) / double(num_segments), 0, 0, R, G, B);
-                glColor3d(R, G, B); // color of segment
-                glVertex3f(size3d * cosl(theta), -size3d * sin(theta), 0.0f); // vertex
-            }
-        glEnd();
-
-        // arc = H
-        DrawCircleArcXY(0, 0, size3d + 300, size3d + 400, 360, 0, 45,  1, 1, 1, 32);
-        DrawConeY(size3d + 400, 0, size3d + 300, -200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("H", size3d + 530, 0, size3d + 300, 20, 1, 1, 1, 4);
-
-        /*// black circle
-        DrawCircleXY(0, 0, size3d, size3d, 360, 0, 0, 0, 32);*/
-
-        // vertical axis white to black
-        glLineWidth(32);
-        glBegin(GL_LINES); // vertical axis
-            glColor3d(0.75,0.75,0.75); // axis origin : white
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glColor3d(0,0,0); // axis end : black
-            glVertex3f(0.0f, 0.0f, size3d);
-        glEnd();
-        DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 0, 0, 0);
-        DrawText("B", -150.0f, 150.0f, size3d + 300, 20, 0.15, 0.15, 0.15, 4);
-
-        // values
-        for (int n = 0; n < nb_palettes;n++) // for each color in palette
-            DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                       (1 - palettes[n].HWB.W) * cos(palettes[n].HWB.H * 2 * Pi) * size3d,
-                       (1 - palettes[n].HWB.W) * sin(palettes[n].HWB.H * 2 * Pi) * size3d,
-                       palettes[n].HWB.B * size3d,
-                       palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B,
-                       palettes[n].selected, palettes[n].visible);
-    }
-
-    if (color_space == "HCV") { // HCV
-        // colored circle
-        int num_segments = 360;
-        double R, G, B;
-        glLineWidth(32); // bigger width of the lines to really see them
-        glBegin(GL_LINE_LOOP); // colored circle   
-            for (int i = 0; i < num_segments; i++) {
-                double angle = double(i) / double(num_segments); //current angle
-                HSVtoRGB(angle, 1, 1, R, G, B);
-                glColor3d(R, G, B); // color of segment
-                glVertex3f(size3d * cosl(-angle * 2.0f * Pi), -size3d * sin(-angle * 2.0f * Pi), size3d); // vertex
-            }
-        glEnd();
-
-        // arc = H
-        DrawCircleArcXY(0, 0, size3d + 300, size3d + 400, 360, 315, 360,  1, 1, 1, 32);
-        DrawConeY(size3d + 400, -30, size3d + 300, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("H", size3d + 530, 0, size3d + 300, 20, 1, 1, 1, 4);
-
-        // vertical axis black to white
-        glLineWidth(32);
-        glBegin(GL_LINES); // vertical axis
-            glColor3d(0,0,0); // axis origin : black
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glColor3d(1,1,1); // axis end : white
-            glVertex3f(0.0f, 0.0f, size3d);
-        glEnd();
-        DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("V", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
-
-        // values
-        for (int n = 0; n < nb_palettes;n++) // for each color in palette
-            DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                       palettes[n].HSV.C * cos(-palettes[n].HSV.H * 2 * Pi) * size3d,
-                       palettes[n].HSV.C * sin(-palettes[n].HSV.H * 2 * Pi) * size3d,
-                       palettes[n].HSV.V * size3d,
-                       palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B,
-                       palettes[n].selected, palettes[n].visible);
-    }
-
-    if (color_space == "HCL") { // HCL
-        // colored circle
-        int num_segments = 360;
-        double R, G, B;
-        glLineWidth(32);
-        glBegin(GL_LINE_LOOP); // colored circle
-            for (int i = 0; i < num_segments; i++) {
-                double theta = 2.0f * Pi * double(i) / double(num_segments); //current angle
-                HSLtoRGB(-double(i) / double(num_segments), 1, 0.5, R, G, B);
-                glColor3d(R, G, B); // color of segment
-                glVertex3f(size3d * cosl(theta), -size3d * sin(theta), 500.0f); // vertex
-            }
-        glEnd();
-
-        // arc = H
-        DrawCircleArcXY(0, 0, size3d + 300, size3d + 400, 360, 315, 360,  1, 1, 1, 32);
-        DrawConeY(size3d + 400, -30, size3d + 300, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("H", size3d + 530, 0, size3d + 300, 20, 1, 1, 1, 4);
-
-        // vertical axis black to white
-        glLineWidth(32);
-        glBegin(GL_LINES); // vertical axis
-            glColor3d(0,0,0); // axis origin : black
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glColor3d(1,1,1); // axis end : white
-            glVertex3f(0.0f, 0.0f, size3d);
-        glEnd();
-        DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("L", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
-        //DrawConeZ(0.0f, 0.0f, 0.0f, -200.0f, 50.0f, 100, 0, 0, 0);
-        //DrawText("-L", -150.0f, 150.0f, 0 - 300, 20, 0.15, 0.15, 0.15, 4);
-
-        // values
-        for (int n = 0; n < nb_palettes;n++) // for each color in palette
-            DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                       palettes[n].HSL.C * cos(-palettes[n].HSL.H * 2 * Pi) * size3d,
-                       palettes[n].HSL.C * sin(-palettes[n].HSL.H * 2 * Pi) * size3d,
-                       palettes[n].HSL.L * size3d,
-                       palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B,
-                       palettes[n].selected, palettes[n].visible);
-    }
+    frameInFlight = true; // next redraws wait until this frame is displayed
 
-    if (color_space == "CIE XYZ") { // CIE XYZ
-        // colored boundaries
-        DrawCMFinXYZ(size3d, false);
-
-        // x axis
-        glLineWidth(32);
-        glBegin(GL_LINES); // draw several lines
-            glColor3d(1,1,1);
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glVertex3f(size3d, 0.0f, 0.0f);
-        glEnd();
-        DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("X", size3d + 300, -50.0f, 0.0f, 20, 1, 1, 1, 4);
-
-        // y axis
-        glLineWidth(32);
-        glBegin(GL_LINES);
-            glVertex3f( 0.0f,     0.0f, 0.0f );
-            glVertex3f( 0.0f, -size3d, 0.0f );
-        glEnd();
-        DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("Y", -50.0f, -size3d - 400, 0.0f, 20, 1, 1, 1, 4);
-
-        // z axis
-        glLineWidth(32);
-        glBegin(GL_LINES);
-            glColor3d(0,0,0);
-            glVertex3f( 0.0f, 0.0f,    0.0f);
-            glColor3d(1,1,1);
-            glVertex3f( 0.0f, 0.0f, size3d);
-        glEnd();
-        DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("Z", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
-
-        // values
-        for (int n = 0; n < nb_palettes;n++) { // for each color in palette
-            DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                       palettes[n].XYZ.X * size3d, palettes[n].XYZ.Y * size3d, palettes[n].XYZ.Z * size3d,
-                       palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B,
-                       palettes[n].selected, palettes[n].visible);
-        }
-    }
+    if (ColorSpaces3D[colorSpace].extended) // these color spaces are computed on demand
+        ConvertPaletteExtended();
 
-    if (color_space == "LMS") { // LMS
-        // x axis
-        glLineWidth(32);
-        glBegin(GL_LINES); // draw several lines
-            glColor3d(1,1,1);
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glVertex3f(size3d, 0.0f, 0.0f);
-        glEnd();
-        DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("L", size3d + 300, -50.0f, 0.0f, 20, 1, 1, 1, 4);
-
-        // y axis
-        glLineWidth(32);
-        glBegin(GL_LINES);
-            glVertex3f( 0.0f,     0.0f, 0.0f );
-            glVertex3f( 0.0f, -size3d, 0.0f );
-        glEnd();
-        DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("M", -50.0f, -size3d - 400, 0.0f, 20, 1, 1, 1, 4);
-
-        // z axis
-        glLineWidth(32);
-        glBegin(GL_LINES);
-            glVertex3f( 0.0f, 0.0f,    0.0f);
-            glVertex3f( 0.0f, 0.0f, size3d);
-        glEnd();
-        DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("S", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
-
-        // colored boundaries
-        DrawCMFinLMS(size3d);
-
-        // values
-        for (int n = 0; n < nb_palettes;n++) { // for each color in palette
-            DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                       palettes[n].LMS.L * size3d, palettes[n].LMS.M * size3d, palettes[n].LMS.S * size3d,
-                       palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B,
-                       palettes[n].selected, palettes[n].visible);
-        }
-    }
+    renderer.Render(View(), palettes, nb_palettes); // same scene as offscreen captures
+}
 
-    if (color_space == "CIE xyY") { // CIE xyY
-        // colored boundaries
-        DrawCMFinXYZ(size3d, true);
-
-        // White point
-        glLineWidth(4);
-        glBegin(GL_LINES); // draw several lines
-            glColor3d(1,1,1);
-            glVertex3f(0,0,0);
-            float sum = 0.9505f + 1.0f + 1.089f;
-            glVertex3f(1.0f / sum * size3d, -0.9505f / sum * size3d, 1.089f / sum * size3d);
-        glEnd();
-
-        // y axis
-        glLineWidth(32);
-        glBegin(GL_LINES); // draw several lines
-            glColor3d(1,1,1);
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glVertex3f(size3d, 0.0f, 0.0f);
-        glEnd();
-        DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("y", size3d + 300, -50.0f, 0.0f, 20, 1, 1, 1, 4);
-
-        // x axis
-        glLineWidth(32);
-        glBegin(GL_LINES);
-            glVertex3f( 0.0f,     0.0f, 0.0f );
-            glVertex3f( 0.0f, -size3d, 0.0f );
-        glEnd();
-        DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("x", -50.0f, -size3d - 400, 0.0f, 20, 1, 1, 1, 4);
-
-        // z axis
-        glLineWidth(32);
-        glBegin(GL_LINES);
-            glVertex3f( 0.0f, 0.0f,    0.0f);
-            glVertex3f( 0.0f, 0.0f, size3d);
-        glEnd();
-        DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("Y", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
-
-        // values
-        for (int n = 0; n < nb_palettes;n++) { // for each color in palette
-            DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                       palettes[n].XYY.y * size3d, palettes[n].XYY.x * size3d, (1 - palettes[n].XYY.x - palettes[n].XYY.y) * size3d,
-                       palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B,
-                       palettes[n].selected, palettes[n].visible);
-        }
-    }
+void openGLWidget::resizeGL(int width, int height) // called when the widget is resized
+{
+    renderer.Resize(width, height, devicePixelRatioF());
+}
 
-    if (color_space == "CIE L*u*v*") { // CIE L*u*v*
-        // x axis
-        glLineWidth(32);
-        glBegin(GL_LINES); // draw several lines
-            glColor3d(1,1,1);
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glVertex3f(size3d, 0.0f, 0.0f);
-        glEnd();
-        DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("v", size3d + 300, -50.0f, 0.0f, 20, 1, 1, 1, 4);
-
-        // y axis
-        glLineWidth(32);
-        glBegin(GL_LINES);
-            glVertex3f( 0.0f,     0.0f, 0.0f );
-            glVertex3f( 0.0f, -size3d, 0.0f );
-        glEnd();
-        DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("u", -50.0f, -size3d - 400, 0.0f, 20, 1, 1, 1, 4);
-
-        // z axis
-        glLineWidth(32);
-        glBegin(GL_LINES);
-            glColor3d(0,0,0);
-            glVertex3f( 0.0f, 0.0f,    0.0f);
-            glColor3d(1,1,1);
-            glVertex3f( 0.0f, 0.0f, size3d);
-        glEnd();
-        DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("L", -150.0f, 150.0f, size3d + 300, 20, 1, 1, 1, 4);
-
-        // color boundaries
-        DrawCMFinLuv(size3d);
-
-        // values
-        for (int n = 0; n < nb_palettes;n++) { // for each color in palette
-            DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                       palettes[n].LUV.v * size3d, palettes[n].LUV.u * size3d, palettes[n].LUV.L * size3d,
-                       palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B,
-                       palettes[n].selected, palettes[n].visible);
-        }
-    }
+struct_view_3d openGLWidget::View() const // camera and options of the current view
+{
+    struct_view_3d view;
+    view.colorSpace = colorSpace;
+    view.xRot = xRot;
+    view.yRot = yRot;
+    view.zRot = zRot;
+    view.xShift = xShift;
+    view.yShift = yShift;
+    view.zoom3D = zoom3D;
+    view.size3d = size3d;
+    view.sphere_size = sphere_size;
+    view.lightEnabled = lightEnabled;
+    view.qualityEnabled = qualityEnabled;
+    view.pointCloudEnabled = pointCloudEnabled;
+    view.interacting = interacting;
+    view.pointScale = 1.0f; // same size as on screen
+
+    return view;
+}
 
-    if ((color_space == "CIE L*a*b*") or (color_space == "OKLAB")) { // LAB
-        // vertical L axis
-        glLineWidth(32);
-        glBegin(GL_LINES); // vertical axis
-            glColor3d(0,0,0); // axis origin : black
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glColor3d(1,1,1); // axis end : white
-            glVertex3f(0.0f, 0.0f, size3d);
-        glEnd();
-        DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("L", -150.0f, 150.0f, size3d + 300, 15, 1, 1, 1, 4);
-
-        // a axis (x) : green (-) to red (+)
-        glLineWidth(32);
-        glBegin(GL_LINES); // draw several lines
-            glColor3d(1,0,0); // red
-            glVertex3f(-size3d, 0.0f, 0.0f);
-            glColor3d(0,1,0); // green
-            glVertex3f(size3d, 0.0f, 0.0f);
-        glEnd();
-        DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 0, 1, 0); // green arrow
-        DrawText("-a", size3d + 250, -100.0f, 0.0f, 15, 0, 1, 0, 4);
-        DrawConeX(-size3d, 0.0f, 0.0f, -200.0f, 50.0f, 100, 1, 0, 0); // red arrow
-        DrawText("+a", -size3d - 400, -100.0f, 0.0f, 15, 1, 0, 0, 4);
-
-        // b axis (y) : blue (-) to yellow (+)
-        glLineWidth(32);
-        glBegin(GL_LINES);
-            glColor3d(0,0,1); // blue
-            glVertex3f( 0.0f, size3d, 0.0f );
-            glColor3d(1,1,0); // yellow
-            glVertex3f( 0.0f, -size3d, 0.0f );
-        glEnd();
-        DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 1, 0); // yellow arrow
-        DrawText("+b", -60.0f, -size3d - 450, 0.0f, 15, 1, 1, 0, 4);
-        DrawConeY(0.0f, size3d, 0.0f, 200.0f, 50.0f, 100, 0, 0, 1); // blue arrow
-        DrawText("-b", -60.0f, size3d + 250, 0.0f, 15, 0, 0, 1, 4);
-
-        // color boundaries
-        if (color_space == "CIE L*a*b*")
-            DrawCMFinLab(size3d);
-        else if (color_space == "OKLAB")
-            DrawCMFinOKLAB(size3d);
-
-        // values
-        if (color_space == "CIE L*a*b*") {
-            for (int n = 0; n < nb_palettes;n++) // for each color in palette
-                DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                           -palettes[n].CIELAB.A * size3d,
-                           palettes[n].CIELAB.B * size3d,
-                           palettes[n].CIELAB.L * size3d,
-                           palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B,
-                           palettes[n].selected, palettes[n].visible);
-        }
-        else if (color_space == "OKLAB") {
-            for (int n = 0; n < nb_palettes;n++) // for each color in palette
-                DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                           -palettes[n].OKLAB.A * size3d,
-                           palettes[n].OKLAB.B * size3d,
-                           palettes[n].OKLAB.L * size3d,
-                           palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B,
-                           palettes[n].selected, palettes[n].visible);
-        }
-    }
+void openGLWidget::ConvertPaletteFromRGB() // convert entire palette values in color spaces from RGB values
+{
+    palettes.ConvertFromRGB(nb_palettes); // all common color spaces in one pass
 
-    if (color_space == "Hunter Lab") { // Hunter LAB
-        // vertical L axis
-        glLineWidth(32);
-        glBegin(GL_LINES); // vertical axis
-            glColor3d(0,0,0); // axis origin : black
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glColor3d(1,1,1); // axis end : white
-            glVertex3f(0.0f, 0.0f, size3d);
-        glEnd();
-        DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
-        DrawText("L", -150.0f, 150.0f, size3d + 300, 15, 1, 1, 1, 4);
-
-        // a axis (x) : green (-) to red (+)
-        glLineWidth(32);
-        glBegin(GL_LINES); // draw several lines
-            glColor3d(1,0,0); // red
-            glVertex3f(-size3d, 0.0f, 0.0f);
-            glColor3d(0,1,0); // green
-            glVertex3f(size3d, 0.0f, 0.0f);
-        glEnd();
-        DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 0, 1, 0); // green arrow
-        DrawText("-a", size3d + 250, -100.0f, 0.0f, 15, 0, 1, 0, 4);
-        DrawConeX(-size3d, 0.0f, 0.0f, -200.0f, 50.0f, 100, 1, 0, 0); // red arrow
-        DrawText("+a", -size3d - 400, -100.0f, 0.0f, 15, 1, 0, 0, 4);
-
-        // b axis (y) : blue (-) to yellow (+)
-        glLineWidth(32);
-        glBegin(GL_LINES);
-            glColor3d(0,0,1); // blue
-            glVertex3f( 0.0f, size3d, 0.0f );
-            glColor3d(1,1,0); // yellow
-            glVertex3f( 0.0f, -size3d, 0.0f );
-        glEnd();
-        DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 1, 0); // yellow arrow
-        DrawText("+b", -60.0f, -size3d - 450, 0.0f, 15, 1, 1, 0, 4);
-        DrawConeY(0.0f, size3d, 0.0f, 200.0f, 50.0f, 100, 0, 0, 1); // blue arrow
-        DrawText("-b", -60.0f, size3d + 250, 0.0f, 15, 0, 0, 1, 4);
-
-        // color boundaries
-        DrawCMFinHLAB(size3d);
-
-        // values
-        for (int n = 0; n < nb_palettes;n++) // for each color in palette
-            DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                       -palettes[n].HLAB.A * size3d,
-                        palettes[n].HLAB.B * size3d,
-                        palettes[n].HLAB.L * size3d,
-                        palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B,
-                        palettes[n].selected, palettes[n].visible);
-    }
+    extendedConverted = false; // Hunter Lab, LMS and LCHuv are not up to date anymore
+    renderer.PaletteChanged(); // spheres must be sent again to the GPU
+}
 
-    if (color_space == "CIE LCHab") { // CIE LCHab
-        // vertical L axis
-        glLineWidth(32);
-        glBegin(GL_LINES); // vertical axis
-            glColor3d(0,0,0); // axis origin : black
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glColor3d(1,1,1); // axis end : white
-            glVertex3f(0.0f, 0.0f, size3d);
-        glEnd();
-        DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
-
-        // a axis (x) : green (-) to red (+)
-        glLineWidth(32);
-        glBegin(GL_LINES); // draw several lines
-            glColor3d(1,0,0); // red
-            glVertex3f(-size3d, 0.0f, 0.0f);
-            glColor3d(0,1,0); // green
-            glVertex3f(size3d, 0.0f, 0.0f);
-        glEnd();
-        DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 0, 1, 0); // green arrow
-        DrawConeX(-size3d, 0.0f, 0.0f, -200.0f, 50.0f, 100, 1, 0, 0); // red arrow
-
-        // b axis (y) : blue (-) to yellow (+)
-        glLineWidth(32);
-        glBegin(GL_LINES);
-            glColor3d(0,0,1); // blue
-            glVertex3f( 0.0f, size3d, 0.0f );
-            glColor3d(1,1,0); // yellow
-            glVertex3f( 0.0f, -size3d, 0.0f );
-        glEnd();
-        DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 1, 0); // yellow arrow
-        DrawConeY(0.0f, size3d, 0.0f, 200.0f, 50.0f, 100, 0, 0, 1); // blue arrow
-
-        // color boundaries
-        DrawCMFinLab(size3d);
-
-        // values
-        for (int n = 0; n < nb_palettes;n++) // for each color in palette
-            DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                       -palettes[n].LCHAB.C / 127.0 * 100.0 * cos(palettes[n].LCHAB.H * 2.0f * Pi) * size3d,
-                       palettes[n].LCHAB.C / 127.0 * 100.0 * sin(palettes[n].LCHAB.H * 2.0f * Pi) * size3d,
-                       palettes[n].LCHAB.L * size3d,
-                       palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B,
-                       palettes[n].selected, palettes[n].visible);
-    }
+void openGLWidget::ConvertPaletteExtended() // compute the less used color spaces (Hunter Lab, LMS, LCHuv) - only once after each ConvertPaletteFromRGB()
+{
+    if (extendedConverted) // already done for this palette
+        return;
 
-    if (color_space == "CIE LCHuv") { // CIE LCHuv
-        // x axis
-        glLineWidth(32);
-        glBegin(GL_LINES); // draw several lines
-            glColor3d(1,1,1);
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glVertex3f(size3d, 0.0f, 0.0f);
-        glEnd();
-        DrawConeX(size3d, 0.0f, 0.0f, 200.0f, 50.0f, 100, 1, 1, 1);
-
-        // y axis
-        glLineWidth(32);
-        glBegin(GL_LINES);
-            glVertex3f( 0.0f,     0.0f, 0.0f );
-            glVertex3f( 0.0f, -size3d, 0.0f );
-        glEnd();
-        DrawConeY(0.0f, -size3d, 0.0f, -200.0f, 50.0f, 100, 1, 1, 1);
-
-        // z axis
-        glLineWidth(32);
-        glBegin(GL_LINES);
-            glColor3d(0,0,0);
-            glVertex3f( 0.0f, 0.0f,    0.0f);
-            glColor3d(1,1,1);
-            glVertex3f( 0.0f, 0.0f, size3d);
-        glEnd();
-        DrawConeZ(0.0f, 0.0f, size3d, 200.0f, 50.0f, 100, 1, 1, 1);
-
-        // color boundaries
-        DrawCMFinLuv(size3d);
-
-        // values
-        for (int n = 0; n < nb_palettes;n++) // for each color in palette
-            DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                       -palettes[n].LCHUV.C * cos(palettes[n].LCHUV.H * 2.0f * Pi + Pi / 2.0f) * size3d,
-                       palettes[n].LCHUV.C * sin(palettes[n].LCHUV.H * 2.0f * Pi + Pi / 2.0f) * size3d,
-                       palettes[n].LCHUV.L * size3d,
-                       palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B,
-                       palettes[n].selected, palettes[n].visible);
-    }
+    palettes.ConvertExtended(nb_palettes);
 
-    if (color_space == "Wheel") { // Color Wheel
-        // external circle
-        float radius = size3d + 150.0f;
-        DrawCircleXY(0, 0, 0, radius, 100, 1, 1, 1, 32);
-
-        // internal circle
-        DrawCircleXY(0, 0, 0, size3d, 100, 0.5, 0.5, 0.5, 4);
-
-        // cross = middle
-        glLineWidth(4);
-        glColor3d(0.5,0.5,0.5); // gray
-        glBegin(GL_LINES); // a white line on each axis
-            glVertex3f( 50.0f, 0.0f, 0.0f);
-            glVertex3f(-50.0f, 0.0f, 0.0f);
-            glVertex3f(0.0f, -50.0f, 0.0f );
-            glVertex3f(0.0f,  50.0f, 0.0f );
-            glVertex3f(0.0f, 0.0f,  50.0f );
-            glVertex3f(0.0f, 0.0f, -50.0f );
-        glEnd();
-
-        // primary, secondary and tertiary colors : a sphere with a white circle
-        // red
-        float angle = 0.0f;
-        DrawSpherePlus(3, 100, radius * cos(angle), -radius * sin(angle), 0, 1, 0, 0, true, true);
-        // blue
-        angle = 120.0f / 360.0f * 2 * Pi;
-        DrawSpherePlus(3, 100, radius * cos(angle), -radius * sin(angle), 0, 0, 0, 1, true, true);
-        // green
-        angle = 240.0f / 360.0f * 2 * Pi;
-        DrawSpherePlus(3, 100, radius * cos(angle), -radius * sin(angle), 0, 0, 1, 0, true, true);
-        // magenta
-        angle = 60.0f / 360.0f * 2 * Pi;
-        DrawSpherePlus(3, 75, radius * cos(angle), -radius * sin(angle), 0, 1, 0, 1, true, true);
-        // cyan
-        angle = 180.0f / 360.0f * 2 * Pi;
-        DrawSpherePlus(3, 75, radius * cos(angle), -radius * sin(angle), 0, 0, 1, 1, true, true);
-        // yellow
-        angle = 300.0f / 360.0f * 2 * Pi;
-        DrawSpherePlus(3, 75, radius * cos(angle), -radius * sin(angle), 0, 1, 1, 0, true, true);
-        // pink
-        angle = 30.0f / 360.0f * 2 * Pi;
-        DrawSpherePlus(3, 50, radius * cos(angle), -radius * sin(angle), 0, 1, 0, 0.5, true, true);
-        // purple
-        angle = 90.0f / 360.0f * 2 * Pi;
-        DrawSpherePlus(3, 50, radius * cos(angle), -radius * sin(angle), 0, 0.5, 0, 1, true, true);
-        // azure
-        angle = 150.0f / 360.0f * 2 * Pi;
-        DrawSpherePlus(3, 50, radius * cos(angle), -radius * sin(angle), 0, 0, 0.5, 1, true, true);
-        // blue-green
-        angle = 210.0f / 360.0f * 2 * Pi;
-        DrawSpherePlus(3, 50, radius * cos(angle), -radius * sin(angle), 0, 0, 1, 0.5, true, true);
-        // chartreuse
-        angle = 270.0f / 360.0f * 2 * Pi;
-        DrawSpherePlus(3, 50, radius * cos(angle), -radius * sin(angle), 0, 0.5, 1, 0, true, true);
-        // orange
-        angle = 330.0f / 360.0f * 2 * Pi;
-        DrawSpherePlus(3, 50, radius * cos(angle), -radius * sin(angle), 0, 1, 0.5, 0, true, true);
-
-        // values
-        for (int n = 0; n < nb_palettes;n++) // for each color in palette
-            DrawSpherePlus(3, palettes[n].percentage * size3d * nb_palettes / 500.0f * sphere_size,
-                       palettes[n].HSL.L * cos(palettes[n].HSL.H * 2 * Pi) * size3d,
-                       palettes[n].HSL.L * sin(palettes[n].HSL.H * 2 * Pi) * size3d,
-                       0,
-                       palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B,
-                       palettes[n].selected, palettes[n].visible);
-    }
+    extendedConverted = true;
 }
 
-void openGLWidget::resizeGL(int width, int height) // called when the widget is resized
+void openGLWidget::SetColorSpace(const ColorSpace3D &space) // color space to plot
 {
-    double ratio = double(width) / height; // ratio of the widget : width / height
-    glViewport(0, 0, width, height); // resize openGL viewport
-
-    glMatrixMode(GL_PROJECTION); // openGL projection mode
-    glLoadIdentity();
-#ifdef QT_OPENGL_ES_1 // older versions of openGL
-    glOrthof(-4 * 2048, +4 * 2048, -4 * 2048 / ratio, +4 * 2048  / ratio, -5000*2048, 5000*2048); // define view rectangle and clipping
-#else
-    glOrtho(-4 * 2048, +4 * 2048, -4 * 2048 / ratio, +4 * 2048 / ratio, -5000*2048, 5000*2048);
-#endif
-    glMatrixMode(GL_MODELVIEW); // now openGL model mode
+    colorSpace = space;
+    color_space = ColorSpaces3D[space].name; // name used in file names
 }
 
-void openGLWidget::ConvertPaletteFromRGB() // convert entire palette values in color spaces from RGB values
+void openGLWidget::SetPointCloudImage(const cv::Mat &image) // all distinct colors of this BGR image are shown as points
 {
-    for (int n = 0; n < nb_palettes; n++) {
-        // hexadecimal
-        QString hex = QString(" %1").arg(((int(round(palettes[n].RGB.R * 255.0)) & 0xff) << 16)
-                                       + ((int(round(palettes[n].RGB.G * 255.0)) & 0xff) << 8)
-                                       +  (int(round(palettes[n].RGB.B * 255.0)) & 0xff)
-                                         , 6, 16, QChar('0')).trimmed(); // compute hexa RGB value
-        hex = "#" + hex;
-        palettes[n].hexa = hex.toUpper().toUtf8().constData();
-
-        // HSV
-        double H, S, V, C; // HSLVC values
-        RGBtoHSV(palettes[n].RGB.R,
-                 palettes[n].RGB.G,
-                 palettes[n].RGB.B,
-                 H, S, V, C); // convert RGB to HSV values
-        palettes[n].HSV.H = H;
-        palettes[n].HSV.C = C;
-        palettes[n].HSV.S = S;
-        palettes[n].HSV.V = V;
-
-        // HWB
-        double h, W, B; // HWB values
-        HSVtoHWB(H, S, V, h, W, B);
-        palettes[n].HWB.H = h;
-        palettes[n].HWB.W = W;
-        palettes[n].HWB.B = B;
-
-        // HSL
-        double L;
-        RGBtoHSL(palettes[n].RGB.R,
-                 palettes[n].RGB.G,
-                 palettes[n].RGB.B,
-                 H, S, L, C); // convert RGB to HSV values
-        palettes[n].HSL.H = H;
-        palettes[n].HSL.C = C;
-        palettes[n].HSL.S = S;
-        palettes[n].HSL.L = L;
-
-        // XYZ
-        double X, Y, Z; // XYZ values
-        RGBtoXYZ(palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B, X, Y, Z); // convert RGB to XYZ values
-        palettes[n].XYZ.X = X;
-        palettes[n].XYZ.Y = Y;
-        palettes[n].XYZ.Z = Z;
-
-        // xyY
-        double x, y;
-        XYZtoxyY(X, Y, Z, x, y);
-        palettes[n].XYY.x = x;
-        palettes[n].XYY.y = y;
-        palettes[n].XYY.Y = Y;
-
-        // L*u*v*
-        double u, v;
-        XYZtoCIELuv(X, Y, Z, L, u, v);
-        palettes[n].LUV.L = L;
-        palettes[n].LUV.u = u;
-        palettes[n].LUV.v = v;
-
-        // LCHuv
-        CIELuvToCIELCHuv(u, v, C, H); // convert LUV to LCHuv values
-        palettes[n].LCHUV.L = L;
-        palettes[n].LCHUV.C = C;
-        palettes[n].LCHUV.H = H;
-
-        // L*A*B*
-        double A;
-        XYZtoCIELab(X, Y, Z, L, A, B); // convert XYZ to LAB values
-        palettes[n].CIELAB.L = L;
-        palettes[n].CIELAB.A = A;
-        palettes[n].CIELAB.B = B;
-
-        // LCHab
-        CIELabToCIELCHab(A, B, C, H); // convert LAB to LCHab values
-        palettes[n].LCHAB.L = L;
-        palettes[n].LCHAB.C = C;
-        palettes[n].LCHAB.H = H;
-
-        // Hunter LAB
-        XYZtoHLAB(X, Y, Z, L, A, B); // convert XYZ to Hunter LAB values
-        palettes[n].HLAB.L = L;
-        palettes[n].HLAB.A = A;
-        palettes[n].HLAB.B = B;
-
-        // OKLAB and OKLCH
-        RGBtoOKLAB(palettes[n].RGB.R, palettes[n].RGB.G, palettes[n].RGB.B, L, A, B); // convert RGB to OKLAB values
-        palettes[n].OKLAB.L = L;
-        palettes[n].OKLAB.A = A;
-        palettes[n].OKLAB.B = B;
-        OKLABtoOKLCH(A, B, C, H); // convert OKLAB to OKLCH
-        palettes[n].OKLCH.L = L;
-        palettes[n].OKLCH.C = C;
-        palettes[n].OKLCH.H = H;
-
-        // LMS
-        double M;
-        XYZtoLMS(X, Y, Z, L, M, S); // convert XYZ to LMS values
-        palettes[n].LMS.L = L;
-        palettes[n].LMS.M = M;
-        palettes[n].LMS.S = S;
-
-        // CMYK
-        double K;
-        RGBtoCMYK(palettes[n].RGB.R,
-                  palettes[n].RGB.G,
-                  palettes[n].RGB.B,
-                  C, M, Y, K); // convert RGB to CMYK values
-        palettes[n].CMYK.C = C;
-        palettes[n].CMYK.M = M;
-        palettes[n].CMYK.Y = Y;
-        palettes[n].CMYK.K = K;
-    }
+    renderer.SetPointCloudImage(image);
+
+    pointCloudImage = image; // the offscreen renderer gets it at next capture
+    offscreenImageChanged = true;
 }
 
-void openGLWidget::DrawSpherePlus(const int &ndiv, const float &radius, const float &x, const float y, const float z, const float r, const float g, const float b, const bool circle, const bool visible) // draw a sphere with a white circle if color chosen
+void openGLWidget::PaletteChanged() // palette values or visibility changed : spheres are rebuilt at next paint
 {
-    if (!visible)
-        return;
-
-    DrawSphere(ndiv, radius, x, y, z, r, g, b); // first draw the sphere
-    if (circle) // draw white circle around the sphere ?
-        DrawCircleXY(x, -y, z, radius + 4.0f, 100, 1, 1, 1, 4); // draw the white circle around the sphere
+    renderer.PaletteChanged();
 }
 
 ///////////////////////////////////////////////
@@ -1152,7 +196,7 @@ void openGLWidget::DrawSpherePlus(const int &ndiv, const float &radius, const fl
 void openGLWidget::SetSphereSize(int size) // sphere size factor
 {
     sphere_size = size;
-    update();
+    Redraw();
 }
 
 static void NormalizeAngle(int &angle) // angle must be between 0 and 359°
@@ -1166,7 +210,7 @@ void openGLWidget::SetXRotation(int angle) // set X rotation and emit a signal
     NormalizeAngle(angle); // angle must be between 0 and 359°
     xRot = angle;
     emit xRotationChanged(angle); // emit signal
-    update(); // update 3D rendering
+    Redraw(); // update 3D rendering
 }
 
 void openGLWidget::SetYRotation(int angle) // set Y rotation and emit a signal
@@ -1174,7 +218,7 @@ void openGLWidget::SetYRotation(int angle) // set Y rotation and emit a signal
     NormalizeAngle(angle); // angle must be between 0 and 359°
     yRot = angle;
     emit yRotationChanged(angle); // emit signal
-    update(); // update 3D rendering
+    Redraw(); // update 3D rendering
 }
 
 void openGLWidget::SetZRotation(int angle) // set Z rotation and emit a signal
@@ -1182,7 +226,7 @@ void openGLWidget::SetZRotation(int angle) // set Z rotation and emit a signal
     NormalizeAngle(angle); // angle must be between 0 and 359°
     zRot = angle;
     emit zRotationChanged(angle); // emit signal
-    update(); // update 3D rendering
+    Redraw(); // update 3D rendering
 }
 
 void openGLWidget::SetAngleXMinus() // for keyboard control of x and y angles
@@ -1219,14 +263,14 @@ void openGLWidget::SetXShift(int value) // move view (x)
 {
     xShift = value;
     emit xShiftChanged(xShift); // emit signal
-    update(); // update 3D rendering
+    Redraw(); // update 3D rendering
 }
 
 void openGLWidget::SetYShift(int value) // move view (y)
 {
     yShift = value;
     emit yShiftChanged(yShift); // emit signal
-    update(); // update 3D rendering
+    Redraw(); // update 3D rendering
 }
 
 void openGLWidget::SetShiftUp() // for keyboard control of x and y positions
@@ -1261,6 +305,9 @@ void openGLWidget::mouseMoveEvent(QMouseEvent *event) // move and rotate view wi
 
     bool key_control = QGuiApplication::queryKeyboardModifiers().testFlag(Qt::ControlModifier); // modifier keys pressed ? (shift control etc)
 
+    if (event->buttons() & (Qt::LeftButton | Qt::RightButton))
+        Interacting(); // lower quality until the view stops moving
+
     if ((event->buttons() & Qt::LeftButton) & (key_control)) { // left button = rotate on x and y axes
         SetZRotation(zRot + dx); // z = azimuth
     } else if (event->buttons() & Qt::LeftButton) { // left button = rotate on x and y axes
@@ -1271,18 +318,27 @@ void openGLWidget::mouseMoveEvent(QMouseEvent *event) // move and rotate view wi
         //setZRotation(zRot + 8 * dx);
         SetXShift(xShift + dx * 48);
         SetYShift(yShift - dy * 48);
-
-        update(); // redraw 3d scene
     }
 
     lastPos = event->pos(); // save mouse position again
 }
 
+void openGLWidget::mouseReleaseEvent(QMouseEvent *event) // end of move or rotate : full quality again
+{
+    Q_UNUSED(event);
+
+    if (interacting) {
+        idleTimer.stop(); // no need to wait
+        InteractionFinished();
+    }
+}
+
 void openGLWidget::wheelEvent(QWheelEvent *event) // zoom
 {
     bool key_control = QGuiApplication::queryKeyboardModifiers().testFlag(Qt::ControlModifier); // modifier keys pressed ? (shift control etc)
 
     int n = event->angleDelta().y(); // amount of wheel turn
+    Interacting(); // lower quality until the wheel stops
     //zoom3D += n / 120 / 2; // should work with this (standard) value
 
     if (key_control) {
@@ -1307,7 +363,43 @@ void openGLWidget::wheelEvent(QWheelEvent *event) // zoom
         emit zoomChanged(zoom3D); // emit signal
     }
 
-    update(); // redraw 3d scene
+    Redraw(); // redraw 3d scene
+}
+
+///////////////////////////////////////////////
+//// Render on demand
+////    one redraw per displayed frame,
+////    lower quality while the view moves
+///////////////////////////////////////////////
+
+void openGLWidget::Redraw() // ask for a redraw - all requests until the next frame is displayed are merged
+{
+    if (frameInFlight) { // the last frame waits for vsync : redraw once after it
+        redrawPending = true;
+        return;
+    }
+    update(); // Qt merges update() calls until paintGL
+}
+
+void openGLWidget::FrameSwapped() // last frame is displayed : a pending redraw can be done
+{
+    frameInFlight = false;
+    if (redrawPending) {
+        redrawPending = false;
+        update();
+    }
+}
+
+void openGLWidget::Interacting() // input is moving the view : lower quality until the idle timer ends
+{
+    interacting = true;
+    idleTimer.start(); // restarted at each input
+}
+
+void openGLWidget::InteractionFinished() // no mouse move or wheel for a while : full quality again
+{
+    interacting = false;
+    Redraw(); // one frame with all details
 }
 
 ///////////////////////////////////////////////
@@ -1316,5 +408,59 @@ void openGLWidget::wheelEvent(QWheelEvent *event) // zoom
 
 void openGLWidget::Capture() // take a snapshot of rendered 3D scene
 {
-    capture3D = grabFramebuffer(); // slow because it relies on glReadPixels() to read back the pixels
+    interacting = false; // captures are always full quality
+    idleTimer.stop();
+
+    const qreal ratio = devicePixelRatioF(); // same pixels as on screen
+    if (CaptureView(View(), width() * ratio, height() * ratio, 4, capture3D))
+        return;
+
+    capture3D = grabFramebuffer(); // no offscreen rendering : slow because it relies on glReadPixels() to read back the pixels
+    frameInFlight = false; // the grabbed frame is never swapped
+}
+
+bool openGLWidget::CaptureView(const struct_view_3d &view, const int &width, const int &height, const int &samples, QImage &image) // render a view offscreen
+{
+    std::vector<QImage> images;
+    if (!CaptureViews(std::vector<struct_view_3d>(1, view), width, height, samples, images))
+        return false;
+
+    image = images[0];
+    return true;
+}
+
+bool openGLWidget::CaptureViews(const std::vector<struct_view_3d> &views, const int &width, const int &height, const int &samples, std::vector<QImage> &images) // render several views of the palette offscreen
+{
+    for (const struct_view_3d &view : views)
+        if (ColorSpaces3D[view.colorSpace].extended) { // palette values are shared with the offscreen renderer
+            ConvertPaletteExtended();
+            break;
+        }
+
+    if (offscreenImageChanged) { // image colors computed only when a capture needs them
+        offscreen.SetPointCloudImage(pointCloudImage);
+        offscreenImageChanged = false;
+    }
+
+    return offscreen.CaptureBatch(views, palettes, nb_palettes, width, height, samples, images);
+}
+
+bool openGLWidget::CaptureColorSpaces(const std::vector<ColorSpace3D> &spaces, const int &width, const int &height, const int &samples, std::vector<QImage> &images) // render the palette in several color spaces offscreen
+{
+    std::vector<struct_view_3d> views;
+    for (const ColorSpace3D &space : spaces) {
+        struct_view_3d view = View(); // current options...
+        view.colorSpace = space; // ... default camera of each color space
+        view.xRot = ColorSpaces3D[space].rotation_x;
+        view.yRot = ColorSpaces3D[space].rotation_y;
+        view.zRot = ColorSpaces3D[space].rotation_z;
+        view.xShift = 0;
+        view.yShift = 0;
+        view.zoom3D = ColorSpaces3D[space].zoom;
+        view.interacting = false;
+        view.pointScale = float(width) / (this->width() * devicePixelRatioF()); // points keep the same size relative to the scene
+        views.push_back(view);
+    }
+
+    return CaptureViews(views, width, height, samples, images);
 }
@@ -13,6 +13,11 @@
 #         . rotate view on z axis with CTRL + left mouse button
 #         . move view on x/y axes with right mouse button
 #         . sphere size with CTRL + wheel
+#     - Render on demand :
+#         . one redraw per displayed frame
+#         . lower quality while the view moves
+#
+# * Offscreen captures at any resolution, in batch
 #
 # * QT signals sent when zoomed, moved, rotated, sphere size
 #
@@ -28,10 +33,14 @@
 #include <QOpenGLWidget>
 #include <QOpenGLBuffer>
 #include <QOpenGLTexture>
+#include <QTimer>
 
 #include "opencv2/opencv.hpp"
 
 #include "palette.h"
+#include "opengl-color-spaces.h"
+#include "opengl-renderer.h"
+#include "opengl-offscreen.h"
 
 class openGLWidget : public QOpenGLWidget
 {
@@ -41,7 +50,7 @@ public:
     explicit openGLWidget(QWidget *parent = 0);
     ~openGLWidget();
 
-    struct_palette palettes[5000]; // 5000 is very large !
+    PaletteStore palettes; // palette values by color space columns - can be larger than nb_palettes
     int nb_palettes; // number of colors in palette
 
     int sphere_size; // size factor for spheres
@@ -54,17 +63,26 @@ public:
     bool axesEnabled; // draw 3D origin axes
     bool lightEnabled; // light
     bool qualityEnabled; // antialiasing
+    bool pointCloudEnabled; // draw all colors of the image as points
 
     QImage capture3D; // image of captured 3D scene
 
-    std::string color_space; // color space to plot
+    ColorSpace3D colorSpace; // color space to plot - index of its render module
+    std::string color_space; // name of the color space to plot, set by SetColorSpace
+    bool extendedConverted; // Hunter Lab, LMS and LCHuv values are up to date
 
     float size3d;
 
-    void Capture(); // take a snapshot of rendered 3D scene
-    void ConvertPaletteFromRGB(); // from a RGB value, convert all palette to all color spaces
+    void Capture(); // take a snapshot of rendered 3D scene, same size as on screen
+    bool CaptureView(const struct_view_3d &view, const int &width, const int &height, const int &samples, QImage &image); // render a view offscreen at width x height with samples per pixel - false if offscreen rendering is not available
+    bool CaptureViews(const std::vector<struct_view_3d> &views, const int &width, const int &height, const int &samples, std::vector<QImage> &images); // render several views of the palette offscreen, in one batch
+    bool CaptureColorSpaces(const std::vector<ColorSpace3D> &spaces, const int &width, const int &height, const int &samples, std::vector<QImage> &images); // render the palette in several color spaces with their default camera, in one batch
+    void ConvertPaletteFromRGB(); // from a RGB value, convert all palette to all common color spaces
+    void ConvertPaletteExtended(); // compute the less used color spaces (Hunter Lab, LMS, LCHuv) only when a view or export needs them
     void ConvertPaletteFromLAB(); // from a CIE L*a*b* value, convert all palette to all color spaces
-    void DrawSpherePlus(const int &ndiv, const float &radius, const float &x, float y, float z, float r, float g, float b, const bool circle, const bool visible); // draw a sphere with a white circle if colorChosen equal (r,g,b)
+    void SetColorSpace(const ColorSpace3D &space); // color space to plot
+    void SetPointCloudImage(const cv::Mat &image); // all distinct colors of this BGR image are shown as points
+    void PaletteChanged(); // palette values or visibility changed : spheres are rebuilt at next paint
 
 
 protected:
@@ -74,6 +92,7 @@ protected:
     void resizeGL(int width, int height); // called when the widget is resized
     void mousePressEvent(QMouseEvent *event); // save initial mouse position for move and rotate
     void mouseMoveEvent(QMouseEvent *event); // move and rotate view with mouse buttons
+    void mouseReleaseEvent(QMouseEvent *event); // end of move or rotate : full quality again
     void wheelEvent(QWheelEvent *event); // zoom
 
 
@@ -112,9 +131,29 @@ signals:
     void sphereSizeChanged(int size); // zoom signal
 
 
+private slots:
+
+    void FrameSwapped(); // last frame is displayed : a pending redraw can be done
+    void InteractionFinished(); // no mouse move or wheel for a while : full quality again
+
+
 private:
 
     QPoint lastPos; // save mouse position
+    bool interacting; // the view is being moved, rotated or zoomed : lower quality
+    QTimer idleTimer; // ends the interaction after a short time without input
+    bool frameInFlight; // a frame was rendered and is not displayed yet
+    bool redrawPending; // a redraw was asked while a frame was in flight
+
+    void Redraw(); // ask for a redraw - all requests until the next frame is displayed are merged
+    void Interacting(); // input is moving the view : lower quality until the idle timer ends
+
+    Renderer3D renderer; // draws the scene in the widget context
+    OffscreenRenderer3D offscreen; // draws the same scene for captures, created at first capture
+    cv::Mat pointCloudImage; // image shown as points, for the offscreen renderer
+    bool offscreenImageChanged; // the offscreen renderer doesn't have the last image yet
+
+    struct_view_3d View() const; // camera and options of the current view
 };
 
 #endif // OPENGLWIDGET_H
@@ -12,6 +12,15 @@
 #define PALETTE_H
 
 #include <string>
+#include <vector>
+#include <unordered_map>
+#include <numeric>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+#include "lib/color-spaces.h"
 
 //// palette
 
@@ -94,28 +103,224 @@ struct struct_oklch {
     double H; // range [0..1] - Hue - display [0..360]
 };
 
-struct struct_palette { // structure of a color value
-    struct_rgb RGB; // all known color spaces
-    struct_hsl HSL;
-    struct_hsv HSV;
-    struct_hwb HWB;
-    struct_xyz XYZ;
-    struct_xyy XYY;
-    struct_lab CIELAB;
-    struct_hlab HLAB;
-    struct_lchab LCHAB;
-    struct_lchuv LCHUV;
-    struct_oklab OKLAB;
-    struct_oklch OKLCH;
-    struct_lms LMS;
-    struct_luv LUV;
-    struct_cmyk CMYK;
-    std::string hexa;
-    int count; // occurences
-    double percentage; // percentage
-    std::string name; // name of color
-    bool selected; // selection indicator
-    bool visible; // visibility indicator
+class PaletteStore { // palette values stored by columns (one per color space), dynamically sized
+public:
+    std::vector<struct_rgb> RGB; // all known color spaces
+    std::vector<struct_hsl> HSL;
+    std::vector<struct_hsv> HSV;
+    std::vector<struct_hwb> HWB;
+    std::vector<struct_xyz> XYZ;
+    std::vector<struct_xyy> XYY;
+    std::vector<struct_lab> CIELAB;
+    std::vector<struct_hlab> HLAB;
+    std::vector<struct_lchab> LCHAB;
+    std::vector<struct_lchuv> LCHUV;
+    std::vector<struct_oklab> OKLAB;
+    std::vector<struct_oklch> OKLCH;
+    std::vector<struct_lms> LMS;
+    std::vector<struct_luv> LUV;
+    std::vector<struct_cmyk> CMYK;
+    std::vector<int> RGB24; // packed 8-bit RGB value 0xRRGGBB - hexa string is computed from it
+    std::vector<int> count; // occurences
+    std::vector<double> percentage; // percentage
+    std::vector<int> name; // name of color : index in names pool, -1 = no name
+    std::vector<unsigned char> selected; // selection indicator - not vector<bool> so columns can be written in parallel
+    std::vector<unsigned char> visible; // visibility indicator
+
+    int Size() const { return int(RGB.size()); } // number of allocated values
+
+    void Resize(const int &size) // allocate all columns - existing values are kept
+    {
+        RGB.resize(size); HSL.resize(size); HSV.resize(size); HWB.resize(size); XYZ.resize(size);
+        XYY.resize(size); CIELAB.resize(size); HLAB.resize(size); LCHAB.resize(size); LCHUV.resize(size);
+        OKLAB.resize(size); OKLCH.resize(size); LMS.resize(size); LUV.resize(size); CMYK.resize(size);
+        RGB24.resize(size, 0); count.resize(size, 0); percentage.resize(size, 0.0);
+        name.resize(size, -1); selected.resize(size, false); visible.resize(size, true);
+    }
+
+    void ConvertFromRGB(const int &nb) // convert the nb first values from RGB to all common color spaces
+    {
+        // single pass : linear RGB and XYZ are computed once per color and shared by all the color spaces that need them
+        // Hunter Lab, LMS and LCHuv are only computed on demand by ConvertExtended()
+        #pragma omp parallel for
+        for (int n = 0; n < nb; n++) {
+            const double R = RGB[n].R;
+            const double G = RGB[n].G;
+            const double B = RGB[n].B;
+
+            // packed 8-bit RGB - hexa string is computed from it with the byte to hexa LUT
+            RGB24[n] = (int(round(R * 255.0)) << 16) + (int(round(G * 255.0)) << 8) + int(round(B * 255.0));
+
+            // HSV
+            double H, S, V, C; // HSLVC values
+            RGBtoHSV(R, G, B, H, S, V, C); // convert RGB to HSV values
+            HSV[n].H = H;
+            HSV[n].C = C;
+            HSV[n].S = S;
+            HSV[n].V = V;
+
+            // HWB
+            HSVtoHWB(H, S, V, HWB[n].H, HWB[n].W, HWB[n].B); // from HSV, no need to go back to RGB
+
+            // HSL
+            double L;
+            RGBtoHSL(R, G, B, H, S, L, C); // convert RGB to HSL values
+            HSL[n].H = H;
+            HSL[n].C = C;
+            HSL[n].S = S;
+            HSL[n].L = L;
+
+            // linear RGB - shared by XYZ and OKLAB
+            double Rl, Gl, Bl;
+            RGBtoLinear(R, G, B, Rl, Gl, Bl); // gamma correction only once
+
+            // XYZ - shared by xyY, L*u*v* and L*a*b*
+            double X, Y, Z; // XYZ values
+            LinearRGBtoXYZ(Rl, Gl, Bl, X, Y, Z); // convert linear RGB to XYZ values
+            XYZ[n].X = X;
+            XYZ[n].Y = Y;
+            XYZ[n].Z = Z;
+
+            // xyY
+            XYZtoxyY(X, Y, Z, XYY[n].x, XYY[n].y);
+            XYY[n].Y = Y;
+
+            // L*u*v*
+            XYZtoCIELuv(X, Y, Z, LUV[n].L, LUV[n].u, LUV[n].v);
+
+            // L*A*B*
+            double A, b;
+            XYZtoCIELab(X, Y, Z, L, A, b); // convert XYZ to LAB values
+            CIELAB[n].L = L;
+            CIELAB[n].A = A;
+            CIELAB[n].B = b;
+
+            // LCHab
+            CIELabToCIELCHab(A, b, C, H); // convert LAB to LCHab values
+            LCHAB[n].L = L;
+            LCHAB[n].C = C;
+            LCHAB[n].H = H;
+
+            // OKLAB and OKLCH
+            LinearRGBtoOKLAB(Rl, Gl, Bl, L, A, b); // convert linear RGB to OKLAB values
+            OKLAB[n].L = L;
+            OKLAB[n].A = A;
+            OKLAB[n].B = b;
+            OKLABtoOKLCH(A, b, C, H); // convert OKLAB to OKLCH
+            OKLCH[n].L = L;
+            OKLCH[n].C = C;
+            OKLCH[n].H = H;
+
+            // CMYK
+            RGBtoCMYK(R, G, B, CMYK[n].C, CMYK[n].M, CMYK[n].Y, CMYK[n].K); // convert RGB to CMYK values
+        }
+    }
+
+    void ConvertExtended(const int &nb) // compute the less used color spaces (Hunter Lab, LMS, LCHuv) of the nb first values - needs ConvertFromRGB first
+    {
+        #pragma omp parallel for
+        for (int n = 0; n < nb; n++) {
+            // LCHuv - from L*u*v*
+            LCHUV[n].L = LUV[n].L;
+            CIELuvToCIELCHuv(LUV[n].u, LUV[n].v, LCHUV[n].C, LCHUV[n].H); // convert LUV to LCHuv values
+
+            // Hunter LAB - from XYZ
+            XYZtoHLAB(XYZ[n].X, XYZ[n].Y, XYZ[n].Z,
+                      HLAB[n].L, HLAB[n].A, HLAB[n].B); // convert XYZ to Hunter LAB values
+
+            // LMS - from XYZ
+            XYZtoLMS(XYZ[n].X, XYZ[n].Y, XYZ[n].Z,
+                     LMS[n].L, LMS[n].M, LMS[n].S); // convert XYZ to LMS values
+        }
+    }
+
+    std::string Hexa(const int &n) const // "#RRGGBB" string of a value
+    {
+        return RGBtoHexa(RGB24[n] >> 16, RGB24[n] >> 8, RGB24[n]);
+    }
+
+    std::string Name(const int &n) const // name of a value, empty if not named
+    {
+        if (name[n] < 0)
+            return std::string();
+        return names[name[n]];
+    }
+
+    void SetName(const int &n, const std::string &value) // store name in pool only once
+    {
+        auto found = names_index.find(value);
+        if (found == names_index.end()) { // new name
+            found = names_index.emplace(value, int(names.size())).first;
+            names.push_back(value);
+        }
+        name[n] = found->second;
+    }
+
+    template<typename Compare>
+    void Sort(const int &nb, Compare compare) // sort the nb first values - compare(a, b) gets indexes, only the permutation is sorted
+    {
+        std::vector<int> order(nb);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), compare);
+        Permute(order);
+    }
+
+    static uint64_t SortKey(const double &value, const bool &descending=false) // order-preserving unsigned key from a double value
+    {
+        uint64_t key;
+        std::memcpy(&key, &value, sizeof(key)); // IEEE 754 bits
+        if (key & 0x8000000000000000ULL) // negative : reverse all bits
+            key = ~key;
+        else // positive : set sign bit so it comes after negatives
+            key |= 0x8000000000000000ULL;
+        return descending ? ~key : key;
+    }
+
+    void SortByKeys(const std::vector<uint64_t> &keys) // stable sort of the keys.size() first values by increasing key - LSD radix sort, 8 bits per pass
+    {
+        const int nb = keys.size();
+        std::vector<int> order(nb), temp(nb);
+        std::iota(order.begin(), order.end(), 0);
+        for (int shift = 0; shift < 64; shift += 8) {
+            int histogram[257] = {0};
+            for (int n = 0; n < nb; n++) // count occurences of current byte
+                histogram[((keys[n] >> shift) & 0xff) + 1]++;
+            bool constant = false; // all keys have the same byte : nothing to do for this pass
+            for (int b = 1; b < 257; b++)
+                if (histogram[b] == nb)
+                    constant = true;
+            if (constant)
+                continue;
+            for (int b = 1; b < 257; b++) // offsets
+                histogram[b] += histogram[b - 1];
+            for (int n = 0; n < nb; n++) // scatter, keeping previous order for equal bytes
+                temp[histogram[(keys[order[n]] >> shift) & 0xff]++] = order[n];
+            order.swap(temp);
+        }
+        Permute(order);
+    }
+
+    void Permute(const std::vector<int> &order) // reorder the first order.size() values : new value n is old value order[n]
+    {
+        Gather(RGB, order); Gather(HSL, order); Gather(HSV, order); Gather(HWB, order); Gather(XYZ, order);
+        Gather(XYY, order); Gather(CIELAB, order); Gather(HLAB, order); Gather(LCHAB, order); Gather(LCHUV, order);
+        Gather(OKLAB, order); Gather(OKLCH, order); Gather(LMS, order); Gather(LUV, order); Gather(CMYK, order);
+        Gather(RGB24, order); Gather(count, order); Gather(percentage, order);
+        Gather(name, order); Gather(selected, order); Gather(visible, order);
+    }
+
+private:
+    std::vector<std::string> names; // string pool for color names
+    std::unordered_map<std::string, int> names_index; // name -> index in pool
+
+    template<typename T>
+    static void Gather(std::vector<T> &column, const std::vector<int> &order) // reorder one column
+    {
+        std::vector<T> temp(order.size());
+        for (size_t n = 0; n < order.size(); n++)
+            temp[n] = column[order[n]];
+        std::copy(temp.begin(), temp.end(), column.begin());
+    }
 };
 
 #endif // PALETTE_H
@@ -0,0 +1,37 @@
+#-------------------------------------------------
+#
+#       Cube LUT parser : benchmark and check
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   usage : qmake && make && ./cube-parser
+#
+#-------------------------------------------------
+
+QT += core
+QT -= gui widgets
+
+TARGET = cube-parser
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+SOURCES +=  main.cpp \
+            ../../lib/image-lut.cpp
+
+HEADERS  += ../../lib/image-lut.h
+
+# we add the package opencv to pkg-config
+CONFIG += link_pkgconfig
+PKGCONFIG += opencv4
+
+CONFIG += c++17
+
+# openMP
+QMAKE_LFLAGS += -fopenmp
+QMAKE_CXXFLAGS += -fopenmp
+
+# same optimizations as the application, for comparable timings
+QMAKE_CXXFLAGS += -ffast-math -march=native
@@ -0,0 +1,371 @@
+/*#-------------------------------------------------
+#
+#       Cube LUT parser : benchmark and check
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   - 65^3 and 129^3 cubes are generated in the
+#     temp folder, then loaded by LoadCubeFile and
+#     by the line by line parser of v1.0 (reference)
+#   - load times of both parsers
+#   - same flat tables, title and domain
+#   - same error states on small broken files, except
+#     truncated tables : PrematureEndOfFile instead of
+#     CouldNotParseTableData in v1.0
+#   - exit code 0 = success
+#
+#-------------------------------------------------*/
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+
+#include "../../lib/image-lut.h"
+
+///////////////////////////////////////////////
+//// Reference : line by line parser of v1.0
+///////////////////////////////////////////////
+
+// copied from image-lut v1.0, with the same states - only changes :
+//   - no qDebug messages
+//   - no data parsing after a header error : the backward seek to the start of the data looped forever when the error is on the first line
+
+class ReferenceCubeLUT
+{
+public:
+    using tableRow = std::vector<double>;
+    using table1D = std::vector<tableRow>;
+    using table2D = std::vector<table1D>;
+    using table3D = std::vector<table2D>;
+
+    CubeLUT::LUTState status;
+    std::string title;
+    tableRow domainMin;
+    tableRow domainMax;
+    table1D LUT1D;
+    table3D LUT3D;
+
+    CubeLUT::LUTState LoadCubeFile(std::ifstream& infile);
+
+private:
+    std::string ReadLine(std::ifstream& infile, char lineSeparator);
+    tableRow ParseTableRow(const std::string& lineOfText);
+};
+
+std::string ReferenceCubeLUT::ReadLine(std::ifstream& infile, const char lineSeparator)
+{
+    const char CommentMarker = '#';
+    std::string textLine;
+    while ((textLine.empty()) or (textLine[0] == CommentMarker)) {
+        if (infile.eof()) {
+            status = CubeLUT::PrematureEndOfFile;
+            break;
+        }
+        getline(infile, textLine, lineSeparator);
+        if (infile.fail()) {
+            status = CubeLUT::ReadError;
+            break;
+        }
+    }
+    return textLine;
+}
+
+ReferenceCubeLUT::tableRow ReferenceCubeLUT::ParseTableRow(const std::string& lineOfText)
+{
+    int N = 3;
+    tableRow f(N);
+    std::istringstream line(lineOfText);
+    for (int i = 0; i < N; ++i) {
+        line >> f[i];
+        if (line.fail()) {
+            status = CubeLUT::CouldNotParseTableData;
+            break;
+        }
+    }
+    return f;
+}
+
+CubeLUT::LUTState ReferenceCubeLUT::LoadCubeFile(std::ifstream& infile)
+{
+    status = CubeLUT::OK;
+    title.clear();
+    domainMin = tableRow(3, 0.0);
+    domainMax = tableRow(3, 1.0);
+    LUT1D.clear();
+    LUT3D.clear();
+
+    const char NewlineCharacter = '\n';
+    char lineSeparator = NewlineCharacter;
+    const char CarriageReturnCharacter = '\r';
+    for (int i = 0; i < 255; ++i) {
+        char inc = infile.get();
+        if (inc == NewlineCharacter)
+            break;
+        if (inc == CarriageReturnCharacter) {
+            if (infile.get() == NewlineCharacter)
+                break;
+            lineSeparator = CarriageReturnCharacter;
+        }
+        if (i > 250) {
+            status = CubeLUT::LineError;
+            break;
+        }
+    }
+    infile.seekg(0);
+    infile.clear();
+
+    int N, CntTitle, CntSize, CntMin, CntMax;
+    N = CntTitle = CntSize = CntMin = CntMax = 0;
+    long linePos = 0;
+    while (status == CubeLUT::OK) {
+        linePos = infile.tellg();
+        std::string lineOfText = ReadLine(infile, lineSeparator);
+        if (status != CubeLUT::OK)
+            break;
+
+        std::istringstream line(lineOfText);
+        std::string keyword;
+        line >> keyword;
+
+        if (("+" < keyword) and (keyword < ":")) { // numbers
+            infile.seekg(linePos);
+            break;
+        }
+        else if ((keyword == "TITLE") and (CntTitle++ == 0)) {
+            const char QUOTE = '"';
+            char startOfTitle;
+            line >> startOfTitle;
+            if (startOfTitle != QUOTE) {
+                status = CubeLUT::TitleMissingQuote;
+                break;
+            }
+            getline(line, title, QUOTE);
+        }
+        else if ((keyword == "DOMAIN_MIN") and (CntMin++ == 0))
+            line >> domainMin[0] >> domainMin[1] >> domainMin[2];
+        else if ((keyword == "DOMAIN_MAX") and (CntMax++ == 0))
+            line >> domainMax[0] >> domainMax[1] >> domainMax[2];
+        else if ((keyword == "LUT_1D_SIZE") and (CntSize++ == 0)) {
+            line >> N;
+            if ((N < 2) or (N > 65536)) {
+                status = CubeLUT::LUTSizeOutOfRange;
+                break;
+            }
+            LUT1D = table1D(N, tableRow(3));
+        }
+        else if ((keyword == "LUT_3D_SIZE") and (CntSize++ == 0)) {
+            line >> N;
+            if ((N < 2) or (N > 256)) {
+                status = CubeLUT::LUTSizeOutOfRange;
+                break;
+            }
+            LUT3D = table3D(N, table2D(N, table1D(N, tableRow(3))));
+        }
+        else if (keyword != "") {
+            status = CubeLUT::UnknownOrRepeatedKeyword;
+            break;
+        }
+
+        if ((line.fail()) and (keyword != "")) {
+            status = CubeLUT::ReadError;
+            break;
+        }
+    }
+
+    if (status == CubeLUT::OK) {
+        if (CntSize == 0)
+            status = CubeLUT::LUTSizeOutOfRange;
+        if ((domainMin[0] >= domainMax[0]) or (domainMin[1] >= domainMax[1]) or (domainMin[2] >= domainMax[2]))
+            status = CubeLUT::DomainBoundsReversed;
+    }
+    if (status != CubeLUT::OK) // see above
+        return status;
+
+    infile.seekg(linePos - 1);
+    while (infile.get() != '\n')
+        infile.seekg(--linePos);
+
+    if (LUT1D.size() > 0) {
+        N = LUT1D.size();
+        for (int i = 0; (i < N) and (status == CubeLUT::OK); ++i)
+            LUT1D[i] = ParseTableRow(ReadLine(infile, lineSeparator));
+    }
+    else {
+        N = LUT3D.size();
+        for (int b = 0; (b < N) and (status == CubeLUT::OK); ++b)
+            for (int g = 0; (g < N) and (status == CubeLUT::OK); ++g)
+                for (int r = 0; (r < N) and (status == CubeLUT::OK); ++r)
+                    LUT3D[r][g][b] = ParseTableRow(ReadLine(infile, lineSeparator));
+    }
+
+    return status;
+}
+
+///////////////////////////////////////////////
+//// Test files
+///////////////////////////////////////////////
+
+struct struct_case { // one .cube file to load
+    std::string name;
+    std::string contents;
+    CubeLUT::LUTState expected; // state of LoadCubeFile
+    CubeLUT::LUTState expectedReference; // state of the v1.0 parser - differs only where v1.0 was wrong
+};
+
+static std::string GeneratedCube(const int &N) // 3D cube with smooth values, 6 decimals like most exporters
+{
+    std::string text = "TITLE \"generated " + std::to_string(N) + "\"\n# comment line\nLUT_3D_SIZE " + std::to_string(N) + "\n";
+    text.reserve(text.size() + size_t(N) * N * N * 27);
+
+    char row[64];
+    for (int b = 0; b < N; b++)
+        for (int g = 0; g < N; g++)
+            for (int r = 0; r < N; r++) {
+                const double R = double(r) / (N - 1);
+                const double G = double(g) / (N - 1);
+                const double B = double(b) / (N - 1);
+                snprintf(row, sizeof(row), "%.6f %.6f %.6f\n", pow(R, 0.9) * 0.8 + B * 0.2, G * G, sqrt(B) * 0.7 + R * 0.3);
+                text += row;
+            }
+
+    return text;
+}
+
+static std::string SmallCube(const int &rows, const bool &finalNewline) // 2^3 cube with only rows lines of data
+{
+    std::string text = "LUT_3D_SIZE 2\n";
+    for (int n = 0; n < rows; n++)
+        text += std::to_string(n % 2) + " " + std::to_string((n / 2) % 2) + " " + std::to_string(n / 4) + "\n";
+    if ((!finalNewline) and (!text.empty()))
+        text.pop_back();
+
+    return text;
+}
+
+static std::vector<struct_case> TestCases()
+{
+    std::vector<struct_case> cases;
+
+    cases.push_back({"3D 65^3", GeneratedCube(65), CubeLUT::OK, CubeLUT::OK});
+    cases.push_back({"3D 129^3", GeneratedCube(129), CubeLUT::OK, CubeLUT::OK});
+    cases.push_back({"3D 2^3", SmallCube(8, true), CubeLUT::OK, CubeLUT::OK});
+    cases.push_back({"3D CRLF", "TITLE \"crlf\"\r\nLUT_3D_SIZE 2\r\n0 0 0\r\n1 0 0\r\n0 1 0\r\n1 1 0\r\n0 0 1\r\n1 0 1\r\n0 1 1\r\n1 1 1\r\n",
+                     CubeLUT::OK, CubeLUT::OK});
+    cases.push_back({"1D with domain", "TITLE \"curve\"\n# comment\nDOMAIN_MIN 0 0 0\nDOMAIN_MAX 1 1 1\nLUT_1D_SIZE 3\n0 0 0\n0.25 0.5 0.75\n1 1 1\n",
+                     CubeLUT::OK, CubeLUT::OK});
+
+    cases.push_back({"LineError", std::string(300, 'x'), CubeLUT::LineError, CubeLUT::LineError});
+    cases.push_back({"CouldNotParseTableData", "LUT_3D_SIZE 2\n0 0 0\n1 0 0\nfoo 1 1\n", CubeLUT::CouldNotParseTableData, CubeLUT::CouldNotParseTableData});
+    cases.push_back({"PrematureEndOfFile", SmallCube(5, false), CubeLUT::PrematureEndOfFile, CubeLUT::CouldNotParseTableData}); // v1.0 : the empty row read at the end of the file overwrites the state
+    cases.push_back({"PrematureEndOfFile, final newline", SmallCube(5, true), CubeLUT::PrematureEndOfFile, CubeLUT::CouldNotParseTableData});
+    cases.push_back({"TitleMissingQuote", "TITLE x\nLUT_3D_SIZE 2\n", CubeLUT::TitleMissingQuote, CubeLUT::TitleMissingQuote});
+    cases.push_back({"UnknownOrRepeatedKeyword", "FOO 3\nLUT_3D_SIZE 2\n", CubeLUT::UnknownOrRepeatedKeyword, CubeLUT::UnknownOrRepeatedKeyword});
+    cases.push_back({"Repeated size", "LUT_3D_SIZE 2\nLUT_3D_SIZE 2\n", CubeLUT::UnknownOrRepeatedKeyword, CubeLUT::UnknownOrRepeatedKeyword});
+    cases.push_back({"LUTSizeOutOfRange", "LUT_3D_SIZE 300\n", CubeLUT::LUTSizeOutOfRange, CubeLUT::LUTSizeOutOfRange});
+    cases.push_back({"DomainBoundsReversed", "DOMAIN_MIN 1 1 1\n" + SmallCube(8, true), CubeLUT::DomainBoundsReversed, CubeLUT::DomainBoundsReversed});
+
+    return cases;
+}
+
+///////////////////////////////////////////////
+//// Comparison
+///////////////////////////////////////////////
+
+static CubeLUT::table Flatten(const ReferenceCubeLUT &reference) // reference tables in the order of the flat tables : red varies fastest, then green, then blue
+{
+    CubeLUT::table flat;
+
+    for (const ReferenceCubeLUT::tableRow &row : reference.LUT1D)
+        flat.insert(flat.end(), row.begin(), row.end());
+
+    const int N = reference.LUT3D.size();
+    for (int b = 0; b < N; b++)
+        for (int g = 0; g < N; g++)
+            for (int r = 0; r < N; r++)
+                flat.insert(flat.end(), reference.LUT3D[r][g][b].begin(), reference.LUT3D[r][g][b].end());
+
+    return flat;
+}
+
+static double MaxDifference(const CubeLUT::table &a, const CubeLUT::table &b) // biggest difference between values - -1 if sizes differ
+{
+    if (a.size() != b.size())
+        return -1;
+
+    double difference = 0;
+    for (size_t n = 0; n < a.size(); n++)
+        difference = std::max(difference, double(std::abs(a[n] - b[n])));
+
+    return difference;
+}
+
+template<class LUT> static double LoadTime(const std::string &filename, LUT &lut, const int &runs) // best time in ms of several loads
+{
+    double best = 0;
+    for (int run = 0; run < runs; run++) {
+        std::ifstream file(filename, std::ios::in | std::ios::binary);
+        const auto start = std::chrono::steady_clock::now();
+        lut.LoadCubeFile(file);
+        const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if ((run == 0) or (elapsed < best))
+            best = elapsed;
+    }
+
+    return best;
+}
+
+///////////////////////////////////////////////
+//// Main
+///////////////////////////////////////////////
+
+int main()
+{
+    const std::filesystem::path folder = std::filesystem::temp_directory_path() / "cube-parser-test"; // generated files
+    std::filesystem::create_directories(folder);
+
+    int errors = 0;
+    for (const struct_case &test : TestCases()) {
+        const std::string filename = (folder / "test.cube").string();
+        {
+            std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+            file << test.contents;
+        }
+
+        const bool big = test.contents.size() > 1000000; // benchmark : best of several loads
+        CubeLUT lut;
+        ReferenceCubeLUT reference;
+        const double time = LoadTime(filename, lut, big ? 5 : 1);
+        const double referenceTime = LoadTime(filename, reference, big ? 2 : 1);
+
+        bool ok = (lut.status == test.expected) and (reference.status == test.expectedReference);
+        double difference = 0;
+        if (ok and (lut.status == CubeLUT::OK)) { // same contents
+            const CubeLUT::table flat = Flatten(reference);
+            difference = MaxDifference(lut.LUT1D.empty() ? lut.LUT3D : lut.LUT1D, flat);
+            ok = (difference >= 0) and (difference <= 1e-6) and (lut.title == reference.title)
+                 and (lut.domainMin == reference.domainMin) and (lut.domainMax == reference.domainMax);
+        }
+
+        std::cout << (ok ? "ok    " : "FAIL  ") << test.name << " : state " << lut.status << " (v1.0 " << reference.status << ")";
+        if (lut.status == CubeLUT::OK)
+            std::cout << ", max difference " << difference;
+        if (big)
+            std::cout << ", " << referenceTime << " ms -> " << time << " ms";
+        std::cout << std::endl;
+
+        if (!ok)
+            errors++;
+    }
+
+    std::filesystem::remove_all(folder);
+
+    return (errors > 0) ? 1 : 0;
+}
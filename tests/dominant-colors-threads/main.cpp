@@ -0,0 +1,215 @@
+/*#-------------------------------------------------
+#
+#    Dominant colors library : concurrency test
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1.1 - 2026/10/18
+#
+#   - the same jobs run serially, then N at once in
+#     parallel threads sharing the same inputs
+#   - every algorithm of the library on a fixed image,
+#     without and with a pixel mask
+#   - color samples algorithms and nearest colors
+#   - all results must be identical to the serial ones
+#   - exit code 0 = success
+#
+#-------------------------------------------------*/
+
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+#include "opencv2/opencv.hpp"
+
+#include "../../lib/dominant-colors.h"
+#include "../../lib/color-spaces.h"
+
+///////////////////////////////////////////////
+//// Jobs
+///////////////////////////////////////////////
+
+struct struct_result { // output of one job
+    std::vector<cv::Mat> images; // quantized, filtered or segmented images
+    std::vector<std::vector<cv::Vec3d>> palettes; // palettes as vectors
+    std::vector<cv::Mat> centers; // palettes as K-means centers
+    std::vector<std::vector<std::vector<int>>> sectors; // Sectored Means palettes
+    std::vector<std::vector<int>> labels; // clusters of color samples
+};
+
+static cv::Mat TestImageBGR() // fixed test image : gradients, checkerboard and deterministic noise
+{
+    cv::Mat image(64, 96, CV_8UC3);
+
+    for (int y = 0; y < image.rows; y++) {
+        cv::Vec3b* imageP = image.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < image.cols; x++)
+            imageP[x] = cv::Vec3b(((x / 16 + y / 16) % 2) * 200 + (x * 7 + y * 13) % 41, // B
+                                  (y * 255) / (image.rows - 1), // G
+                                  (x * 255) / (image.cols - 1)); // R
+    }
+
+    return image;
+}
+
+static cv::Mat ImageBGRtoCIELab(const cv::Mat &image) // 8-bit BGR to CIELab [0..1]
+{
+    cv::Mat lab(image.rows, image.cols, CV_64FC3);
+
+    for (int y = 0; y < image.rows; y++) {
+        const cv::Vec3b* imageP = image.ptr<cv::Vec3b>(y);
+        cv::Vec3d* labP = lab.ptr<cv::Vec3d>(y);
+        for (int x = 0; x < image.cols; x++)
+            RGBtoCIELab(imageP[x][2], imageP[x][1], imageP[x][0], labP[x][0], labP[x][1], labP[x][2]);
+    }
+
+    return lab;
+}
+
+static cv::Mat TestMask(const cv::Mat &image) // fixed 8-bit mask : a disk and a band of pixels are excluded
+{
+    cv::Mat mask(image.rows, image.cols, CV_8UC1, cv::Scalar(255));
+    cv::circle(mask, cv::Point(image.cols / 3, image.rows / 2), image.rows / 4, cv::Scalar(0), -1);
+    mask(cv::Rect(0, 0, image.cols, 4)).setTo(0);
+
+    return mask;
+}
+
+static void LabSamples(const cv::Mat &lab, std::vector<cv::Vec3d> &samples, std::vector<double> &weights) // one pixel out of 3 as a weighted color sample
+{
+    const cv::Vec3d* labP = lab.ptr<cv::Vec3d>(0);
+    for (int n = 0; n < int(lab.total()); n += 3) {
+        samples.push_back(labP[n]);
+        weights.push_back(1 + n % 5);
+    }
+}
+
+static struct_result RunJob(const cv::Mat &image, const cv::Mat &lab, const cv::Mat &mask,
+                            const std::vector<cv::Vec3d> &samples, const std::vector<double> &weights, const MeanShift &meanShift) // one job : only reads the shared inputs and MeanShift object
+{
+    struct_result result;
+    cv::Mat quantized;
+    cv::Mat1f centers;
+
+    cv::theRNG().state = 0x12345678; // K-means draws its first centers from the random generator of its thread
+
+    for (const cv::Mat &jobMask : {cv::Mat(), mask}) { // all pixels, then only included pixels
+        const std::vector<cv::Vec3d> palette = DominantColorsEigen(lab, 12, quantized, jobMask);
+        result.palettes.push_back(palette);
+        result.images.push_back(quantized);
+
+        std::vector<cv::Vec3b> paletteColors(palette.size()); // any distinct colors will do
+        for (int n = 0; n < int(palette.size()); n++)
+            paletteColors[n] = cv::Vec3b(n, 255 - n, 128);
+        result.images.push_back(QuantizeToNearestColors(image, palette, paletteColors, CentersCIELab, jobMask)); // allocates its own 2^24 table
+
+        result.images.push_back(DominantColorsKMeans(lab, 8, centers, jobMask));
+        result.centers.push_back(centers.clone());
+        result.images.push_back(DominantColorsKMeansRGB(image, 8, centers, jobMask));
+        result.centers.push_back(centers.clone());
+
+        std::vector<cv::Vec3d> centersBGR(centers.rows); // nearest K-means center
+        std::vector<cv::Vec3b> centersColors(centers.rows);
+        for (int n = 0; n < centers.rows; n++) {
+            centersBGR[n] = cv::Vec3d(centers(n, 0), centers(n, 1), centers(n, 2));
+            centersColors[n] = cv::Vec3b(cv::saturate_cast<uchar>(centers(n, 0)), cv::saturate_cast<uchar>(centers(n, 1)), cv::saturate_cast<uchar>(centers(n, 2)));
+        }
+        result.images.push_back(QuantizeToNearestColors(image, centersBGR, centersColors, CentersBGR, jobMask));
+
+        result.sectors.push_back(SectoredMeansSegmentation(image, quantized, jobMask));
+        result.images.push_back(quantized);
+
+        cv::Mat filtered = lab.clone();
+        meanShift.MeanShiftFiltering(filtered, jobMask);
+        result.images.push_back(filtered);
+
+        cv::Mat segmented = lab.clone();
+        meanShift.MeanShiftSegmentation(segmented, jobMask);
+        result.images.push_back(segmented);
+    }
+
+    std::vector<int> labels;
+    result.palettes.push_back(DominantColorsEigenSamples(samples, weights, 12, labels));
+    result.labels.push_back(labels);
+    result.palettes.push_back(DominantColorsKMeansSamples(samples, weights, 12, labels));
+    result.labels.push_back(labels);
+
+    return result;
+}
+
+static bool SameMat(const cv::Mat &a, const cv::Mat &b) // same size, type and values
+{
+    if ((a.size() != b.size()) or (a.type() != b.type()))
+        return false;
+    if (a.empty())
+        return true;
+
+    return cv::norm(a, b, cv::NORM_INF) == 0;
+}
+
+static bool SameResult(const struct_result &a, const struct_result &b) // bit-exact comparison of two jobs
+{
+    if ((a.images.size() != b.images.size()) or (a.centers.size() != b.centers.size())
+            or (a.palettes != b.palettes) or (a.sectors != b.sectors) or (a.labels != b.labels))
+        return false;
+
+    for (size_t n = 0; n < a.images.size(); n++)
+        if (!SameMat(a.images[n], b.images[n]))
+            return false;
+    for (size_t n = 0; n < a.centers.size(); n++)
+        if (!SameMat(a.centers[n], b.centers[n]))
+            return false;
+
+    return true;
+}
+
+///////////////////////////////////////////////
+//// Main
+///////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+    const int nbThreads = (argc > 1) ? std::max(1, atoi(argv[1])) : 8; // number of parallel jobs, first argument
+    const int nbRounds = 4; // parallel runs
+
+    const cv::Mat image = TestImageBGR(); // shared by all jobs
+    const cv::Mat lab = ImageBGRtoCIELab(image);
+    const cv::Mat mask = TestMask(image);
+    std::vector<cv::Vec3d> samples;
+    std::vector<double> weights;
+    LabSamples(lab, samples, weights);
+    const MeanShift meanShift(8, 0.1); // shared by all jobs : spatial radius in pixels, color radius in CIELab [0..1]
+
+    std::vector<struct_result> serial(nbThreads); // reference : jobs one after another
+    for (int n = 0; n < nbThreads; n++)
+        serial[n] = RunJob(image, lab, mask, samples, weights, meanShift);
+
+    for (int n = 1; n < nbThreads; n++)
+        if (!SameResult(serial[0], serial[n])) {
+            std::cerr << "Serial runs differ : the library is not deterministic" << std::endl;
+            return 1;
+        }
+
+    int errors = 0;
+    for (int round = 0; round < nbRounds; round++) {
+        std::vector<struct_result> parallel(nbThreads); // jobs all at once
+        std::vector<std::thread> threads;
+        for (int n = 0; n < nbThreads; n++)
+            threads.emplace_back([&, n]() { parallel[n] = RunJob(image, lab, mask, samples, weights, meanShift); });
+        for (std::thread &thread : threads)
+            thread.join();
+
+        for (int n = 0; n < nbThreads; n++)
+            if (!SameResult(serial[0], parallel[n])) {
+                std::cerr << "Round " << round << ", thread " << n << " : result differs from the serial run" << std::endl;
+                errors++;
+            }
+    }
+
+    if (errors > 0)
+        return 1;
+
+    std::cout << nbRounds << " rounds of " << nbThreads << " parallel jobs : same results as serial runs" << std::endl;
+    return 0;
+}
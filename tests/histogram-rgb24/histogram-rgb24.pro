@@ -0,0 +1,34 @@
+#-------------------------------------------------
+#
+#    Image utils : 24-bit RGB histogram benchmark
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   usage : qmake && make && ./histogram-rgb24
+#
+#-------------------------------------------------
+
+QT += core gui
+QT -= widgets
+
+TARGET = histogram-rgb24
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+SOURCES +=  main.cpp \
+            ../../lib/image-utils.cpp
+
+HEADERS  += ../../lib/image-utils.h
+
+# we add the package opencv to pkg-config
+CONFIG += link_pkgconfig
+PKGCONFIG += opencv4
+
+CONFIG += c++17
+
+# openMP
+QMAKE_LFLAGS += -fopenmp
+QMAKE_CXXFLAGS += -fopenmp
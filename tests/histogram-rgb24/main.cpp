@@ -0,0 +1,168 @@
+/*#-------------------------------------------------
+#
+#    Image utils : 24-bit RGB histogram benchmark
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   - flat, gradient and noise images, without and
+#     with a pixel mask
+#   - HistogramImageRGB24 must give the same counts
+#     as a serial loop
+#   - times the serial loop, one atomic increment per
+#     pixel (previous version) and the library
+#   - exit code 0 = success
+#
+#-------------------------------------------------*/
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iostream>
+
+#include "opencv2/opencv.hpp"
+
+#include "../../lib/image-utils.h"
+
+///////////////////////////////////////////////
+//// Test images
+///////////////////////////////////////////////
+
+static cv::Mat FlatImage(const int width, const int height) // large areas of 4 colors : all threads hit the same counters
+{
+    cv::Mat image(height, width, CV_8UC3);
+
+    for (int y = 0; y < height; y++) {
+        cv::Vec3b* imageP = image.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < width; x++)
+            imageP[x] = ((x < width / 2) == (y < height / 2)) ? cv::Vec3b(250, 250, 250)
+                                                                : (x < width / 2) ? cv::Vec3b(40, 120, 200) : cv::Vec3b(0, 0, 0);
+        if (y % 97 == 0) // a few thin lines
+            for (int x = 0; x < width; x++)
+                imageP[x] = cv::Vec3b(0, 255, 0);
+    }
+
+    return image;
+}
+
+static cv::Mat GradientImage(const int width, const int height) // smooth gradients : neighbor pixels share their colors
+{
+    cv::Mat image(height, width, CV_8UC3);
+
+    for (int y = 0; y < height; y++) {
+        cv::Vec3b* imageP = image.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < width; x++)
+            imageP[x] = cv::Vec3b((x + y) * 255 / (width + height), y * 255 / height, x * 255 / width);
+    }
+
+    return image;
+}
+
+static cv::Mat NoiseImage(const int width, const int height) // deterministic noise : millions of different colors
+{
+    cv::Mat image(height, width, CV_8UC3);
+    cv::RNG rng(0x12345678);
+    rng.fill(image, cv::RNG::UNIFORM, 0, 256);
+
+    return image;
+}
+
+static cv::Mat TestMask(const cv::Mat &image) // a disk and a band of pixels are excluded
+{
+    cv::Mat mask(image.rows, image.cols, CV_8UC1, cv::Scalar(255));
+    cv::circle(mask, cv::Point(image.cols / 3, image.rows / 2), image.rows / 4, cv::Scalar(0), -1);
+    mask(cv::Rect(0, 0, image.cols, image.rows / 10)).setTo(0);
+
+    return mask;
+}
+
+///////////////////////////////////////////////
+//// Reference histograms
+///////////////////////////////////////////////
+
+static std::vector<int> HistogramSerial(const cv::Mat &source, const cv::Mat &mask) // one thread, plain increments
+{
+    std::vector<int> histogram(1 << 24, 0);
+
+    for (int y = 0; y < source.rows; y++) {
+        const cv::Vec3b* sourceP = source.ptr<cv::Vec3b>(y);
+        const uchar* maskP = mask.empty() ? nullptr : mask.ptr<uchar>(y);
+        for (int x = 0; x < source.cols; x++)
+            if ((!maskP) or (maskP[x] != 0))
+                histogram[(sourceP[x][2] << 16) | (sourceP[x][1] << 8) | sourceP[x][0]]++;
+    }
+
+    return histogram;
+}
+
+static std::vector<int> HistogramAtomic(const cv::Mat &source, const cv::Mat &mask) // previous library version : one atomic increment per pixel
+{
+    std::vector<int> histogram(1 << 24, 0);
+
+    #pragma omp parallel for
+    for (int y = 0; y < source.rows; y++) {
+        const cv::Vec3b* sourceP = source.ptr<cv::Vec3b>(y);
+        const uchar* maskP = mask.empty() ? nullptr : mask.ptr<uchar>(y);
+        for (int x = 0; x < source.cols; x++) {
+            if ((maskP) and (maskP[x] == 0))
+                continue;
+            #pragma omp atomic
+            histogram[(sourceP[x][2] << 16) | (sourceP[x][1] << 8) | sourceP[x][0]]++;
+        }
+    }
+
+    return histogram;
+}
+
+///////////////////////////////////////////////
+//// Main
+///////////////////////////////////////////////
+
+template <typename Function>
+static double TimeMs(Function function, const int nbRuns, std::vector<int> &histogram) // best time of several runs, in milliseconds
+{
+    double best = 1e30;
+    for (int run = 0; run < nbRuns; run++) {
+        const auto start = std::chrono::steady_clock::now();
+        histogram = function();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    return best;
+}
+
+int main()
+{
+    const int width = 6000; // 24 megapixels
+    const int height = 4000;
+    const int nbRuns = 3;
+
+    const std::vector<std::pair<std::string, cv::Mat>> images = {{"flat", FlatImage(width, height)},
+                                                                 {"gradient", GradientImage(width, height)},
+                                                                 {"noise", NoiseImage(width, height)}};
+
+    int errors = 0;
+    for (const auto &image : images)
+        for (const cv::Mat &mask : {cv::Mat(), TestMask(image.second)}) {
+            std::vector<int> serial, atomic, library;
+            const double serialMs = TimeMs([&]() { return HistogramSerial(image.second, mask); }, nbRuns, serial);
+            const double atomicMs = TimeMs([&]() { return HistogramAtomic(image.second, mask); }, nbRuns, atomic);
+            const double libraryMs = TimeMs([&]() { return HistogramImageRGB24(image.second, mask); }, nbRuns, library);
+
+            const std::string name = image.first + (mask.empty() ? "" : " + mask");
+            std::cout << name << " : serial " << serialMs << " ms, atomic per pixel " << atomicMs
+                      << " ms, library " << libraryMs << " ms" << std::endl;
+
+            if ((atomic != serial) or (library != serial)) {
+                std::cerr << name << " : histogram differs from the serial loop" << std::endl;
+                errors++;
+            }
+        }
+
+    if (errors > 0)
+        return 1;
+
+    std::cout << "All histograms are identical to the serial loop" << std::endl;
+    return 0;
+}
@@ -0,0 +1,204 @@
+/*#-------------------------------------------------
+#
+#    Dominant colors library : pixel masks test
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   - unique RGB colors and their counts with a mask,
+#     against a std::map of the included pixels
+#   - small images (sorted pixels) and big images
+#     (bitset and histogram)
+#   - Eigen and K-means with a mask : scrambling the
+#     excluded pixels must not change the palette
+#   - exit code 0 = success
+#
+#-------------------------------------------------*/
+
+#include <map>
+#include <vector>
+#include <string>
+#include <iostream>
+
+#include "opencv2/opencv.hpp"
+
+#include "../../lib/dominant-colors.h"
+#include "../../lib/color-spaces.h"
+#include "../../lib/image-utils.h"
+
+///////////////////////////////////////////////
+//// Test images
+///////////////////////////////////////////////
+
+static cv::Mat TestImageBGR(const int width, const int height) // gradients and deterministic noise : many colors, most of them on several pixels
+{
+    cv::Mat image(height, width, CV_8UC3);
+    cv::RNG rng(0x12345678);
+
+    for (int y = 0; y < height; y++) {
+        cv::Vec3b* imageP = image.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < width; x++)
+            imageP[x] = cv::Vec3b(rng.uniform(0, 4) * 64, // B
+                                  (y * 255) / (height - 1), // G
+                                  ((x * 255) / (width - 1)) & 0xF0); // R
+    }
+
+    return image;
+}
+
+static cv::Mat ImageBGRtoCIELab(const cv::Mat &image) // 8-bit BGR to CIELab [0..1]
+{
+    cv::Mat lab(image.rows, image.cols, CV_64FC3);
+
+    for (int y = 0; y < image.rows; y++) {
+        const cv::Vec3b* imageP = image.ptr<cv::Vec3b>(y);
+        cv::Vec3d* labP = lab.ptr<cv::Vec3d>(y);
+        for (int x = 0; x < image.cols; x++)
+            RGBtoCIELab(imageP[x][2], imageP[x][1], imageP[x][0], labP[x][0], labP[x][1], labP[x][2]);
+    }
+
+    return lab;
+}
+
+static cv::Mat TestMask(const cv::Mat &image) // a disk and a band of pixels are excluded
+{
+    cv::Mat mask(image.rows, image.cols, CV_8UC1, cv::Scalar(255));
+    cv::circle(mask, cv::Point(image.cols / 3, image.rows / 2), image.rows / 4, cv::Scalar(0), -1);
+    mask(cv::Rect(0, 0, image.cols, image.rows / 8)).setTo(0);
+
+    return mask;
+}
+
+static cv::Mat ScrambleExcluded(const cv::Mat &image, const cv::Mat &mask) // copy of image with random colors on excluded pixels
+{
+    cv::Mat scrambled = image.clone();
+    cv::RNG rng(0x87654321);
+
+    for (int y = 0; y < image.rows; y++) {
+        cv::Vec3b* scrambledP = scrambled.ptr<cv::Vec3b>(y);
+        const uchar* maskP = mask.ptr<uchar>(y);
+        for (int x = 0; x < image.cols; x++)
+            if (maskP[x] == 0)
+                scrambledP[x] = cv::Vec3b(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+    }
+
+    return scrambled;
+}
+
+static bool SameMat(const cv::Mat &a, const cv::Mat &b) // same size, type and values
+{
+    if ((a.size() != b.size()) or (a.type() != b.type()))
+        return false;
+    if (a.empty())
+        return true;
+
+    return cv::norm(a, b, cv::NORM_INF) == 0;
+}
+
+///////////////////////////////////////////////
+//// Tests
+///////////////////////////////////////////////
+
+static int TestUniqueColors(const std::string &name, const cv::Mat &image, const cv::Mat &mask) // unique colors and counts against a std::map
+{
+    std::map<int, int> reference; // 0xRRGGBB -> number of included pixels
+    for (int y = 0; y < image.rows; y++) {
+        const cv::Vec3b* imageP = image.ptr<cv::Vec3b>(y);
+        const uchar* maskP = mask.empty() ? nullptr : mask.ptr<uchar>(y);
+        for (int x = 0; x < image.cols; x++)
+            if ((!maskP) or (maskP[x] != 0))
+                reference[(imageP[x][2] << 16) | (imageP[x][1] << 8) | imageP[x][0]]++;
+    }
+    std::vector<int> referenceColors, referenceCounts;
+    for (const auto &color : reference) {
+        referenceColors.push_back(color.first);
+        referenceCounts.push_back(color.second);
+    }
+
+    int errors = 0;
+    if (CountRGBUniqueValues(image, mask) != int(reference.size())) {
+        std::cerr << name << " : CountRGBUniqueValues differs from the reference" << std::endl;
+        errors++;
+    }
+
+    std::vector<int> colors, counts;
+    UniqueColorsImageRGB24(image, colors, mask);
+    if (colors != referenceColors) {
+        std::cerr << name << " : UniqueColorsImageRGB24 colors differ from the reference" << std::endl;
+        errors++;
+    }
+
+    UniqueColorsImageRGB24(image, colors, counts, mask);
+    if ((colors != referenceColors) or (counts != referenceCounts)) {
+        std::cerr << name << " : UniqueColorsImageRGB24 colors and counts differ from the reference" << std::endl;
+        errors++;
+    }
+
+    std::cout << name << " : " << reference.size() << " colors" << std::endl;
+    return errors;
+}
+
+static int TestExcludedPixels(const std::string &name, const cv::Mat &image, const cv::Mat &mask) // palettes must not depend on excluded pixels
+{
+    const cv::Mat scrambled = ScrambleExcluded(image, mask);
+    const cv::Mat lab = ImageBGRtoCIELab(image);
+    const cv::Mat labScrambled = ImageBGRtoCIELab(scrambled);
+    int errors = 0;
+
+    cv::Mat quantized, quantizedScrambled;
+    const std::vector<cv::Vec3d> palette = DominantColorsEigen(lab, 12, quantized, mask);
+    const std::vector<cv::Vec3d> paletteScrambled = DominantColorsEigen(labScrambled, 12, quantizedScrambled, mask);
+    if ((palette != paletteScrambled) or (!SameMat(quantized, quantizedScrambled))) {
+        std::cerr << name << " : Eigen depends on excluded pixels" << std::endl;
+        errors++;
+    }
+
+    cv::Mat1f centers, centersScrambled;
+    cv::theRNG().state = 0x12345678; // same first K-means centers for both runs
+    quantized = DominantColorsKMeans(lab, 8, centers, mask);
+    cv::theRNG().state = 0x12345678;
+    quantizedScrambled = DominantColorsKMeans(labScrambled, 8, centersScrambled, mask);
+    if ((!SameMat(centers, centersScrambled)) or (!SameMat(quantized, quantizedScrambled))) {
+        std::cerr << name << " : K-means depends on excluded pixels" << std::endl;
+        errors++;
+    }
+
+    cv::theRNG().state = 0x12345678;
+    quantized = DominantColorsKMeansRGB(image, 8, centers, mask);
+    cv::theRNG().state = 0x12345678;
+    quantizedScrambled = DominantColorsKMeansRGB(scrambled, 8, centersScrambled, mask);
+    if ((!SameMat(centers, centersScrambled)) or (!SameMat(quantized, quantizedScrambled))) {
+        std::cerr << name << " : K-means RGB depends on excluded pixels" << std::endl;
+        errors++;
+    }
+
+    return errors;
+}
+
+///////////////////////////////////////////////
+//// Main
+///////////////////////////////////////////////
+
+int main()
+{
+    int errors = 0;
+
+    const cv::Mat small = TestImageBGR(96, 64); // less than 65536 pixels : sorted pixels
+    const cv::Mat big = TestImageBGR(400, 300); // bitset and histogram
+    for (const auto &image : {std::make_pair(std::string("small"), small), std::make_pair(std::string("big"), big)}) {
+        const cv::Mat mask = TestMask(image.second);
+        errors += TestUniqueColors(image.first, image.second, cv::Mat());
+        errors += TestUniqueColors(image.first + " + mask", image.second, mask);
+        errors += TestUniqueColors(image.first + " + mask excluding all", image.second, cv::Mat::zeros(image.second.size(), CV_8UC1)); // no pixel included
+        errors += TestUniqueColors(image.first + " + mask, scrambled", ScrambleExcluded(image.second, mask), mask);
+    }
+
+    errors += TestExcludedPixels("small", small, TestMask(small));
+
+    if (errors > 0)
+        return 1;
+
+    std::cout << "All masked results are identical to the references" << std::endl;
+    return 0;
+}
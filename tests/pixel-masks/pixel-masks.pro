@@ -0,0 +1,40 @@
+#-------------------------------------------------
+#
+#    Dominant colors library : pixel masks test
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   usage : qmake && make && ./pixel-masks
+#
+#-------------------------------------------------
+
+QT += core gui
+QT -= widgets
+
+TARGET = pixel-masks
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+SOURCES +=  main.cpp \
+            ../../lib/dominant-colors.cpp \
+            ../../lib/color-spaces.cpp \
+            ../../lib/angles.cpp \
+            ../../lib/image-utils.cpp
+
+HEADERS  += ../../lib/dominant-colors.h \
+            ../../lib/color-spaces.h \
+            ../../lib/angles.h \
+            ../../lib/image-utils.h
+
+# we add the package opencv to pkg-config
+CONFIG += link_pkgconfig
+PKGCONFIG += opencv4
+
+CONFIG += c++17
+
+# openMP
+QMAKE_LFLAGS += -fopenmp
+QMAKE_CXXFLAGS += -fopenmp
@@ -0,0 +1,153 @@
+/*#-------------------------------------------------
+#
+#    Dominant colors library : nearest colors test
+#
+#    by AbsurdePhoton - www.absurdephoton.fr
+#
+#                v1 - 2026/10/18
+#
+#   - QuantizeToNearestColors against a brute-force
+#     nearest center loop on every pixel
+#   - CIELab and BGR centers, without and with a
+#     pixel mask (excluded pixels must stay black)
+#   - small images (sorted pixels) and big images
+#     (bitset)
+#   - exit code 0 = success
+#
+#-------------------------------------------------*/
+
+#include <limits>
+#include <vector>
+#include <string>
+#include <iostream>
+
+#include "opencv2/opencv.hpp"
+
+#include "../../lib/dominant-colors.h"
+#include "../../lib/color-spaces.h"
+
+///////////////////////////////////////////////
+//// Test data
+///////////////////////////////////////////////
+
+static cv::Mat TestImageBGR(const int width, const int height) // gradients and deterministic noise
+{
+    cv::Mat image(height, width, CV_8UC3);
+    cv::RNG rng(0x12345678);
+
+    for (int y = 0; y < height; y++) {
+        cv::Vec3b* imageP = image.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < width; x++)
+            imageP[x] = cv::Vec3b(rng.uniform(0, 256), // B
+                                  (y * 255) / (height - 1), // G
+                                  (x * 255) / (width - 1)); // R
+    }
+
+    return image;
+}
+
+static cv::Mat TestMask(const cv::Mat &image) // a disk and a band of pixels are excluded
+{
+    cv::Mat mask(image.rows, image.cols, CV_8UC1, cv::Scalar(255));
+    cv::circle(mask, cv::Point(image.cols / 3, image.rows / 2), image.rows / 4, cv::Scalar(0), -1);
+    mask(cv::Rect(0, 0, image.cols, image.rows / 8)).setTo(0);
+
+    return mask;
+}
+
+static std::vector<cv::Vec3d> TestCenters(const CentersSpace &space, const int &nbCenters) // random centers, the last one repeats the first one to test ties
+{
+    std::vector<cv::Vec3d> centers;
+    cv::RNG rng(0x2468ACE);
+    const double maxValue = (space == CentersCIELab) ? 1.0 : 255.0;
+
+    for (int n = 0; n < nbCenters; n++)
+        centers.push_back(cv::Vec3d(rng.uniform(0.0, maxValue), rng.uniform(0.0, maxValue), rng.uniform(0.0, maxValue)));
+    if (nbCenters > 1)
+        centers.back() = centers.front();
+
+    return centers;
+}
+
+///////////////////////////////////////////////
+//// Reference
+///////////////////////////////////////////////
+
+static cv::Mat BruteForceNearestColors(const cv::Mat &image, const std::vector<cv::Vec3d> &centers, const std::vector<cv::Vec3b> &colors,
+                                       const CentersSpace &space, const cv::Mat &mask) // nearest center of each pixel, first one on ties - excluded pixels are black
+{
+    cv::Mat quantized = cv::Mat::zeros(image.rows, image.cols, CV_8UC3);
+
+    for (int y = 0; y < image.rows; y++) {
+        const cv::Vec3b* imageP = image.ptr<cv::Vec3b>(y);
+        const uchar* maskP = mask.empty() ? nullptr : mask.ptr<uchar>(y);
+        cv::Vec3b* quantizedP = quantized.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < image.cols; x++) {
+            if (((maskP) and (maskP[x] == 0)) or (centers.empty()))
+                continue;
+
+            const int R = imageP[x][2];
+            const int G = imageP[x][1];
+            const int B = imageP[x][0];
+            cv::Vec3d color;
+            if (space == CentersCIELab)
+                RGBtoCIELab(R, G, B, color[0], color[1], color[2]);
+            else
+                color = cv::Vec3d(B, G, R);
+
+            int nearest = 0;
+            double nearestDistance = std::numeric_limits<double>::max();
+            for (int c = 0; c < int(centers.size()); c++) {
+                const cv::Vec3d delta = color - centers[c];
+                const double distance = delta[0] * delta[0] + delta[1] * delta[1] + delta[2] * delta[2]; // squared euclidean distance
+                if (distance < nearestDistance) {
+                    nearestDistance = distance;
+                    nearest = c;
+                }
+            }
+            quantizedP[x] = colors[nearest];
+        }
+    }
+
+    return quantized;
+}
+
+///////////////////////////////////////////////
+//// Main
+///////////////////////////////////////////////
+
+int main()
+{
+    int errors = 0;
+
+    const cv::Mat small = TestImageBGR(96, 64); // less than 65536 pixels : sorted pixels
+    const cv::Mat big = TestImageBGR(400, 300); // bitset
+    for (const auto &image : {std::make_pair(std::string("small"), small), std::make_pair(std::string("big"), big)})
+        for (const CentersSpace space : {CentersCIELab, CentersBGR})
+            for (const int nbCenters : {0, 1, 12})
+                for (const cv::Mat &mask : {cv::Mat(), TestMask(image.second)}) {
+                    const std::vector<cv::Vec3d> centers = TestCenters(space, nbCenters);
+                    std::vector<cv::Vec3b> colors(centers.size()); // distinct colors : a wrong center shows
+                    for (int n = 0; n < int(colors.size()); n++)
+                        colors[n] = cv::Vec3b(n + 1, 255 - n, 128);
+
+                    const cv::Mat quantized = QuantizeToNearestColors(image.second, centers, colors, space, mask);
+                    const cv::Mat reference = BruteForceNearestColors(image.second, centers, colors, space, mask);
+
+                    const std::string name = image.first + ((space == CentersCIELab) ? " CIELab" : " BGR") + ", "
+                                           + std::to_string(nbCenters) + " centers" + (mask.empty() ? "" : " + mask");
+                    if ((quantized.size() != reference.size()) or (quantized.type() != reference.type())
+                            or (cv::norm(quantized, reference, cv::NORM_INF) != 0)) {
+                        std::cerr << name << " : result differs from the brute-force loop" << std::endl;
+                        errors++;
+                    }
+                    else
+                        std::cout << name << " : ok" << std::endl;
+                }
+
+    if (errors > 0)
+        return 1;
+
+    std::cout << "All results are identical to the brute-force loop" << std::endl;
+    return 0;
+}